@@ -0,0 +1,48 @@
+#include <math.h>
+#include "analysis.h"
+
+void analysis_to_double(const int32_t* in, double* out, uint32_t n, double full_scale) {
+  for (uint32_t i = 0; i < n; i++) out[i] = (double)in[i] / full_scale;
+}
+
+// 3x3 线性方程组（高斯消元，部分主元）
+static void solve3(double m[3][4], double r[3]) {
+  for (int c = 0; c < 3; c++) {
+    int piv = c;
+    for (int k = c + 1; k < 3; k++) if (fabs(m[k][c]) > fabs(m[piv][c])) piv = k;
+    for (int j = 0; j < 4; j++) { double t = m[c][j]; m[c][j] = m[piv][j]; m[piv][j] = t; }
+    for (int k = c + 1; k < 3; k++) {
+      double f = m[k][c] / m[c][c];
+      for (int j = c; j < 4; j++) m[k][j] -= f * m[c][j];
+    }
+  }
+  for (int c = 2; c >= 0; c--) {
+    double s = m[c][3];
+    for (int j = c + 1; j < 3; j++) s -= m[c][j] * r[j];
+    r[c] = s / m[c][c];
+  }
+}
+
+double analysis_thdn_db(const double* x, uint32_t n, double freq_hz, double fs) {
+  double w = 2.0 * M_PI * freq_hz / fs;
+  double m[3][4] = {{0}};
+  for (uint32_t i = 0; i < n; i++) {
+    double b[3] = { sin(w * i), cos(w * i), 1.0 };
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) m[r][c] += b[r] * b[c];
+      m[r][3] += b[r] * x[i];
+    }
+  }
+  double k[3];
+  solve3(m, k);
+
+  double sig = 0.0, err = 0.0;
+  for (uint32_t i = 0; i < n; i++) {
+    double f = k[0] * sin(w * i) + k[1] * cos(w * i);
+    double e = x[i] - f - k[2];
+    sig += f * f;
+    err += e * e;
+  }
+  if (err <= 0.0) return -300.0;
+  return 10.0 * log10(err / sig);
+}
@@ -0,0 +1,12 @@
+#ifndef __ANALYSIS_H__
+#define __ANALYSIS_H__
+#include <stdint.h>
+
+// 已知频率的三参数正弦拟合（a*sin + b*cos + dc），返回 THD+N（dB，残差/基波功率）。
+// freq_hz 应传入被测信号的实际频率（DDS 频率是量化过的）。
+double analysis_thdn_db(const double* x, uint32_t n, double freq_hz, double fs);
+
+// 把整数样本按满幅归一化成 double（full_scale = 2^(bits-1)）
+void analysis_to_double(const int32_t* in, double* out, uint32_t n, double full_scale);
+
+#endif
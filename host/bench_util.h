@@ -0,0 +1,59 @@
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+#include <stdint.h>
+
+#if PICO_ON_DEVICE
+// RP2040 上（uac2_bench 的固件构建）：core0 SysTick 计周期，24 位向下计数器在软件里扩成 64 位，
+// 所以两次调用间隔不能超过 2^24 周期（125 MHz 下约 134 ms）；ns 由周期数按 SYS_CLK_KHZ 换算
+#include "pico/stdlib.h"
+#include "hardware/structs/systick.h"
+
+static inline void bench_init(void) {
+  systick_hw->csr = 0;
+  systick_hw->rvr = 0x00FFFFFFu;
+  systick_hw->cvr = 0;
+  systick_hw->csr = 0x5;   // CLKSOURCE = 处理器时钟 | ENABLE
+}
+
+static inline uint64_t bench_cycles(void) {
+  static uint64_t acc;
+  static uint32_t last;
+  uint32_t now = systick_hw->cvr;
+  acc += (last - now) & 0x00FFFFFFu;
+  last = now;
+  return acc;
+}
+
+static inline uint64_t bench_now_ns(void) {
+  return bench_cycles() * 1000000u / SYS_CLK_KHZ;
+}
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static inline void bench_init(void) {}
+
+// 主机侧计时：单调时钟 ns + CPU 周期计数（x86 用 TSC，其他架构退化为 ns）
+static inline uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return bench_now_ns();
+#endif
+}
+#endif
+
+// 防止编译器把基准循环的结果优化掉
+static inline void bench_sink(const void* p) {
+  __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+
+#endif
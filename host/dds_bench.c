@@ -0,0 +1,98 @@
+// DDS 振荡器基准：对比原 ISR 的 sinf()/lrintf() 浮点路径与 DDS 两个档位。
+// 输出每种组合的 THD+N（dB）与每样本周期/纳秒。
+// 注意：主机有 FPU，浮点路径在 RP2040（M0+，软浮点）上的差距会大得多。
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dds.h"
+#include "analysis.h"
+#include "bench_util.h"
+
+#define TONE_HZ   440
+#define AMP       0.5f
+#define BLOCK     97          // 1 ms @ 96 kHz 上限
+#define REPEAT    20000
+
+// ---- 原 tud_audio_tx_done_isr 的浮点实现（逐样本 sinf + 浮点相位回绕）----
+typedef struct { float phase, step; } float_osc_t;
+
+static void float_render(float_osc_t* o, int32_t* dst, uint32_t n, int bits) {
+  float full = (bits == 16) ? 32767.0f : 8388607.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    float s = sinf(o->phase) * AMP;
+    o->phase += o->step; if (o->phase > 2.0f*(float)M_PI) o->phase -= 2.0f*(float)M_PI;
+    dst[i] = (int32_t)lrintf(s * full);
+  }
+}
+
+// ---- 新路径：DDS Q31 → Q15 增益 → 截位（与 ISR 一致）----
+static void dds_path_render(dds_t* o, int32_t* blk, int32_t* dst, uint32_t n, int bits) {
+  int32_t amp_q15 = (int32_t)lrintf(AMP * 32768.0f);
+  dds_render_q31(o, blk, n);
+  int sh = 32 - bits;
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t v = (int32_t)(((int64_t)blk[i] * amp_q15) >> 15);
+    dst[i] = v >> sh;
+  }
+}
+
+typedef enum { PATH_FLOAT, PATH_DDS_FAST, PATH_DDS_INTERP } path_t;
+static const char* path_name[] = { "float sinf", "dds fast", "dds interp" };
+
+static void run_case(path_t path, uint32_t fs, int bits) {
+  uint32_t n = fs;                       // 1 秒
+  int32_t* pcm = malloc(sizeof(int32_t) * n);
+  double*  x   = malloc(sizeof(double) * n);
+  int32_t  blk[BLOCK];
+  double   freq;
+
+  float_osc_t fo = { 0.0f, 2.0f * (float)M_PI * TONE_HZ / (float)fs };
+  dds_t d;
+  dds_init(&d, path == PATH_DDS_FAST ? DDS_QUALITY_FAST : DDS_QUALITY_INTERP);
+  dds_set_freq(&d, TONE_HZ, fs);
+
+  if (path == PATH_FLOAT) {
+    float_render(&fo, pcm, n, bits);
+    freq = (double)fo.step * fs / (2.0 * M_PI);
+  } else {
+    for (uint32_t i = 0; i < n; i += BLOCK) {
+      uint32_t k = (n - i < BLOCK) ? n - i : BLOCK;
+      dds_path_render(&d, blk, pcm + i, k, bits);
+    }
+    freq = (double)d.step * fs / 4294967296.0;
+  }
+  analysis_to_double(pcm, x, n, (double)(1u << (bits - 1)));
+  double thdn = analysis_thdn_db(x, n, freq, fs);
+
+  // 计时：按 1 ms 一帧反复生成
+  uint32_t per_ms = fs / 1000;
+  int32_t  out[BLOCK];
+  uint64_t best_cyc = UINT64_MAX, best_ns = UINT64_MAX;
+  for (int rep = 0; rep < 5; rep++) {
+    uint64_t c0 = bench_cycles(), t0 = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+      if (path == PATH_FLOAT) float_render(&fo, out, per_ms, bits);
+      else                    dds_path_render(&d, blk, out, per_ms, bits);
+      bench_sink(out);
+    }
+    uint64_t c = bench_cycles() - c0, t = bench_now_ns() - t0;
+    if (c < best_cyc) best_cyc = c;
+    if (t < best_ns)  best_ns = t;
+  }
+  double samples = (double)REPEAT * per_ms;
+  printf("%-11s %6u Hz %2d-bit  THD+N %8.2f dB   %6.2f cyc/sample  %6.2f ns/sample\n",
+         path_name[path], fs, bits, thdn, best_cyc / samples, best_ns / samples);
+  free(pcm);
+  free(x);
+}
+
+int main(void) {
+  dds_table_init();
+  static const uint32_t rates[] = { 44100, 96000 };
+  static const int depths[] = { 16, 24 };
+  for (unsigned r = 0; r < sizeof(rates)/sizeof(rates[0]); r++)
+    for (unsigned b = 0; b < sizeof(depths)/sizeof(depths[0]); b++)
+      for (int p = PATH_FLOAT; p <= PATH_DDS_INTERP; p++)
+        run_case((path_t)p, rates[r], depths[b]);
+  return 0;
+}
@@ -0,0 +1,45 @@
+// 事件日志解码：把固件 CFG_MIC_EVLOG_TEXT=0 时输出的 "@EV" 十六进制记录还原成可读文本，
+// 与设备上 CFG_MIC_EVLOG_TEXT=1 的格式相同（共用 src/evlog_fmt.c）。其它行（printf 输出）原样透传。
+//
+//   evlog_decode [-r] [file]      省略 file 则读 stdin（例如 picocom/minicom 的抓包）
+//     -r   时间戳改为相对第一条事件，并附上与前一条事件的间隔
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "evlog.h"
+
+int main(int argc, char** argv) {
+  int  relative = 0, opt;
+  while ((opt = getopt(argc, argv, "rh")) != -1) {
+    switch (opt) {
+      case 'r': relative = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-r] [capture.log]\n", argv[0]);
+        return 2;
+    }
+  }
+  FILE* in = stdin;
+  if (optind < argc && !(in = fopen(argv[optind], "r"))) { perror(argv[optind]); return 1; }
+
+  char     line[256], text[128];
+  uint32_t t0 = 0, prev = 0, nev = 0, nbad = 0, ndrop = 0;
+  while (fgets(line, sizeof(line), in)) {
+    unsigned core, id, a0;
+    unsigned long t, a1, a2;
+    if (strncmp(line, "@EV ", 4) != 0) { fputs(line, stdout); continue; }
+    if (sscanf(line + 4, "%u %lx %x %x %lx %lx", &core, &t, &id, &a0, &a1, &a2) != 6) { nbad++; continue; }
+
+    evlog_rec_t r = { (uint32_t)t, (uint16_t)id, (uint16_t)a0, (uint32_t)a1, (uint32_t)a2 };
+    evlog_format(&r, text, sizeof(text));
+    if (r.id == EV_DROPPED) ndrop += r.a1;
+    if (nev++ == 0) t0 = prev = r.t_us;
+    uint32_t ts = relative ? r.t_us - t0 : r.t_us;              // 32-bit 回绕差
+    printf("[%6lu.%03lu] c%u ", (unsigned long)(ts / 1000u), (unsigned long)(ts % 1000u), core);
+    if (relative) printf("+%-7lu ", (unsigned long)(r.t_us - prev));
+    printf("%s\n", text);
+    prev = r.t_us;
+  }
+  if (in != stdin) fclose(in);
+  fprintf(stderr, "evlog_decode: %u events, %u dropped on device, %u malformed lines\n", nev, ndrop, nbad);
+  return 0;
+}
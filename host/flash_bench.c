@@ -0,0 +1,125 @@
+// flash 录音源基准：用 mmap 映射与固件烧进 flash 相同的镜像文件（flash_image_sim.c），
+// 测 flash_src 解码（整字突发拷贝 + 转 Q31）+ 各线上格式打包的每 1 ms 帧开销与读取吞吐，
+// 并逐样本校验三轮循环（含跨越结尾的块）与直接按索引解码的参考值一致，即循环接缝无缝。
+//
+//   flash_bench [image.wav ...]    省略参数时在 /tmp 生成 16/24/32-bit、float32 的 1/2 声道扫频 WAV
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "flash_src.h"
+#include "flash_image.h"
+#include "tusb_sim.h"
+#include "bench_util.h"
+
+#define OUT_CH      2
+#define CHUNK       32           // 与 audio_engine.c 的 PRODUCE_CHUNK 一致
+#define GEN_FS      48000
+#define GEN_FRAMES  65749        // 故意不是 CHUNK 的整数倍：循环接缝落在块中间
+#define BENCH_MS    20000
+
+static const char* fmt_name[PCM_FMT_COUNT] = { "-", "s16", "s24", "s32", "f32" };
+
+static void put_le(FILE* f, uint32_t v, int n) {
+  for (int i = 0; i < n; i++) fputc((int)((v >> (8 * i)) & 0xFF), f);
+}
+
+// 20 Hz → 20 kHz 对数扫频，各声道相位错开
+static bool write_sweep(const char* path, pcm_fmt_t fmt, uint16_t ch) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  uint32_t bps = pcm_fmt_table[fmt].bytes, data = GEN_FRAMES * ch * bps;
+  fputs("RIFF", f); put_le(f, 36 + data, 4); fputs("WAVEfmt ", f);
+  put_le(f, 16, 4); put_le(f, fmt == PCM_FMT_F32 ? 3 : 1, 2); put_le(f, ch, 2);
+  put_le(f, GEN_FS, 4); put_le(f, GEN_FS * ch * bps, 4); put_le(f, ch * bps, 2); put_le(f, bps * 8, 2);
+  fputs("data", f); put_le(f, data, 4);
+  double k = log(1000.0) / GEN_FRAMES, ph = 0;
+  for (uint32_t i = 0; i < GEN_FRAMES; i++) {
+    ph += 2 * M_PI * 20.0 * exp(k * i) / GEN_FS;
+    for (uint16_t c = 0; c < ch; c++) {
+      double v = 0.8 * sin(ph + c * 1.3);
+      if (fmt == PCM_FMT_F32) { float x = (float)v; uint32_t b; memcpy(&b, &x, 4); put_le(f, b, 4); }
+      else put_le(f, (uint32_t)(int32_t)lrint(v * (double)(1u << (bps * 8 - 1))), (int)bps);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// 参考：按帧索引直接从映射窗口解码一个样本（浮点路径），与 flash_src 的整数转换比较
+static int32_t ref_sample(const flash_src_t* s, uint32_t frame, uint32_t c) {
+  const uint8_t* p = s->data + ((size_t)frame * s->channels + c % s->channels) * s->bytes;
+  uint32_t u = 0;
+  for (uint32_t b = 0; b < s->bytes; b++) u |= (uint32_t)p[b] << (8 * b);
+  if (s->fmt == PCM_FMT_F32) {
+    float x; memcpy(&x, &u, 4);
+    double v = (double)x * 2147483648.0;
+    if (v >= 2147483647.0) return INT32_MAX;
+    if (v <= -2147483648.0) return INT32_MIN;
+    return (int32_t)v;                                          // 向零截断，与整数转换一致
+  }
+  return (int32_t)(u << (32 - 8 * s->bytes));
+}
+
+static int run_image(const char* path) {
+  uint32_t len;
+  if (!sim_flash_image_load(path)) { fprintf(stderr, "cannot map %s\n", path); return 1; }
+  const uint8_t* img = flash_image_map(&len);
+  flash_src_t s;
+  if (!flash_src_open(&s, img, len)) { fprintf(stderr, "%s: not a supported WAV image\n", path); return 1; }
+  printf("%s: %s x%u, %u Hz, %u frames (%.2f s)\n", path, fmt_name[s.fmt], s.channels, s.fs, s.frames,
+         (double)s.frames / s.fs);
+
+  // ---- 正确性：三轮循环，逐样本对照 ----
+  static int32_t blk[OUT_CH][CHUNK];
+  int32_t* planar[OUT_CH];
+  for (uint32_t c = 0; c < OUT_CH; c++) planar[c] = blk[c];
+  uint32_t total = 3 * s.frames + CHUNK, bad = 0, idx = 0;
+  for (uint32_t done = 0; done < total; done += CHUNK) {
+    flash_src_render_q31(&s, planar, OUT_CH, CHUNK);
+    for (uint32_t i = 0; i < CHUNK; i++, idx++)
+      for (uint32_t c = 0; c < OUT_CH; c++)
+        if (blk[c][i] != ref_sample(&s, idx % s.frames, c)) bad++;
+  }
+  printf("  loop check: %u frames over %u loops, %u mismatching samples%s\n", idx, s.loops, bad,
+         bad ? "  <-- FAIL" : "");
+
+  // ---- 吞吐：解码 + 打包，按 1 ms 帧计时 ----
+  uint32_t per_ms = (s.fs + 999) / 1000;
+  uint32_t chunks = (per_ms + CHUNK - 1) / CHUNK;
+  static uint32_t out[CHUNK * OUT_CH];
+  for (int f = PCM_FMT_S16; f < PCM_FMT_COUNT; f++) {
+    pcm_pack_fn pack = pcm_fmt_table[f].pack;
+    const int32_t* pl[OUT_CH];
+    for (uint32_t c = 0; c < OUT_CH; c++) pl[c] = blk[c];
+    uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+    for (uint32_t ms = 0; ms < BENCH_MS; ms++)
+      for (uint32_t k = 0; k < chunks; k++) {
+        flash_src_render_q31(&s, planar, OUT_CH, CHUNK);
+        pack(pl, OUT_CH, CHUNK, out);
+        bench_sink(out);
+      }
+    uint64_t ns = bench_now_ns() - t0, cyc = bench_cycles() - c0;
+    double frames = (double)BENCH_MS * chunks * CHUNK;
+    printf("  -> %s x%u: %6.0f ns / 1 ms frame, %5.1f cycles/frame, flash read %.0f MB/s\n",
+           fmt_name[f], OUT_CH, (double)ns / BENCH_MS, (double)cyc / frames,
+           frames * s.channels * s.bytes / ((double)ns / 1e9) / 1e6);
+  }
+  return bad ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) rc |= run_image(argv[i]);
+    return rc;
+  }
+  static const pcm_fmt_t fmts[] = { PCM_FMT_S16, PCM_FMT_S24, PCM_FMT_S32, PCM_FMT_F32 };
+  for (uint32_t i = 0; i < sizeof(fmts) / sizeof(fmts[0]); i++)
+    for (uint16_t ch = 1; ch <= 2; ch++) {
+      char path[64];
+      snprintf(path, sizeof(path), "/tmp/flash_bench_%s_%uch.wav", fmt_name[fmts[i]], ch);
+      if (!write_sweep(path, fmts[i], ch)) { perror(path); return 1; }
+      rc |= run_image(path);
+    }
+  return rc;
+}
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+# 端到端延迟探针分析（固件 src/latprobe.c）：
+#   latprobe.py set 10                          经厂商请求 VENDOR_REQ_LATPROBE_SET 打开探针（每 10 ms 一个标记，0 = 关；需要 pyusb）
+#   latprobe.py analyze cap.wav device.log      主机录下的 WAV + 设备输出的 "@LP" 行（UART 抓包 / uac2_sim 输出）
+#       [--csv frames.csv [--seg N]]            uac2_sim -c 的逐帧 CSV：得到每个样本到达主机的 SOF 帧，给出绝对延迟
+#       [--period-ms P]                         模拟主机应用按 P ms 的周期取数（ALSA period / WASAPI buffer）
+#       [-o markers.csv]                        逐标记结果
+# 标记 = 相邻两个采样帧：同步样本 0x7FFF、序号 0..0x7FFE 循环（都在样本最高 16 位，第 0 通道）。
+# 给出三段延迟的分布与抖动（标准差、p99 − p1）：
+#   生成→FIFO  core1 生成标记 → ISR 把它写进 EP FIFO（设备时钟，环的预生成深度）；
+#   FIFO→主机  写进 FIFO → 含它的包在总线上完成（仅 --csv：仿真里设备时钟就是 SOF 帧时间）；
+#   端到端     生成 → 主机应用看到（--csv），否则只有相对值：录音样本时间 i/fs 与设备生成时间之差减去最小值，
+#              外加两条时间轴的相对漂移（异步模式下设备按 SOF 产样，正常应接近 0 ppm）。
+import argparse
+import csv
+import math
+import os
+import re
+import struct
+import sys
+
+VID, PID = 0xCAFE, 0x4002
+VENDOR_REQ_LATPROBE_SET = 0x05
+LATPROBE_SYNC = 0x7FFF
+LP_RE = re.compile(r"@LP (\d+) (\d+) (\d+) (\d+)")
+
+
+def set_period(ms):
+    try:
+        import usb.core
+    except ImportError:
+        sys.exit("pyusb not installed: pip install pyusb")
+    dev = usb.core.find(idVendor=VID, idProduct=PID)
+    if dev is None:
+        sys.exit("device %04x:%04x not found" % (VID, PID))
+    dev.ctrl_transfer(0x40, VENDOR_REQ_LATPROBE_SET, ms, 0, None)
+    print("latency probe: %s" % ("marker every %d ms" % ms if ms else "off"))
+
+
+def read_wav(path):
+    # 只认 PCM（1）/ IEEE float（3）/ EXTENSIBLE（0xFFFE，子格式取前两字节）；Python 的 wave 模块不收 float
+    with open(path, "rb") as f:
+        blob = f.read()
+    if blob[:4] != b"RIFF" or blob[8:12] != b"WAVE":
+        sys.exit("%s: not a RIFF/WAVE file" % path)
+    off, fmt, data = 12, None, None
+    while off + 8 <= len(blob):
+        cid, size = blob[off:off + 4], struct.unpack_from("<I", blob, off + 4)[0]
+        body = blob[off + 8:off + 8 + size]
+        if cid == b"fmt ":
+            tag, ch, rate, _, align, bits = struct.unpack_from("<HHIIHH", body)
+            if tag == 0xFFFE and len(body) >= 26:
+                tag = struct.unpack_from("<H", body, 24)[0]
+            fmt = dict(tag=tag, ch=ch, rate=rate, align=align, bps=align // ch, bits=bits)
+        elif cid == b"data":
+            data = body
+        off += 8 + size + (size & 1)
+    if not fmt or data is None:
+        sys.exit("%s: missing fmt or data chunk" % path)
+    return fmt, data
+
+
+def find_markers(fmt, data):
+    # 第 0 通道每个样本的最高 16 位；同步样本按线上格式直接在字节里找，再按帧对齐过滤
+    bps, align = fmt["bps"], fmt["align"]
+    if fmt["tag"] == 3:
+        sync = struct.pack("<f", (LATPROBE_SYNC << 16) / 2147483648.0)
+        top = lambda i: int(round(struct.unpack_from("<f", data, i * align)[0] * 32768.0))
+        skew = 0
+    else:
+        sync = struct.pack("<h", LATPROBE_SYNC)
+        top = lambda i: struct.unpack_from("<h", data, i * align + bps - 2)[0]
+        skew = bps - 2
+    nframes = len(data) // align
+    out, pos = [], data.find(sync)
+    while pos >= 0:
+        start = pos - skew
+        if start % align == 0:
+            i = start // align
+            if i + 1 < nframes and top(i) == LATPROBE_SYNC:
+                out.append((i, top(i + 1) & 0xFFFF))
+                pos = data.find(sync, (i + 2) * align)
+                continue
+        pos = data.find(sync, pos + 1)
+    return out
+
+
+def unwrap(seq, m):
+    # 按 m 回绕的计数 → 单调值（相邻两项的真实差小于半个量程）
+    half, base, prev, out = m // 2, 0, None, []
+    for v in seq:
+        if prev is not None:
+            d = (v - prev) % m
+            base += d - m if d >= half else d
+        else:
+            base = v
+        prev = v
+        out.append(base)
+    return out
+
+
+def read_log(path):
+    recs = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = LP_RE.search(line)
+            if m:
+                recs.append(tuple(int(x) for x in m.groups()))
+    if not recs:
+        sys.exit("%s: no @LP lines (is the probe enabled?)" % path)
+    ids = unwrap([r[0] for r in recs], LATPROBE_SYNC)
+    gen = unwrap([r[1] for r in recs], 1 << 32)
+    fifo = unwrap([r[3] for r in recs], 1 << 32)
+    return {i: dict(t_gen=g, sof=r[2], t_fifo=t) for i, g, t, r in zip(ids, gen, fifo, recs)}
+
+
+def read_csv_segment(path, seg, align):
+    # uac2_sim -c：同一段（= 同一个 WAV）的各帧按顺序累计样本数 → 每个样本在哪一帧到达主机
+    frames, ends, total = [], [], 0
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            if int(row["seg"]) != seg:
+                continue
+            total += int(row["pkt_bytes"]) // align
+            frames.append(int(row["frame"]))
+            ends.append(total)
+    if not frames:
+        sys.exit("%s: no rows for segment %d" % (path, seg))
+    return frames, ends
+
+
+def arrival_frame(frames, ends, i):
+    lo, hi = 0, len(ends)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if ends[mid] > i:
+            hi = mid
+        else:
+            lo = mid + 1
+    return frames[lo] if lo < len(frames) else None
+
+
+def stats(name, v):
+    if not v:
+        print("%-22s no samples" % name)
+        return
+    s = sorted(v)
+    n = len(s)
+    pct = lambda p: s[min(n - 1, int(p * (n - 1) + 0.5))]
+    avg = sum(s) / n
+    sd = math.sqrt(sum((x - avg) ** 2 for x in s) / n)
+    print("%-22s n %5d  min %8.0f  avg %8.1f  p50 %8.0f  p99 %8.0f  max %8.0f  jitter sd %6.1f  p99-p1 %6.0f  [us]"
+          % (name, n, s[0], avg, pct(0.5), pct(0.99), s[-1], sd, pct(0.99) - pct(0.01)))
+
+
+def analyze(a):
+    fmt, data = read_wav(a.wav)
+    marks = find_markers(fmt, data)
+    if not marks:
+        sys.exit("%s: no markers found" % a.wav)
+    log = read_log(a.log)
+    fs = fmt["rate"]
+    print("%s: %d Hz, %d ch, %d-bit%s; %d markers, %d device records"
+          % (a.wav, fs, fmt["ch"], fmt["bits"], " float" if fmt["tag"] == 3 else "", len(marks), len(log)))
+
+    # 录音里的序号 → 日志里的序号：用录音第一个标记对齐两边的回绕
+    wids = unwrap([m[1] for m in marks], LATPROBE_SYNC)
+    first = next((k for k in sorted(log) if k % LATPROBE_SYNC == marks[0][1]), None)
+    if first is None:
+        sys.exit("first marker in the capture (id %d) is not in the device log" % marks[0][1])
+    shift = first - wids[0]
+
+    seq = None
+    if a.csv:
+        seg = a.seg
+        if seg is None:
+            m = re.search(r"_seg(\d+)_", os.path.basename(a.wav))
+            if not m:
+                sys.exit("--seg not given and not in the WAV file name")
+            seg = int(m.group(1))
+        seq = read_csv_segment(a.csv, seg, fmt["align"])
+
+    rows, missing = [], 0
+    for (i, _), wid in zip(marks, wids):
+        r = log.get(wid + shift)
+        if r is None:
+            missing += 1
+            continue
+        row = dict(id=wid + shift, sample=i, t_gen=r["t_gen"], t_fifo=r["t_fifo"],
+                   gen_fifo=r["t_fifo"] - r["t_gen"], rel=i * 1e6 / fs - r["t_gen"])
+        if seq:
+            fr = arrival_frame(seq[0], seq[1], i)
+            if fr is None:
+                missing += 1
+                continue
+            t_bus = (fr + 1) * 1000                            # 包在该帧结束前完成
+            t_app = -(-(fr + 1) // a.period_ms) * a.period_ms * 1000   # 主机应用在下一个周期边界取数
+            row.update(frame=fr, fifo_host=t_bus - r["t_fifo"], e2e=t_app - r["t_gen"])
+        rows.append(row)
+    if missing:
+        print("%d markers without a device record or arrival frame (log truncated / dropped markers)" % missing)
+    if not rows:
+        sys.exit("no markers matched")
+
+    stats("generate -> FIFO", [r["gen_fifo"] for r in rows])
+    if seq:
+        stats("FIFO -> host (bus)", [r["fifo_host"] for r in rows])
+        stats("end-to-end (period %d ms)" % a.period_ms, [r["e2e"] for r in rows])
+    else:
+        base = min(r["rel"] for r in rows)
+        stats("end-to-end - min", [r["rel"] - base for r in rows])
+        if len(rows) >= 4:
+            # 漂移：前后两半各取中位数再求斜率，不受开流时那一个预生成标记之类的离群值影响
+            med = lambda v: sorted(v)[len(v) // 2]
+            h = len(rows) // 2
+            dx = med([r["t_gen"] for r in rows[h:]]) - med([r["t_gen"] for r in rows[:h]])
+            dd = med([r["rel"] for r in rows[h:]]) - med([r["rel"] for r in rows[:h]])
+            print("capture clock vs device clock: %+.1f ppm (absolute latency needs --csv or a shared time base)"
+                  % (dd / dx * 1e6 if dx else 0.0))
+    if a.o:
+        keys = ["id", "sample", "t_gen", "t_fifo", "gen_fifo"] + (["frame", "fifo_host", "e2e"] if seq else ["rel"])
+        with open(a.o, "w", newline="") as f:
+            w = csv.DictWriter(f, fieldnames=keys, extrasaction="ignore")
+            w.writeheader()
+            w.writerows(rows)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    s = sub.add_parser("set")
+    s.add_argument("ms", type=int, help="marker period [ms], 0 = off")
+    an = sub.add_parser("analyze")
+    an.add_argument("wav")
+    an.add_argument("log")
+    an.add_argument("--csv", help="uac2_sim -c frames.csv (absolute latency)")
+    an.add_argument("--seg", type=int, help="segment number in the CSV (default: from the WAV file name)")
+    an.add_argument("--period-ms", type=int, default=1, help="host application period [ms]")
+    an.add_argument("-o", help="write per-marker results as CSV")
+    a = ap.parse_args()
+    if a.cmd == "set":
+        set_period(a.ms)
+    else:
+        if a.period_ms < 1:
+            sys.exit("--period-ms must be >= 1")
+        analyze(a)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+// PDM 抽取基准：与固件相同的 pdm_decim.c，对每个 OSR 报告
+//   * 频响（按量化后的系数直接求）：通带 [0, min(20 kHz, 0.42·fs)] 起伏、半带阻带 [fs − 边缘, fs] 最差电平（2fs → fs 时折进通带的频段）、
+//     CIC 混叠抑制（k·2fs ± 通带边缘 处的最差电平，抽取到 2fs 时会折进通带）；
+//   * 二阶 ΣΔ 调制器生成的 1 kHz / −6 dBFS 位流经抽取后的 THD+N（受该调制器的带内噪声限制，真实麦克风阶数更高）；
+//   * 每输出样本的主机周期数，以及按 M0+ 指令计数估算的周期数与 core1 预算（125 MHz / fs）的比值；
+//   * 切换 OSR 时重建 CIC 字节表的耗时。
+//
+//   pdm_bench [out.pdm]    给出文件名时另写 10 s 的 3.072 MHz 位流（48k/OSR64 与 96k/OSR32 共用），供 uac2_sim -p
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pdm_decim.h"
+#include "analysis.h"
+#include "bench_util.h"
+
+#define SYS_CLK_HZ     125000000u
+#define TONE_N         16384
+#define SKIP_N         8192               // 直流阻断与滤波器历史的暖机
+#define BENCH_OUT      (1u << 20)
+#define TONE_AMP       0.5                // −6 dBFS（调制深度 ±1 = 满幅）
+#define WRITE_SECONDS  10
+
+// M0+ 周期模型（-O2 的典型指令序列）：查一次 CIC 表 ldrb + lsls + add + ldr + add ≈ 7；
+// 一个对称乘加 2×ldr + add + 拆分乘加 + 取系数 ≈ 14；每输出样本的循环/搬移/直流阻断/饱和约 40
+#define M0_CYC_LUT     7
+#define M0_CYC_MAC     14
+#define M0_CYC_OVH     40
+
+static pdm_decim_t s_d;
+
+static double cic_db(double nu, uint32_t R) {               // nu = f / fs
+  double a = M_PI * nu / 2.0, s = sin(a / R);
+  if (fabs(s) < 1e-15) return 0.0;
+  double r = fabs(sin(a) / (R * s));
+  return 20.0 * PDM_CIC_ORDER * log10(r + 1e-30);
+}
+
+static double hb_lin(const int16_t* hb, double nu) {
+  double v = 0.5;
+  for (uint32_t i = 0; i < PDM_HB_K; i++) v += 2.0 * hb[i] / 32768.0 * cos(M_PI * nu * (2.0 * i + 1.0));
+  return v;
+}
+
+static double cmp_lin(const int16_t* cmp, double nu) {
+  double v = cmp[0] / 16384.0;
+  for (uint32_t k = 1; k <= PDM_CMP_HALF; k++) v += 2.0 * cmp[k] / 16384.0 * cos(2.0 * M_PI * k * nu);
+  return v;
+}
+
+static void measure_response(uint32_t fs, uint32_t osr) {
+  const int16_t* hb = pdm_decim_hb_coef(osr);
+  const int16_t* cmp = pdm_decim_cmp_coef(osr);
+  uint32_t R = osr / 2;
+  double edge = fs * 0.42 < 20000.0 ? 0.42 : 20000.0 / fs;
+  double lo = 1e9, hi = -1e9, hb_stop = -1e9, cic_alias = -1e9;
+  for (uint32_t k = 0; k <= 400; k++) {
+    double nu = edge * k / 400;
+    double db = cic_db(nu, R) + 20 * log10(fabs(hb_lin(hb, nu) * cmp_lin(cmp, nu)));
+    if (db < lo) lo = db;
+    if (db > hi) hi = db;
+  }
+  for (uint32_t k = 0; k <= 400; k++) {                      // 2fs → fs 时折进通带的频段 [fs − 边缘, fs]
+    double nu = 1.0 - edge + edge * k / 400;
+    double db = cic_db(nu, R) + 20 * log10(fabs(hb_lin(hb, nu)) + 1e-30);
+    if (db > hb_stop) hb_stop = db;
+  }
+  for (uint32_t k = 1; k < R; k++) {                         // 2fs 的整数倍附近 ± 通带边缘
+    for (int s = -1; s <= 1; s += 2) {
+      double db = cic_db(2.0 * k + s * edge, R);
+      if (db > cic_alias) cic_alias = db;
+    }
+  }
+  printf("    pass ±%.3f dB to %5.0f Hz, half-band stop %6.1f dB above %5.0f Hz, CIC alias %6.1f dB\n",
+         (hi - lo) / 2, edge * fs, hb_stop, (1.0 - edge) * fs, cic_alias);
+}
+
+// 二阶 ΣΔ（NTF = (1 − z^-1)^2），位按时间顺序从字节高位填起
+typedef struct { double e1, e2; } sdm_t;
+
+static void sdm_bytes(sdm_t* m, uint8_t* out, uint32_t nbytes, double freq, double fclk, uint64_t* t) {
+  for (uint32_t b = 0; b < nbytes; b++) {
+    uint8_t v = 0;
+    for (uint32_t i = 0; i < 8; i++, (*t)++) {
+      double u = TONE_AMP * sin(2 * M_PI * freq * (double)*t / fclk);
+      double s = u - 2 * m->e1 + m->e2, y = s >= 0 ? 1.0 : -1.0;
+      m->e2 = m->e1;
+      m->e1 = y - s;
+      v = (uint8_t)(v << 1 | (y > 0));
+    }
+    out[b] = v;
+  }
+}
+
+static double measure_thdn(uint32_t fs, uint32_t osr, double freq) {
+  static uint8_t bits[PDM_BLOCK * PDM_OSR_LOW / 8];
+  static int32_t out[PDM_BLOCK];
+  static double  y[TONE_N];
+  sdm_t m = { 0, 0 };
+  uint64_t t = 0;
+  uint32_t nb = PDM_BLOCK * osr / 8;
+  pdm_decim_init(&s_d, osr);
+  for (uint32_t done = 0; done < SKIP_N + TONE_N; done += PDM_BLOCK) {
+    sdm_bytes(&m, bits, nb, freq, (double)fs * osr, &t);
+    pdm_decim_run(&s_d, bits, out, PDM_BLOCK);
+    for (uint32_t i = 0; i < PDM_BLOCK; i++)
+      if (done + i >= SKIP_N) y[done + i - SKIP_N] = out[i] / 2147483648.0;
+  }
+  return analysis_thdn_db(y, TONE_N, freq, fs);
+}
+
+static void measure_cycles(uint32_t fs, uint32_t osr) {
+  static uint8_t bits[PDM_BLOCK * PDM_OSR_LOW / 8 * 64];    // 64 块不同的随机位流
+  static int32_t out[PDM_BLOCK];
+  uint32_t nb = PDM_BLOCK * osr / 8, seed = 1;
+  for (uint32_t i = 0; i < sizeof(bits); i++) { seed = seed * 1664525u + 1013904223u; bits[i] = (uint8_t)(seed >> 24); }
+
+  uint64_t t0 = bench_now_ns();
+  for (int i = 0; i < 16; i++) pdm_decim_init(&s_d, osr);
+  uint64_t init_ns = (bench_now_ns() - t0) / 16;
+
+  uint64_t c0 = bench_cycles();
+  t0 = bench_now_ns();
+  for (uint32_t done = 0, k = 0; done < BENCH_OUT; done += PDM_BLOCK, k = (k + 1) & 63) {
+    pdm_decim_run(&s_d, bits + k * nb, out, PDM_BLOCK);
+    bench_sink(out);
+  }
+  uint64_t cyc = bench_cycles() - c0, ns = bench_now_ns() - t0;
+  uint32_t R = osr / 2;
+  uint32_t m0 = R * M0_CYC_LUT + (PDM_HB_K + PDM_CMP_HALF + 1) * M0_CYC_MAC + M0_CYC_OVH;
+  uint32_t budget = SYS_CLK_HZ / fs;
+  printf("    host %.1f cycles/out (%.1f ns); CIC %u lookups + %u MACs per output\n",
+         (double)cyc / BENCH_OUT, (double)ns / BENCH_OUT, R, PDM_HB_K + PDM_CMP_HALF + 1);
+  printf("    M0+ est. %u cycles/out of %u budget at %u Hz (%.0f%% of core1), CIC table rebuild %.1f us (host)\n",
+         m0, budget, fs, 100.0 * m0 / budget, init_ns / 1000.0);
+}
+
+static void write_pdm(const char* path) {
+  static uint8_t buf[4096];
+  FILE* f = fopen(path, "wb");
+  if (!f) { perror(path); return; }
+  sdm_t m = { 0, 0 };
+  uint64_t t = 0;
+  for (uint32_t left = 3072000u / 8 * WRITE_SECONDS; left; ) {
+    uint32_t n = left < sizeof(buf) ? left : sizeof(buf);
+    sdm_bytes(&m, buf, n, 1000.0, 3072000.0, &t);
+    fwrite(buf, 1, n, f);
+    left -= n;
+  }
+  fclose(f);
+  printf("wrote %s: %u s of 1 kHz at -6 dBFS, 3.072 MHz PDM clock\n", path, WRITE_SECONDS);
+}
+
+int main(int argc, char** argv) {
+  static const uint32_t rates[] = { 16000, 44100, 48000, 88200, 96000 };
+  pdm_decim_table_init();
+  for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    uint32_t fs = rates[i], osr = pdm_osr_for(fs);
+    printf("%6u Hz: OSR %u, PDM clock %.4f MHz, CIC R=%u (%u byte tables, %u bytes)\n", fs, osr, fs * osr / 1e6,
+           osr / 2, PDM_CIC_ORDER * osr / 16, PDM_CIC_ORDER * osr / 16 * 256 * 4);
+    measure_response(fs, osr);
+    printf("    THD+N %.1f dB @ 1 kHz (2nd-order sigma-delta source)\n", measure_thdn(fs, osr, 1000.0));
+    measure_cycles(fs, osr);
+  }
+  if (argc > 1) write_pdm(argv[1]);
+  return 0;
+}
@@ -0,0 +1,195 @@
+// 16-bit 重新量化基准：原来的截断 vs TPDF 抖动 vs TPDF + 一阶 / 二阶误差反馈（src/requant.c）。
+// 输入是理想正弦（double 生成、量化到 Q31），按 PRODUCE_CHUNK 一块走固件内核，再像 pcm_pack_s16 一样取高半字。
+// 对每个电平报告：THD（2..9 次谐波，最小二乘拟合）、可听带内（20 Hz–20 kHz）噪底与全带噪声（拟合残差，dBFS），
+// 直流偏移（LSB）；另测每个内核每样本的周期数（含 pcm_pack_s16 作参照）。
+//   requant_bench [tone_hz]      默认 997 Hz（与采样率互质，谐波不落在同一批 bin 上）
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "requant.h"
+#include "pcm_pack.h"
+#include "bench_util.h"
+
+#define CHUNK      32                 // = audio_engine.c PRODUCE_CHUNK
+#define N          65536              // 分析长度（2 的幂，FFT）
+#define WARMUP     4096               // 丢弃：整形器状态建立
+#define HARMONICS  9
+#define REPEAT     200000
+
+static const char* const k_mode[REQUANT_COUNT] = { "truncate", "TPDF", "TPDF+NS1", "TPDF+NS2" };
+
+//--------------------------------------------------------------------+
+// 待测路径：Q31 → （重新量化）→ 取高半字
+//--------------------------------------------------------------------+
+static void render(requant_mode_t mode, double fs, double freq, double level_db, int16_t* out) {
+  double amp = pow(10.0, level_db / 20.0) * 2147483647.0;
+  requant_ch_t ch;
+  requant_reset(&ch);
+  uint32_t rng = 0x2545F491u;
+  int32_t  blk[CHUNK];
+  for (uint32_t i = 0; i < WARMUP + N; i += CHUNK) {
+    for (uint32_t k = 0; k < CHUNK; k++)
+      blk[k] = (int32_t)lrint(amp * sin(2.0 * M_PI * freq * (double)(i + k) / fs + 0.3));
+    if (requant_table[mode]) requant_table[mode](blk, CHUNK, &ch, &rng);
+    for (uint32_t k = 0; k < CHUNK; k++)
+      if (i + k >= WARMUP) out[i + k - WARMUP] = (int16_t)((uint32_t)blk[k] >> 16);
+  }
+}
+
+//--------------------------------------------------------------------+
+// 分析：直流 + 基波 + 谐波的最小二乘拟合；残差经 FFT 求带内占比
+//--------------------------------------------------------------------+
+#define NB  (1 + 2 * HARMONICS)
+
+static void solve(double m[NB][NB + 1], int nb, double* r) {
+  for (int c = 0; c < nb; c++) {
+    int piv = c;
+    for (int k = c + 1; k < nb; k++) if (fabs(m[k][c]) > fabs(m[piv][c])) piv = k;
+    for (int j = 0; j <= nb; j++) { double t = m[c][j]; m[c][j] = m[piv][j]; m[piv][j] = t; }
+    for (int k = c + 1; k < nb; k++) {
+      double f = m[k][c] / m[c][c];
+      for (int j = c; j <= nb; j++) m[k][j] -= f * m[c][j];
+    }
+  }
+  for (int c = nb - 1; c >= 0; c--) {
+    double s = m[c][nb];
+    for (int j = c + 1; j < nb; j++) s -= m[c][j] * r[j];
+    r[c] = s / m[c][c];
+  }
+}
+
+static void fft(double* re, double* im, uint32_t n) {
+  for (uint32_t i = 1, j = 0; i < n; i++) {
+    uint32_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) { double t = re[i]; re[i] = re[j]; re[j] = t; t = im[i]; im[i] = im[j]; im[j] = t; }
+  }
+  for (uint32_t len = 2; len <= n; len <<= 1) {
+    double a = -2.0 * M_PI / len;
+    for (uint32_t i = 0; i < n; i += len) {
+      for (uint32_t k = 0; k < len / 2; k++) {
+        double wr = cos(a * k), wi = sin(a * k);
+        double xr = re[i + k + len / 2] * wr - im[i + k + len / 2] * wi;
+        double xi = re[i + k + len / 2] * wi + im[i + k + len / 2] * wr;
+        re[i + k + len / 2] = re[i + k] - xr; im[i + k + len / 2] = im[i + k] - xi;
+        re[i + k] += xr;                      im[i + k] += xi;
+      }
+    }
+  }
+}
+
+typedef struct { double thd_db, band_dbfs, full_dbfs, dc_lsb; } result_t;
+
+static result_t analyze(const int16_t* y16, double fs, double freq) {
+  static double y[N], re[N], im[N];
+  static double basis[NB];
+  int h_max = 1;
+  while (h_max < HARMONICS && (h_max + 1) * freq < fs / 2) h_max++;
+  int nb = 1 + 2 * h_max;
+
+  double m[NB][NB + 1];
+  memset(m, 0, sizeof(m));
+  for (uint32_t i = 0; i < N; i++) {
+    y[i] = y16[i] / 32768.0;
+    basis[0] = 1.0;
+    for (int h = 1; h <= h_max; h++) {
+      double w = 2.0 * M_PI * freq * h * i / fs;
+      basis[2 * h - 1] = sin(w);
+      basis[2 * h]     = cos(w);
+    }
+    for (int r = 0; r < nb; r++) {
+      for (int c = r; c < nb; c++) m[r][c] += basis[r] * basis[c];
+      m[r][nb] += basis[r] * y[i];
+    }
+  }
+  for (int r = 0; r < nb; r++) for (int c = 0; c < r; c++) m[r][c] = m[c][r];
+  double k[NB];
+  solve(m, nb, k);
+
+  result_t out;
+  double fund = k[1] * k[1] + k[2] * k[2], harm = 0.0;
+  for (int h = 2; h <= h_max; h++) harm += k[2 * h - 1] * k[2 * h - 1] + k[2 * h] * k[2 * h];
+  out.thd_db = 10.0 * log10(harm / fund + 1e-30);
+  out.dc_lsb = k[0] * 32768.0;
+
+  double p = 0.0;
+  for (uint32_t i = 0; i < N; i++) {
+    double f = k[0];
+    for (int h = 1; h <= h_max; h++) {
+      double w = 2.0 * M_PI * freq * h * i / fs;
+      f += k[2 * h - 1] * sin(w) + k[2 * h] * cos(w);
+    }
+    double r = y[i] - f;
+    p += r * r;
+    double win = 0.5 - 0.5 * cos(2.0 * M_PI * i / N);   // Hann：只用来求带内占比
+    re[i] = r * win;
+    im[i] = 0.0;
+  }
+  p /= N;
+  fft(re, im, N);
+  double all = 0.0, band = 0.0;
+  for (uint32_t b = 1; b < N / 2; b++) {
+    double e = re[b] * re[b] + im[b] * im[b];
+    double f = b * fs / N;
+    all += e;
+    if (f >= 20.0 && f <= 20000.0) band += e;
+  }
+  // dBFS：相对满幅正弦（均方 0.5）
+  out.full_dbfs = 10.0 * log10(p / 0.5);
+  out.band_dbfs = 10.0 * log10(p * (band / all) / 0.5);
+  return out;
+}
+
+//--------------------------------------------------------------------+
+// 开销：每个内核处理一块 CHUNK 样本
+//--------------------------------------------------------------------+
+static void cost(void) {
+  static int32_t src[CHUNK], blk[CHUNK];
+  static uint32_t packed[CHUNK / 2];
+  for (uint32_t i = 0; i < CHUNK; i++) src[i] = (int32_t)lrint(1e8 * sin(0.1 * i));
+  printf("\ncost per sample (host, %u-sample blocks, 1 channel):\n", CHUNK);
+  for (int mode = 0; mode <= REQUANT_COUNT; mode++) {
+    requant_ch_t ch;
+    requant_reset(&ch);
+    uint32_t rng = 1;
+    const int32_t* pl[1] = { blk };
+    uint64_t best = UINT64_MAX;
+    for (int pass = 0; pass < 5; pass++) {
+      uint64_t c0 = bench_cycles();
+      for (int r = 0; r < REPEAT; r++) {
+        memcpy(blk, src, sizeof(blk));
+        if (mode == REQUANT_COUNT) pcm_pack_s16(pl, 1, CHUNK, packed);
+        else if (requant_table[mode]) requant_table[mode](blk, CHUNK, &ch, &rng);
+        bench_sink(blk);
+        bench_sink(packed);
+      }
+      uint64_t c = bench_cycles() - c0;
+      if (c < best) best = c;
+    }
+    printf("  %-16s %6.2f cycles/sample (incl. block copy)\n",
+           mode == REQUANT_COUNT ? "pcm_pack_s16" : k_mode[mode], (double)best / REPEAT / CHUNK);
+  }
+}
+
+int main(int argc, char** argv) {
+  double freq = argc > 1 ? atof(argv[1]) : 997.0;
+  static const double k_fs[]    = { 48000.0, 96000.0 };
+  static const double k_level[] = { -6.0, -40.0, -60.0, -80.0, -90.0 };
+  static int16_t y[N];
+  printf("16-bit requantization of a %.0f Hz sine (%u samples after %u warm-up), noise = fit residual\n", freq, N, WARMUP);
+  for (unsigned f = 0; f < sizeof(k_fs) / sizeof(k_fs[0]); f++) {
+    printf("\nfs %.0f Hz        level    THD [dBc]  noise 20-20k [dBFS]  full band [dBFS]  DC [LSB]\n", k_fs[f]);
+    for (unsigned l = 0; l < sizeof(k_level) / sizeof(k_level[0]); l++) {
+      for (int mode = 0; mode < REQUANT_COUNT; mode++) {
+        render((requant_mode_t)mode, k_fs[f], freq, k_level[l], y);
+        result_t r = analyze(y, k_fs[f], freq);
+        printf("  %-12s %6.0f dBFS  %9.1f  %19.1f  %16.1f  %8.2f\n",
+               k_mode[mode], k_level[l], r.thd_db, r.band_dbfs, r.full_dbfs, r.dc_lsb);
+      }
+    }
+  }
+  cost();
+  return 0;
+}
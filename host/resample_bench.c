@@ -0,0 +1,121 @@
+// 多相重采样基准：与固件相同的 resampler.c，按录音采样率为每个声明的采样率建表，逐比例报告
+//   * 系数表规模（相数 × 每相抽头，共用表只算一次）；
+//   * 频响：把量化后的 Q15 系数拼回原型滤波器直接求 DFT，通带 [0, 0.4·fmin] 起伏、−3 dB 点、
+//     阻带 [0.6·fmin, L·fs_in/2] 最差电平（会混叠/镜像进 0.4·fmin 以内的分量），fmin = min(输入, 输出)；
+//   * 1 kHz 与 0.4·fmin 正弦（−1 dBFS）经重采样后的 THD+N；
+//   * 单通道每输出样本的主机周期数（M0+ 上的开销按 "taps/out" 乘每抽头约 8 周期估算）。
+//
+//   resample_bench [src_fs ...]    省略参数时测 48000 与 44100
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "resampler.h"
+#include "analysis.h"
+#include "bench_util.h"
+
+#define TONE_N      16384
+#define BENCH_OUT   (1u << 21)
+
+static resampler_t s_rs;
+
+// 原型滤波器 |H(f)|（dB），f 以 Hz 计；相量递推代替逐点三角函数
+static double resp_db(const double* h, uint32_t n, double f, double fp) {
+  double w = 2 * M_PI * f / fp, cr = cos(w), ci = -sin(w), pr = 1, pi = 0, re = 0, im = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    re += h[k] * pr; im += h[k] * pi;
+    double t = pr * cr - pi * ci; pi = pr * ci + pi * cr; pr = t;
+  }
+  return 10 * log10(re * re + im * im + 1e-30);
+}
+
+static void measure_response(const rs_ratio_t* r) {
+  uint32_t n = (uint32_t)r->L * r->taps;
+  double*  h = malloc(n * sizeof(double));
+  for (uint32_t p = 0; p < r->L; p++)
+    for (uint32_t i = 0; i < r->taps; i++)
+      h[p + (r->taps - 1 - i) * r->L] = r->coef[p * r->taps + i] / (32768.0 * r->L);
+
+  double fp = (double)r->L * r->in_fs, fmin = r->in_fs < r->out_fs ? r->in_fs : r->out_fs;
+  double lo = 1e9, hi = -1e9, f3 = 0, stop = -1e9;
+  for (uint32_t k = 0; k <= 200; k++) {
+    double db = resp_db(h, n, 0.4 * fmin * k / 200, fp);
+    if (db < lo) lo = db;
+    if (db > hi) hi = db;
+  }
+  for (double f = 0.4 * fmin; f < 0.6 * fmin; f += fmin / 2000)
+    if (resp_db(h, n, f, fp) > -3.0) f3 = f;
+  uint32_t pts = 8 * n;                                     // 每个旁瓣约 16 个点
+  for (uint32_t k = 0; k <= pts; k++) {
+    double db = resp_db(h, n, 0.6 * fmin + (fp / 2 - 0.6 * fmin) * k / pts, fp);
+    if (db > stop) stop = db;
+  }
+  printf("    pass ±%.4f dB to %5.0f Hz, -3 dB at %5.0f Hz, stop %6.1f dB above %5.0f Hz\n",
+         (hi - lo) / 2, 0.4 * fmin, f3, stop, 0.6 * fmin);
+  free(h);
+}
+
+// fs_in 下的正弦 → 重采样 → THD+N（跳过滤波器填满之前的输出）
+static double measure_thdn(const rs_ratio_t* r, double freq) {
+  static int32_t out[RS_BLOCK];
+  static double  y[TONE_N];
+  int32_t* po[1] = { out };
+  resampler_reset(&s_rs, r);
+  uint32_t skip = 2u * r->taps * r->L / r->M + RS_BLOCK, total = 0, t = 0;   // 历史缓冲填满之后
+  double   amp = 0.891 * 2147483647.0;                      // −1 dBFS
+  while (total < skip + TONE_N) {
+    uint32_t need = resampler_need(&s_rs, RS_BLOCK);
+    int32_t* dst  = resampler_in(&s_rs, 0);
+    for (uint32_t i = 0; i < need; i++, t++) dst[i] = (int32_t)lrint(amp * sin(2 * M_PI * freq * t / r->in_fs));
+    resampler_run_q31(&s_rs, po, 1, RS_BLOCK);
+    for (uint32_t i = 0; i < RS_BLOCK; i++, total++)
+      if (total >= skip && total < skip + TONE_N) y[total - skip] = out[i] / 2147483648.0;
+  }
+  return analysis_thdn_db(y, TONE_N, freq, r->out_fs);
+}
+
+static void measure_cycles(const rs_ratio_t* r) {
+  static int32_t out[RS_BLOCK];
+  int32_t* po[1] = { out };
+  resampler_reset(&s_rs, r);
+  uint32_t seed = 1;
+  uint64_t c0 = bench_cycles(), t0 = bench_now_ns();
+  for (uint32_t done = 0; done < BENCH_OUT; done += RS_BLOCK) {
+    uint32_t need = resampler_need(&s_rs, RS_BLOCK);
+    int32_t* dst  = resampler_in(&s_rs, 0);
+    for (uint32_t i = 0; i < need; i++) { seed = seed * 1664525u + 1013904223u; dst[i] = (int32_t)seed >> 1; }
+    resampler_run_q31(&s_rs, po, 1, RS_BLOCK);
+    bench_sink(out);
+  }
+  uint64_t cyc = bench_cycles() - c0, ns = bench_now_ns() - t0;
+  printf("    %.1f cycles/out (%.1f ns), %u taps/out, %.2f M taps/s at %u Hz\n",
+         (double)cyc / BENCH_OUT, (double)ns / BENCH_OUT, r->taps, (double)r->taps * r->out_fs / 1e6, r->out_fs);
+}
+
+static void run_src(uint32_t src_fs) {
+  uint32_t n = resampler_table_init(src_fs);
+  printf("source %u Hz: %u ratios, coefficient pool %u / %u (%u bytes)\n", src_fs, n, resampler_pool_used(),
+         CFG_MIC_RESAMPLE_POOL, resampler_pool_used() * 2);
+  for (uint32_t i = 0; i < n; i++) {
+    const rs_ratio_t* r = resampler_ratio(i);
+    const rs_ratio_t* first = r;                              // 第一个使用该表的比例
+    for (uint32_t j = 0; j < i; j++) if (resampler_ratio(j)->coef == r->coef) { first = resampler_ratio(j); break; }
+    printf("  -> %6u Hz  %3u/%-3u  %3u phases x %3u taps", r->out_fs, r->L, r->M, r->L, r->taps);
+    if (first != r) printf("  (shares table with %u Hz)\n", first->out_fs);
+    else            printf("  %6u bytes\n", r->L * r->taps * 2u);
+    measure_response(r);
+    double fmin = r->in_fs < r->out_fs ? r->in_fs : r->out_fs;
+    printf("    THD+N %.1f dB @ 1 kHz, %.1f dB @ %.0f Hz\n", measure_thdn(r, 1000.0),
+           measure_thdn(r, floor(0.4 * fmin)), floor(0.4 * fmin));
+    measure_cycles(r);
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) run_src((uint32_t)strtoul(argv[i], 0, 0));
+  } else {
+    run_src(48000);
+    run_src(44100);
+  }
+  return 0;
+}
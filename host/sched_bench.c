@@ -0,0 +1,57 @@
+// 采样率调度器基准：对采样率表里的每个采样率（步进区间逐点展开）模拟 24 小时的 1 ms 帧，
+// 校验累计样本数与理论值完全相等（零漂移），并报告与理想曲线的最大偏差和每帧耗时。
+// 另附一个 NTSC 拉速率（48000×1000/1001）验证任意有理数采样率。
+#include <math.h>
+#include <stdio.h>
+#include "rate_sched.h"
+#include "uac2_rates.h"
+#include "bench_util.h"
+
+#define FRAMES_24H   (24ull * 3600ull * 1000ull)
+
+static int check_rate(uint32_t num, uint32_t den) {
+  rate_sched_t s;
+  rate_sched_init(&s, num, den, 1000);
+
+  uint64_t total = 0;
+  double   max_dev = 0.0;
+  uint32_t nmin = UINT32_MAX, nmax = 0;
+  double   per_frame = (double)num / den / 1000.0;
+  uint64_t t0 = bench_now_ns();
+  for (uint64_t k = 1; k <= FRAMES_24H; k++) {
+    uint32_t n = rate_sched_next(&s);
+    total += n;
+    if (n < nmin) nmin = n;
+    if (n > nmax) nmax = n;
+    if ((k & 0x3FF) == 0) {                 // 抽样检查与理想曲线的偏差
+      double dev = fabs((double)total - per_frame * (double)k);
+      if (dev > max_dev) max_dev = dev;
+    }
+  }
+  uint64_t ns = bench_now_ns() - t0;
+
+  // 理论值：floor(24h × num / den)
+  uint64_t expect = (FRAMES_24H / 1000ull) * num / den;
+  int ok = (total == expect) && max_dev < 1.0;
+  printf("%9.3f Hz  samples/frame %u..%u  24h total %llu (expect %llu)  drift %lld  max dev %.3f  %.2f ns/frame  %s\n",
+         (double)num / den, nmin, nmax, (unsigned long long)total, (unsigned long long)expect,
+         (long long)(total - expect), max_dev, (double)ns / FRAMES_24H, ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+int main(void) {
+  int fails = 0;
+  printf("rate table (%d sub-ranges), 24 h = %llu frames @ 1 ms\n", UAC2_RATE_COUNT, (unsigned long long)FRAMES_24H);
+#define RATE_CHECK_(mn, mx, res) \
+  for (uint32_t fs = (mn); fs <= (mx); fs += ((res) ? (res) : 1)) { fails += check_rate(fs, 1); if (!(res)) break; }
+  UAC2_RATE_TABLE(RATE_CHECK_)
+#undef RATE_CHECK_
+  fails += check_rate(48000u * 1000u, 1001u);
+
+  // 对照：朴素浮点累加（每帧 += fs/1000.0f）24 小时后的漂移
+  float acc = 0.0f; uint64_t naive = 0;
+  for (uint64_t k = 0; k < FRAMES_24H; k++) { acc += 44.1f; uint32_t n = (uint32_t)acc; acc -= (float)n; naive += n; }
+  printf("reference: float accumulator @ 44100 Hz drifts %lld samples in 24 h\n",
+         (long long)naive - (long long)(44100ull * 86400ull));
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,9 @@
+#ifndef __SIM_BSP_BOARD_H__
+#define __SIM_BSP_BOARD_H__
+// 主机仿真：bsp/board.h 替身
+#include <stdint.h>
+
+static inline void board_init(void) {}
+uint32_t board_millis(void);
+
+#endif
@@ -0,0 +1,31 @@
+// 主机仿真：flash_image_map() 替身，mmap 一个镜像文件代替 XIP 窗口（uac2_sim -f / flash_bench）
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "flash_image.h"
+#include "tusb_sim.h"
+
+static const uint8_t* s_img;
+static uint32_t       s_len;
+
+bool sim_flash_image_load(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  void* p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size <= 0x7FFFFFFF) {
+    p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (p == MAP_FAILED) return false;
+  s_img = (const uint8_t*)p;
+  s_len = (uint32_t)st.st_size;
+  return true;
+}
+
+const uint8_t* flash_image_map(uint32_t* len) {
+  *len = s_len;
+  return s_img;
+}
@@ -0,0 +1,17 @@
+#ifndef __SIM_HARDWARE_STRUCTS_SYSTICK_H__
+#define __SIM_HARDWARE_STRUCTS_SYSTICK_H__
+// 主机仿真：SysTick 替身。每次访问 systick_hw 都用主机周期计数刷新 cvr（24-bit 向下计数），
+// 写 csr/rvr 没有效果
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t csr;
+  volatile uint32_t rvr;
+  volatile uint32_t cvr;
+  volatile uint32_t calib;
+} systick_hw_t;
+
+systick_hw_t* sim_systick(void);
+#define systick_hw (sim_systick())
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __SIM_HARDWARE_STRUCTS_USB_H__
+#define __SIM_HARDWARE_STRUCTS_USB_H__
+// 主机仿真：USB 控制器寄存器替身，只有 SOF_RD（每次访问按仿真帧号刷新）
+#include <stdint.h>
+
+#define USB_SOF_RD_BITS   0x000007ffu
+
+typedef struct {
+  volatile uint32_t sof_rd;
+} usb_hw_t;
+
+usb_hw_t* sim_usb_hw(void);
+#define usb_hw (sim_usb_hw())
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef __SIM_HARDWARE_SYNC_H__
+#define __SIM_HARDWARE_SYNC_H__
+// 主机仿真：SEV 唤醒 core1；core1 里的 WFE 让出控制权回到仿真器
+void __sev(void);
+void __wfe(void);
+
+// 单线程仿真：没有真正的中断可屏蔽
+#include <stdint.h>
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void     restore_interrupts(uint32_t status) { (void)status; }
+
+#endif
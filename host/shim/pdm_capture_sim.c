@@ -0,0 +1,108 @@
+// 主机仿真：pdm_capture.c 替身。循环读一个 1-bit 位流文件（字节内高位先到），
+// 按仿真时间（time_us_32）与 PDM 时钟把字节放进与固件同样大小的双半区缓冲，代替 PIO + DMA。
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pdm_capture.h"
+#include "tusb_sim.h"
+
+#define PDM_BUF    (2 * PDM_CAPTURE_HALF)
+
+static uint8_t*  s_file;
+static uint32_t  s_file_len;
+static uint8_t   s_buf[PDM_BUF];
+static uint32_t  s_clk;                         // 0 = 停止
+static uint32_t  s_t0;                          // start 时的仿真时间（us）
+static uint32_t  s_wr, s_rd, s_src;             // 已写入 / 已消费字节数、文件读位置
+static int32_t   s_ppm;                         // PDM 时钟相对标称值的偏差
+static bool      s_filled;
+static uint32_t  s_avg;
+static uint8_t   s_wrap[PDM_CAPTURE_PEEK_MAX];
+static pdm_capture_stats_t s_st;
+
+bool sim_pdm_load(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (n > 0) s_file = malloc((size_t)n);
+  bool ok = s_file && fread(s_file, 1, (size_t)n, f) == (size_t)n;
+  fclose(f);
+  if (!ok) return false;
+  s_file_len = (uint32_t)n;
+  return true;
+}
+
+bool pdm_capture_init(void) {
+  return s_file != NULL;
+}
+
+void pdm_capture_start(uint32_t clk_hz) {
+  s_clk = s_file ? clk_hz : 0;
+  s_t0  = time_us_32();
+  s_wr  = s_rd = 0;
+  s_filled = false;
+}
+
+void sim_pdm_set_ppm(int32_t ppm) {
+  s_ppm = ppm;
+}
+
+// "DMA"：把从 start 到现在 PDM 时钟送出的字节补进缓冲
+static void update_wr(void) {
+  int64_t  bits = (int64_t)(time_us_32() - s_t0) * s_clk;     // 位数 × 10^6
+  bits += bits / 1000000 * s_ppm;
+  uint32_t now = (uint32_t)(bits / 8000000);
+  for (; s_wr != now; s_wr++) {
+    s_buf[s_wr & (PDM_BUF - 1)] = s_file[s_src];
+    if (++s_src == s_file_len) s_src = 0;
+  }
+}
+
+// 以下与 pdm_capture.c 相同
+// 读位置退到写位置之前 FILL 字节（按校正步长对齐，保持抽取的相位）
+static void refill(void) {
+  s_rd  = (s_wr - PDM_CAPTURE_FILL) & ~(uint32_t)(PDM_CAPTURE_SLIP - 1);
+  s_avg = PDM_CAPTURE_FILL << 4;
+}
+
+const uint8_t* pdm_capture_peek(uint32_t n) {
+  if (!s_clk) return NULL;
+  update_wr();
+  if (!s_filled) {                                             // 开始采集：先攒到半满
+    if (s_wr - s_rd < PDM_CAPTURE_FILL) return NULL;
+    s_filled = true;
+    refill();
+  } else if (s_wr - s_rd > PDM_BUF - PDM_CAPTURE_HALF / 2) {   // DMA 即将追上读位置：校正没跟上，整段重新对齐
+    refill();
+    s_st.overruns++;
+  }
+  uint32_t level = s_wr - s_rd;
+  if (level < n) return NULL;
+  s_avg += level - (s_avg >> 4);                               // 一阶平滑（Q4），滤掉按帧取数的锯齿
+  uint32_t avg = s_avg >> 4;
+  if (avg > PDM_CAPTURE_FILL + PDM_CAPTURE_WINDOW && level >= n + PDM_CAPTURE_SLIP) {
+    s_rd  += PDM_CAPTURE_SLIP;                                 // PDM 偏快：丢一块
+    s_avg -= PDM_CAPTURE_SLIP << 4;
+    s_st.dropped++;
+  } else if (avg + PDM_CAPTURE_WINDOW < PDM_CAPTURE_FILL) {
+    s_rd  -= PDM_CAPTURE_SLIP;                                 // PDM 偏慢：重复一块（水位不到半满，旧数据还在）
+    s_avg += PDM_CAPTURE_SLIP << 4;
+    s_st.repeated++;
+  }
+  uint32_t off = s_rd & (PDM_BUF - 1);
+  if (off + n <= PDM_BUF) return s_buf + off;
+  memcpy(s_wrap, s_buf + off, PDM_BUF - off);                  // 跨缓冲末尾：拼成连续的一块
+  memcpy(s_wrap + (PDM_BUF - off), s_buf, n - (PDM_BUF - off));
+  return s_wrap;
+}
+
+void pdm_capture_release(uint32_t n) {
+  s_rd += n;
+}
+
+void pdm_capture_get_stats(pdm_capture_stats_t* out) {
+  *out = s_st;
+}
@@ -0,0 +1,6 @@
+#ifndef __SIM_PICO_MULTICORE_H__
+#define __SIM_PICO_MULTICORE_H__
+// 主机仿真：core1 由仿真器在每次 SEV 后同步运行到下一次 WFE（见 tusb_sim.c）
+void multicore_launch_core1(void (*entry)(void));
+
+#endif
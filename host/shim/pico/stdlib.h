@@ -0,0 +1,17 @@
+#ifndef __SIM_PICO_STDLIB_H__
+#define __SIM_PICO_STDLIB_H__
+// 主机仿真：pico/stdlib.h 替身
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// core0 自旋等待时让出：有 SEV 就同步运行 core1，并把仿真时间推进 1 us（帧内不超过 999）
+void tight_loop_contents(void);
+
+// 仿真时间：1 ms SOF 帧号 × 1000 + 本帧内自旋推进的 us；core1 在仿真器里同步运行时返回 1
+uint32_t time_us_32(void);
+unsigned get_core_num(void);
+
+#endif
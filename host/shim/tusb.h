@@ -0,0 +1,394 @@
+#ifndef __SIM_TUSB_H__
+#define __SIM_TUSB_H__
+// ===== 主机仿真用 TinyUSB 替身 =====
+// 只提供本工程用到的类型、常量、描述符宏和 API，数值/字节布局与 TinyUSB 保持一致，
+// 使 src/ 与 lib/tusb/ 下的固件源码不改一行即可在 Linux 上编译。实现见 tusb_sim.c。
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "tusb_config.h"
+
+//--------------------------------------------------------------------+
+// 通用
+//--------------------------------------------------------------------+
+#define OPT_MCU_RP2040            2000
+#define OPT_MODE_DEVICE           0x0001
+#define TUD_OPT_HIGH_SPEED        0
+
+#define TU_ATTR_PACKED            __attribute__((packed))
+#define TU_ATTR_WEAK              __attribute__((weak))
+#define TU_BIT(n)                 (1UL << (n))
+#define TU_U16_HIGH(u16)          ((uint8_t) (((u16) >> 8) & 0x00ff))
+#define TU_U16_LOW(u16)           ((uint8_t) ((u16) & 0x00ff))
+#define U16_TO_U8S_LE(u16)        TU_U16_LOW(u16), TU_U16_HIGH(u16)
+#define TU_U32_BYTE3(u32)         ((uint8_t) ((((uint32_t) u32) >> 24) & 0x000000ff))
+#define TU_U32_BYTE2(u32)         ((uint8_t) ((((uint32_t) u32) >> 16) & 0x000000ff))
+#define TU_U32_BYTE1(u32)         ((uint8_t) ((((uint32_t) u32) >>  8) & 0x000000ff))
+#define TU_U32_BYTE0(u32)         ((uint8_t) (((uint32_t) u32)         & 0x000000ff))
+#define U32_TO_U8S_LE(u32)        TU_U32_BYTE0(u32), TU_U32_BYTE1(u32), TU_U32_BYTE2(u32), TU_U32_BYTE3(u32)
+#define TU_ARRAY_SIZE(a)          (sizeof(a)/sizeof(a[0]))
+
+static inline uint16_t tu_min16(uint16_t x, uint16_t y) { return (x < y) ? x : y; }
+
+//--------------------------------------------------------------------+
+// USB 标准类型
+//--------------------------------------------------------------------+
+typedef enum {
+  TUSB_DESC_DEVICE                = 0x01,
+  TUSB_DESC_CONFIGURATION         = 0x02,
+  TUSB_DESC_STRING                = 0x03,
+  TUSB_DESC_INTERFACE             = 0x04,
+  TUSB_DESC_ENDPOINT              = 0x05,
+  TUSB_DESC_INTERFACE_ASSOCIATION = 0x0B,
+  TUSB_DESC_CS_INTERFACE          = 0x24,
+  TUSB_DESC_CS_ENDPOINT           = 0x25,
+} tusb_desc_type_t;
+
+typedef enum {
+  TUSB_XFER_CONTROL = 0,
+  TUSB_XFER_ISOCHRONOUS,
+  TUSB_XFER_BULK,
+  TUSB_XFER_INTERRUPT
+} tusb_xfer_type_t;
+
+enum {
+  TUSB_ISO_EP_ATT_NO_SYNC      = 0x00,
+  TUSB_ISO_EP_ATT_ASYNCHRONOUS = 0x04,
+  TUSB_ISO_EP_ATT_ADAPTIVE     = 0x08,
+  TUSB_ISO_EP_ATT_SYNCHRONOUS  = 0x0C,
+  TUSB_ISO_EP_ATT_DATA         = 0x00,
+  TUSB_ISO_EP_ATT_EXPLICIT_FB  = 0x10,
+  TUSB_ISO_EP_ATT_IMPLICIT_FB  = 0x20,
+};
+
+typedef enum {
+  TUSB_REQ_SET_INTERFACE = 0x0B,
+} tusb_request_code_t;
+
+typedef enum {
+  TUSB_REQ_TYPE_STANDARD = 0,
+  TUSB_REQ_TYPE_CLASS,
+  TUSB_REQ_TYPE_VENDOR,
+} tusb_request_type_t;
+
+typedef enum {
+  TUSB_REQ_RCPT_DEVICE = 0,
+  TUSB_REQ_RCPT_INTERFACE,
+  TUSB_REQ_RCPT_ENDPOINT,
+} tusb_request_recipient_t;
+
+typedef enum {
+  TUSB_DIR_OUT = 0,
+  TUSB_DIR_IN  = 1,
+} tusb_dir_t;
+
+enum {
+  TUSB_CLASS_AUDIO = 1,
+  TUSB_CLASS_MISC  = 0xEF,
+};
+enum { MISC_SUBCLASS_COMMON = 2 };
+enum { MISC_PROTOCOL_IAD = 1 };
+
+typedef enum {
+  CONTROL_STAGE_IDLE = 0,
+  CONTROL_STAGE_SETUP,
+  CONTROL_STAGE_DATA,
+  CONTROL_STAGE_ACK
+} tusb_control_stage_t;
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t  bLength;
+  uint8_t  bDescriptorType;
+  uint16_t bcdUSB;
+  uint8_t  bDeviceClass;
+  uint8_t  bDeviceSubClass;
+  uint8_t  bDeviceProtocol;
+  uint8_t  bMaxPacketSize0;
+  uint16_t idVendor;
+  uint16_t idProduct;
+  uint16_t bcdDevice;
+  uint8_t  iManufacturer;
+  uint8_t  iProduct;
+  uint8_t  iSerialNumber;
+  uint8_t  bNumConfigurations;
+} tusb_desc_device_t;
+
+typedef struct TU_ATTR_PACKED {
+  union {
+    struct TU_ATTR_PACKED {
+      uint8_t recipient :  5;
+      uint8_t type      :  2;
+      uint8_t direction :  1;
+    } bmRequestType_bit;
+    uint8_t bmRequestType;
+  };
+  uint8_t  bRequest;
+  uint16_t wValue;
+  uint16_t wIndex;
+  uint16_t wLength;
+} tusb_control_request_t;
+
+//--------------------------------------------------------------------+
+// UAC2 常量（class/audio/audio.h）
+//--------------------------------------------------------------------+
+enum { AUDIO_FUNCTION_SUBCLASS_UNDEFINED = 0x00 };
+enum { AUDIO_SUBCLASS_CONTROL = 0x01, AUDIO_SUBCLASS_STREAMING = 0x02 };
+enum { AUDIO_INT_PROTOCOL_CODE_V2 = 0x20, AUDIO_FUNC_PROTOCOL_CODE_V2 = 0x20 };
+
+typedef enum {
+  AUDIO_CS_AC_INTERFACE_HEADER          = 0x01,
+  AUDIO_CS_AC_INTERFACE_INPUT_TERMINAL  = 0x02,
+  AUDIO_CS_AC_INTERFACE_OUTPUT_TERMINAL = 0x03,
+  AUDIO_CS_AC_INTERFACE_FEATURE_UNIT    = 0x06,
+  AUDIO_CS_AC_INTERFACE_CLOCK_SOURCE    = 0x0A,
+} audio_cs_ac_interface_subtype_t;
+
+typedef enum {
+  AUDIO_CS_AS_INTERFACE_AS_GENERAL  = 0x01,
+  AUDIO_CS_AS_INTERFACE_FORMAT_TYPE = 0x02,
+} audio_cs_as_interface_subtype_t;
+
+enum { AUDIO_CS_EP_SUBTYPE_GENERAL = 0x01 };
+
+typedef enum {
+  AUDIO_FUNC_MICROPHONE = 0x03,
+} audio_function_category_t;
+
+enum {
+  AUDIO_TERM_TYPE_USB_STREAMING = 0x0101,
+  AUDIO_TERM_TYPE_IN_GENERIC_MIC = 0x0201,
+};
+
+enum {
+  AUDIO_CTRL_NONE = 0x00,
+  AUDIO_CTRL_R    = 0x01,
+  AUDIO_CTRL_RW   = 0x03,
+};
+
+enum { AUDIO_CS_AS_INTERFACE_CTRL_LATENCY_POS = 0 };
+
+typedef enum {
+  AUDIO_CLOCK_SOURCE_ATT_EXT_CLK     = 0x00,
+  AUDIO_CLOCK_SOURCE_ATT_INT_FIX_CLK = 0x01,
+  AUDIO_CLOCK_SOURCE_ATT_INT_VAR_CLK = 0x02,
+  AUDIO_CLOCK_SOURCE_ATT_INT_PRO_CLK = 0x03,
+  AUDIO_CLOCK_SOURCE_ATT_CLK_SYC_SOF = 0x04,
+} audio_clock_source_attribute_t;
+
+enum {
+  AUDIO_CLOCK_SOURCE_CTRL_CLK_FRQ_POS = 0,
+  AUDIO_CLOCK_SOURCE_CTRL_CLK_VAL_POS = 2,
+};
+
+enum {
+  AUDIO_IN_TERM_CTRL_CPY_PROT_POS = 0,
+  AUDIO_IN_TERM_CTRL_CONNECTOR_POS = 2,
+  AUDIO_IN_TERM_CTRL_OVERLOAD_POS = 4,
+};
+
+enum {
+  AUDIO_FEATURE_UNIT_CTRL_MUTE_POS   = 0,
+  AUDIO_FEATURE_UNIT_CTRL_VOLUME_POS = 2,
+  AUDIO_FEATURE_UNIT_CTRL_AGC_POS    = 12,
+};
+
+typedef enum {
+  AUDIO_CS_REQ_UNDEFINED = 0x00,
+  AUDIO_CS_REQ_CUR       = 0x01,
+  AUDIO_CS_REQ_RANGE     = 0x02,
+  AUDIO_CS_REQ_MEM       = 0x03,
+} audio_cs_req_t;
+
+typedef enum {
+  AUDIO_CS_CTRL_UNDEF     = 0x00,
+  AUDIO_CS_CTRL_SAM_FREQ  = 0x01,
+  AUDIO_CS_CTRL_CLK_VALID = 0x02,
+} audio_clock_src_control_selector_t;
+
+typedef enum {
+  AUDIO_TE_CTRL_UNDEF     = 0x00,
+  AUDIO_TE_CTRL_COPY_PROT = 0x01,
+  AUDIO_TE_CTRL_CONNECTOR = 0x02,
+  AUDIO_TE_CTRL_OVERLOAD  = 0x03,
+  AUDIO_TE_CTRL_CLUSTER   = 0x04,
+  AUDIO_TE_CTRL_UNDERFLOW = 0x05,
+  AUDIO_TE_CTRL_OVERFLOW  = 0x06,
+  AUDIO_TE_CTRL_LATENCY   = 0x07,
+} audio_terminal_control_selector_t;
+
+typedef enum {
+  AUDIO_FU_CTRL_UNDEF      = 0x00,
+  AUDIO_FU_CTRL_MUTE       = 0x01,
+  AUDIO_FU_CTRL_VOLUME     = 0x02,
+  AUDIO_FU_CTRL_AGC        = 0x07,
+  AUDIO_FU_CTRL_LATENCY    = 0x10,
+} audio_feature_unit_control_selector_t;
+
+// 中断端点状态消息（UAC2 6.1）：bInfo D0 = 0 类特定，D1 = 0 接口 / 1 端点；bAttribute = 变化的请求（CUR/RANGE/MEM）
+typedef struct TU_ATTR_PACKED {
+  uint8_t  bInfo;
+  uint8_t  bAttribute;
+  uint16_t wValue;      // CS << 8 | CN
+  uint16_t wIndex;      // 实体 ID << 8 | 接口号
+} audio_interrupt_data_t;
+
+typedef enum {
+  AUDIO_FORMAT_TYPE_UNDEFINED = 0x00,
+  AUDIO_FORMAT_TYPE_I         = 0x01,
+} audio_format_type_t;
+
+typedef enum {
+  AUDIO_DATA_FORMAT_TYPE_I_PCM        = (uint32_t) (1 << 0),
+  AUDIO_DATA_FORMAT_TYPE_I_PCM8       = (uint32_t) (1 << 1),
+  AUDIO_DATA_FORMAT_TYPE_I_IEEE_FLOAT = (uint32_t) (1 << 2),
+} audio_data_format_type_I_t;
+
+typedef enum {
+  AUDIO_CHANNEL_CONFIG_NON_PREDEFINED = 0x00000000,
+  AUDIO_CHANNEL_CONFIG_FRONT_LEFT     = 0x00000001,
+  AUDIO_CHANNEL_CONFIG_FRONT_RIGHT    = 0x00000002,
+} audio_channel_config_t;
+
+enum {
+  AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK = 0x80,
+};
+enum {
+  AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED = 0x00,
+};
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t                bNrChannels;
+  audio_channel_config_t bmChannelConfig;
+  uint8_t                iChannelNames;
+} audio_desc_channel_cluster_t;
+
+//--------------------------------------------------------------------+
+// 描述符模板（device/usbd.h + class/audio 描述符宏）
+//--------------------------------------------------------------------+
+#define TUD_CONFIG_DESC_LEN   (9)
+#define TUD_CONFIG_DESCRIPTOR(config_num, _itfcount, _stridx, _total_len, _attribute, _power_ma) \
+  9, TUSB_DESC_CONFIGURATION, U16_TO_U8S_LE(_total_len), _itfcount, config_num, _stridx, TU_BIT(7) | _attribute, (_power_ma)/2
+
+#define TUD_AUDIO_DESC_IAD_LEN 8
+#define TUD_AUDIO_DESC_IAD(_firstitf, _nitfs, _stridx) \
+  TUD_AUDIO_DESC_IAD_LEN, TUSB_DESC_INTERFACE_ASSOCIATION, _firstitf, _nitfs, TUSB_CLASS_AUDIO, AUDIO_FUNCTION_SUBCLASS_UNDEFINED, AUDIO_FUNC_PROTOCOL_CODE_V2, _stridx
+
+#define TUD_AUDIO_DESC_STD_AC_LEN 9
+#define TUD_AUDIO_DESC_STD_AC(_itfnum, _nEPs, _stridx) \
+  TUD_AUDIO_DESC_STD_AC_LEN, TUSB_DESC_INTERFACE, _itfnum, /* fixed to zero */ 0x00, _nEPs, TUSB_CLASS_AUDIO, AUDIO_SUBCLASS_CONTROL, AUDIO_INT_PROTOCOL_CODE_V2, _stridx
+
+#define TUD_AUDIO_DESC_CS_AC_LEN 9
+#define TUD_AUDIO_DESC_CS_AC(_bcdADC, _category, _totallen, _ctrl) \
+  TUD_AUDIO_DESC_CS_AC_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_HEADER, U16_TO_U8S_LE(_bcdADC), _category, U16_TO_U8S_LE(_totallen + TUD_AUDIO_DESC_CS_AC_LEN), _ctrl
+
+#define TUD_AUDIO_DESC_STD_AC_INT_EP_LEN 7
+#define TUD_AUDIO_DESC_STD_AC_INT_EP(_ep, _interval) \
+  TUD_AUDIO_DESC_STD_AC_INT_EP_LEN, TUSB_DESC_ENDPOINT, _ep, TUSB_XFER_INTERRUPT, U16_TO_U8S_LE(6), _interval
+
+#define TUD_AUDIO_DESC_CLK_SRC_LEN 8
+#define TUD_AUDIO_DESC_CLK_SRC(_clkid, _attr, _ctrl, _assocTerm, _stridx) \
+  TUD_AUDIO_DESC_CLK_SRC_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_CLOCK_SOURCE, _clkid, _attr, _ctrl, _assocTerm, _stridx
+
+#define TUD_AUDIO_DESC_INPUT_TERM_LEN 17
+#define TUD_AUDIO_DESC_INPUT_TERM(_termid, _termtype, _assocTerm, _clkid, _nchannelslogical, _channelcfg, _idxchannelnames, _ctrl, _stridx) \
+  TUD_AUDIO_DESC_INPUT_TERM_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_INPUT_TERMINAL, _termid, U16_TO_U8S_LE(_termtype), _assocTerm, _clkid, _nchannelslogical, U32_TO_U8S_LE(_channelcfg), _idxchannelnames, U16_TO_U8S_LE(_ctrl), _stridx
+
+#define TUD_AUDIO_DESC_OUTPUT_TERM_LEN 12
+#define TUD_AUDIO_DESC_OUTPUT_TERM(_termid, _termtype, _assocTerm, _srcid, _clkid, _ctrl, _stridx) \
+  TUD_AUDIO_DESC_OUTPUT_TERM_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_OUTPUT_TERMINAL, _termid, U16_TO_U8S_LE(_termtype), _assocTerm, _srcid, _clkid, U16_TO_U8S_LE(_ctrl), _stridx
+
+#define TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN (6+(1+1)*4)
+#define TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL(_unitid, _srcid, _ctrlch0master, _ctrlch1, _stridx) \
+  TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_FEATURE_UNIT, _unitid, _srcid, U32_TO_U8S_LE(_ctrlch0master), U32_TO_U8S_LE(_ctrlch1), _stridx
+
+#define TUD_AUDIO_DESC_STD_AS_INT_LEN 9
+#define TUD_AUDIO_DESC_STD_AS_INT(_itfnum, _altset, _nEPs, _stridx) \
+  TUD_AUDIO_DESC_STD_AS_INT_LEN, TUSB_DESC_INTERFACE, _itfnum, _altset, _nEPs, TUSB_CLASS_AUDIO, AUDIO_SUBCLASS_STREAMING, AUDIO_INT_PROTOCOL_CODE_V2, _stridx
+
+#define TUD_AUDIO_DESC_CS_AS_INT_LEN 16
+#define TUD_AUDIO_DESC_CS_AS_INT(_termid, _ctrl, _formattype, _formats, _nchannelsphysical, _channelcfg, _stridx) \
+  TUD_AUDIO_DESC_CS_AS_INT_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AS_INTERFACE_AS_GENERAL, _termid, _ctrl, _formattype, U32_TO_U8S_LE(_formats), _nchannelsphysical, U32_TO_U8S_LE(_channelcfg), _stridx
+
+#define TUD_AUDIO_DESC_TYPE_I_FORMAT_LEN 6
+#define TUD_AUDIO_DESC_TYPE_I_FORMAT(_subslotsize, _bitresolution) \
+  TUD_AUDIO_DESC_TYPE_I_FORMAT_LEN, TUSB_DESC_CS_INTERFACE, AUDIO_CS_AS_INTERFACE_FORMAT_TYPE, AUDIO_FORMAT_TYPE_I, _subslotsize, _bitresolution
+
+#define TUD_AUDIO_DESC_STD_AS_ISO_EP_LEN 7
+#define TUD_AUDIO_DESC_STD_AS_ISO_EP(_ep, _attr, _maxEPsize, _interval) \
+  TUD_AUDIO_DESC_STD_AS_ISO_EP_LEN, TUSB_DESC_ENDPOINT, _ep, _attr, U16_TO_U8S_LE(_maxEPsize), _interval
+
+#define TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN 8
+#define TUD_AUDIO_DESC_CS_AS_ISO_EP(_attr, _ctrl, _lockdelayunit, _lockdelay) \
+  TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN, TUSB_DESC_CS_ENDPOINT, AUDIO_CS_EP_SUBTYPE_GENERAL, _attr, _ctrl, _lockdelayunit, U16_TO_U8S_LE(_lockdelay)
+
+#define TUD_AUDIO_MIC_ONE_CH_DESC_LEN (TUD_AUDIO_DESC_IAD_LEN\
+  + TUD_AUDIO_DESC_STD_AC_LEN\
+  + TUD_AUDIO_DESC_CS_AC_LEN\
+  + TUD_AUDIO_DESC_CLK_SRC_LEN\
+  + TUD_AUDIO_DESC_INPUT_TERM_LEN\
+  + TUD_AUDIO_DESC_OUTPUT_TERM_LEN\
+  + TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN\
+  + TUD_AUDIO_DESC_STD_AS_INT_LEN\
+  + TUD_AUDIO_DESC_STD_AS_INT_LEN\
+  + TUD_AUDIO_DESC_CS_AS_INT_LEN\
+  + TUD_AUDIO_DESC_TYPE_I_FORMAT_LEN\
+  + TUD_AUDIO_DESC_STD_AS_ISO_EP_LEN\
+  + TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN)
+
+#define TUD_AUDIO_EP_SIZE(_maxFrequency, _nBytesPerSample, _nChannels) \
+  ((((_maxFrequency + (TUD_OPT_HIGH_SPEED ? 7999 : 999)) / (TUD_OPT_HIGH_SPEED ? 8000 : 1000)) + 1) * _nBytesPerSample * _nChannels)
+
+//--------------------------------------------------------------------+
+// API（由 tusb_sim.c 实现）
+//--------------------------------------------------------------------+
+bool     tusb_init(void);
+void     tud_task(void);
+bool     tud_task_event_ready(void);
+bool     tud_mounted(void);
+bool     tud_audio_buffer_and_schedule_control_xfer(uint8_t rhport, tusb_control_request_t const * p_request, void* data, uint16_t len);
+// 多功能（CFG_TUD_AUDIO > 1）用 _n 版本按 func_id 指定功能；不带 _n 的是功能 0 的内联包装（与 audio_device.h 一致）
+uint16_t tud_audio_n_write(uint8_t func_id, const void* data, uint16_t len);
+bool     tud_audio_n_clear_ep_in_ff(uint8_t func_id);
+uint16_t tud_audio_n_available(uint8_t func_id);
+bool     tud_audio_int_n_write(uint8_t func_id, const audio_interrupt_data_t* data);   // CFG_TUD_AUDIO_ENABLE_INTERRUPT_EP
+bool     tud_control_xfer(uint8_t rhport, tusb_control_request_t const * request, void* buffer, uint16_t len);
+bool     tud_control_status(uint8_t rhport, tusb_control_request_t const * request);
+static inline uint16_t tud_audio_write(const void* data, uint16_t len)       { return tud_audio_n_write(0, data, len); }
+static inline bool     tud_audio_clear_ep_in_ff(void)                        { return tud_audio_n_clear_ep_in_ff(0); }
+static inline uint16_t tud_audio_available(void)                             { return tud_audio_n_available(0); }
+static inline bool     tud_audio_int_write(const audio_interrupt_data_t* data) { return tud_audio_int_n_write(0, data); }
+
+// tu_fifo：只提供 EP IN FIFO 零拷贝写需要的部分（与 TinyUSB tusb_fifo.h 同名同义）
+typedef struct tu_fifo_t tu_fifo_t;
+typedef struct {
+  uint16_t len_lin;     // 线性可写区长度
+  uint16_t len_wrap;    // 回绕后可写区长度
+  void*    ptr_lin;
+  void*    ptr_wrap;
+} tu_fifo_buffer_info_t;
+void       tu_fifo_get_write_info(tu_fifo_t* f, tu_fifo_buffer_info_t* info);
+uint16_t   tu_fifo_count(tu_fifo_t* f);
+uint16_t   tu_fifo_remaining(tu_fifo_t* f);
+bool       tu_fifo_clear(tu_fifo_t* f);
+bool       tu_fifo_config(tu_fifo_t* f, void* buffer, uint16_t depth, uint16_t item_size, bool overwritable);
+void       tu_fifo_advance_write_pointer(tu_fifo_t* f, uint16_t n);
+tu_fifo_t* tud_audio_n_get_ep_in_ff(uint8_t func_id);
+static inline tu_fifo_t* tud_audio_get_ep_in_ff(void) { return tud_audio_n_get_ep_in_ff(0); }
+
+// 应用侧回调（固件实现）
+uint8_t const*  tud_descriptor_device_cb(void);
+uint8_t const*  tud_descriptor_configuration_cb(uint8_t index);
+uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid);
+bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const * p_request);
+bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const * p_request, uint8_t *pBuff);
+bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const * p_request);
+bool tud_audio_set_itf_close_ep_cb(uint8_t rhport, tusb_control_request_t const * p_request);
+bool tud_audio_tx_done_isr(uint8_t rhport, uint16_t n_bytes_sent, uint8_t func_id, uint8_t ep_in, uint8_t cur_alt_setting);
+bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+void tud_mount_cb(void);
+void tud_umount_cb(void);
+void tud_suspend_cb(bool remote_wakeup_en);
+void tud_resume_cb(void);
+
+#endif
@@ -0,0 +1,595 @@
+#include <setjmp.h>
+#include "tusb_sim.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/usb.h"
+#include "bsp/board.h"
+#include "bench_util.h"
+
+#define SIM_FIFO_SZ   CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ
+#define SIM_RHPORT    0
+#define SIM_FUNCS     CFG_TUD_AUDIO            // 固件配置的音频功能数（每个虚拟麦克风一个）
+
+//--------------------------------------------------------------------+
+// 每个音频功能：EP IN 软件 FIFO（与 TinyUSB 一样不可覆盖写）、AS 状态、流控、中断端点
+//--------------------------------------------------------------------+
+// 零拷贝写：固件拿到 FIFO 里的可写区直接填数，再提交写指针
+struct tu_fifo_t { uint8_t func; };
+
+typedef struct {
+  uint8_t   ff[SIM_FIFO_SZ];
+  uint32_t  ff_rd, ff_count;
+  uint32_t  ff_depth;                       // 固件可经 tu_fifo_config 缩小（复用同一缓冲）
+  tu_fifo_t ff_handle;
+  uint8_t   ac_itf, as_itf, ep_in, int_ep;  // 从配置描述符解析
+  uint8_t   alt;
+  bool      ep_open;                        // AS 接口的 ISO IN 端点已打开（非零 Alt）
+  uint32_t  rate_tx;                        // 流控用采样率（SET_CUR/GET_CUR 截获）
+  uint16_t  pkt_sz[3];                      // 流控标称包长：短/中/长
+  int       ctrl_blackout;
+  uint8_t   pending[1024];                  // 已排队、下一帧发出的包
+  uint16_t  pending_len;
+  sim_frame_t cur;                          // 正在统计的帧
+  // AC 中断端点：固件写入的消息在下一个 SOF 被主机取走，之前端点忙
+  audio_interrupt_data_t int_msg, int_rx;
+  bool      int_busy;                       // 已写入、主机还没轮询
+  bool      int_ready;                      // 主机已收到、脚本还没读
+} sim_func_t;
+
+static sim_func_t s_fn[SIM_FUNCS];
+static uint8_t    s_nfuncs;                 // 描述符里实际出现的功能数
+
+static uint16_t ff_write(sim_func_t* fn, const uint8_t* src, uint16_t n) {
+  uint32_t space = fn->ff_depth - fn->ff_count;
+  if (n > space) n = (uint16_t)space;
+  // 与 tu_fifo_write_n 一样按线性区 + 回绕区两次 memcpy
+  uint32_t wr  = (fn->ff_rd + fn->ff_count) % fn->ff_depth;
+  uint32_t lin = fn->ff_depth - wr;
+  if (lin > n) lin = n;
+  memcpy(&fn->ff[wr], src, lin);
+  memcpy(fn->ff, src + lin, n - lin);
+  fn->ff_count += n;
+  return n;
+}
+
+static uint16_t ff_read(sim_func_t* fn, uint8_t* dst, uint16_t n) {
+  if (n > fn->ff_count) n = (uint16_t)fn->ff_count;
+  for (uint16_t i = 0; i < n; i++) dst[i] = fn->ff[(fn->ff_rd + i) % fn->ff_depth];
+  fn->ff_rd = (fn->ff_rd + n) % fn->ff_depth;
+  fn->ff_count -= n;
+  return n;
+}
+
+//--------------------------------------------------------------------+
+// 设备状态（实体 ID 与 Alt 参数各功能相同）
+//--------------------------------------------------------------------+
+static sim_alt_info_t s_alts[SIM_MAX_ALT];
+static uint8_t   s_clk_id, s_fu_id, s_it_id, s_ot_id;
+static uint32_t  s_frame;
+static bool      s_mounted;
+
+static sim_packet_fn s_pkt_hook;
+static void*         s_pkt_ctx;
+
+// 控制传输数据阶段
+static uint8_t   s_ctrl_buf[CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ];
+static uint16_t  s_ctrl_len;
+static sim_ctrl_stats_t s_ctrl_st;
+
+// core1 / 主循环调度
+static void    (*s_core1_entry)(void);
+static bool      s_sev_pending;
+static bool      s_in_core1;
+static jmp_buf   s_core1_jmp;
+static jmp_buf   s_exit_jmp;
+static sim_task_fn s_task;
+
+// core0 的 WFE：一帧的工作做完后时间停在帧内，直到 core0 睡过去（WFE）或主循环再空转一次（忙等），才走到下一帧
+static bool      s_ev0;                     // core0 事件寄存器（任一核 SEV 置位）
+static bool      s_frame_done;              // 本帧的传输已完成，还没走到下一帧
+static bool      s_quiet;                   // 帧完成后主循环已经空转过一次 tud_task
+static bool      s_asleep, s_woken;         // core0 在 WFE 里；主机有动作要它醒来处理
+static bool      s_irq_frame;               // 本帧的传输是在 WFE 里（中断）跑的，主循环还没处理过
+static bool      s_suspended;               // 总线挂起：没有 SOF，也没有任何传输
+
+//--------------------------------------------------------------------+
+// pico / bsp 替身
+//--------------------------------------------------------------------+
+void multicore_launch_core1(void (*entry)(void)) {
+  s_core1_entry = entry;
+  s_sev_pending = true;                     // core1 启动后先跑到第一次 WFE
+}
+
+void __sev(void) {
+  s_sev_pending = true;
+  s_ev0 = true;                             // SEV 也置位执行它的核自己的事件寄存器
+}
+
+uint32_t board_millis(void) { return s_frame; }
+static uint32_t s_spin_us;                  // 本帧内 core0 自旋推进的仿真时间
+
+static void next_frame(void) {
+  s_frame++;
+  s_irq_frame = false;
+  s_spin_us = 0;
+  s_frame_done = false;
+  s_quiet = false;
+}
+
+// 下一帧设备不会有任何完成中断：没有在流的 AS 接口、没有待取的状态消息，或者总线挂起
+static bool bus_quiet(void);
+
+void __wfe(void) {
+  if (s_in_core1) longjmp(s_core1_jmp, 1);  // core1 无事可做：交还控制权
+  if (s_ev0) { s_ev0 = false; return; }     // 事件寄存器已置位：立即返回
+  if (!s_frame_done) return;                // 不在帧尾：下一个事件就是主机此刻的动作
+  // 睡到下一帧的完成中断；没有中断的帧（停流、挂起）一直睡下去，直到主机有动作（sim_wake）
+  s_asleep = true;
+  s_woken  = false;
+  next_frame();
+  while (bus_quiet() && !s_woken) {
+    if (!s_task || !s_task()) { s_asleep = false; longjmp(s_exit_jmp, 1); }
+    if (s_frame_done) next_frame();
+  }
+  // 真机上叫醒 core0 的完成中断在 WFE 返回之前就处理完了：这一帧的传输也在这里跑
+  // （主机有控制动作要处理时，脚本只会叫醒 core0，不会在这里执行它）
+  if (!s_woken && !s_frame_done) {
+    if (!s_task || !s_task()) { s_asleep = false; longjmp(s_exit_jmp, 1); }
+    s_irq_frame = s_frame_done;
+  }
+  s_asleep = false;
+}
+uint32_t time_us_32(void)   { return s_frame * 1000u + s_spin_us; }
+unsigned get_core_num(void) { return s_in_core1 ? 1u : 0u; }
+
+systick_hw_t* sim_systick(void) {
+  static systick_hw_t st;
+  st.cvr = 0x00FFFFFFu - (uint32_t)(bench_cycles() & 0x00FFFFFFu);
+  return &st;
+}
+
+usb_hw_t* sim_usb_hw(void) {
+  static usb_hw_t usb;
+  usb.sof_rd = s_frame & USB_SOF_RD_BITS;
+  return &usb;
+}
+
+static void run_core1(void) {
+  if (!s_core1_entry || !s_sev_pending || s_in_core1) return;
+  s_sev_pending = false;
+  s_in_core1 = true;
+  if (setjmp(s_core1_jmp) == 0) s_core1_entry();
+  s_in_core1 = false;
+}
+
+void tight_loop_contents(void) {
+  run_core1();
+  if (s_spin_us < 999) s_spin_us++;
+}
+
+//--------------------------------------------------------------------+
+// TinyUSB API 替身
+//--------------------------------------------------------------------+
+bool tusb_init(void) { return true; }
+bool tud_mounted(void) { return s_mounted; }
+
+// 仿真器每次 tud_task() 只执行一个动作，之后总是“空闲”
+bool tud_task_event_ready(void) { return false; }
+
+void tud_task(void) {
+  if (s_frame_done) {                       // 帧尾：第一次调用没有事件（主机侧时间不动），再调用才走到下一帧
+    if (s_irq_frame) { s_irq_frame = false; run_core1(); return; }   // WFE 醒来后的这一次相当于处理中断排的事件
+    if (!s_quiet) { s_quiet = true; return; }
+    next_frame();
+  }
+  run_core1();
+  if (!s_task || !s_task()) longjmp(s_exit_jmp, 1);
+  run_core1();
+}
+
+static inline sim_func_t* fn_of(tu_fifo_t* f) { return &s_fn[f->func]; }
+
+uint16_t tud_audio_n_write(uint8_t func_id, const void* data, uint16_t len) {
+  sim_func_t* fn = &s_fn[func_id];
+  uint16_t n = ff_write(fn, (const uint8_t*)data, len);
+  fn->cur.written += n;
+  fn->cur.copied  += n;
+  fn->cur.write_calls++;
+  return n;
+}
+
+tu_fifo_t* tud_audio_n_get_ep_in_ff(uint8_t func_id) { return &s_fn[func_id].ff_handle; }
+
+uint16_t tu_fifo_count(tu_fifo_t* f)     { return (uint16_t)fn_of(f)->ff_count; }
+uint16_t tu_fifo_remaining(tu_fifo_t* f) { return (uint16_t)(fn_of(f)->ff_depth - fn_of(f)->ff_count); }
+bool     tu_fifo_clear(tu_fifo_t* f)     { fn_of(f)->ff_rd = fn_of(f)->ff_count = 0; return true; }
+
+bool tu_fifo_config(tu_fifo_t* f, void* buffer, uint16_t depth, uint16_t item_size, bool overwritable) {
+  (void)overwritable;
+  sim_func_t* fn = fn_of(f);
+  if (buffer != fn->ff || item_size != 1 || depth == 0 || depth > SIM_FIFO_SZ) return false;
+  fn->ff_depth = depth;
+  fn->ff_rd = fn->ff_count = 0;
+  return true;
+}
+
+void tu_fifo_get_write_info(tu_fifo_t* f, tu_fifo_buffer_info_t* info) {
+  sim_func_t* fn = fn_of(f);
+  uint32_t wr   = (fn->ff_rd + fn->ff_count) % fn->ff_depth;
+  uint32_t free = fn->ff_depth - fn->ff_count;
+  uint32_t lin  = fn->ff_depth - wr;
+  if (lin > free) lin = free;
+  info->len_lin  = (uint16_t)lin;
+  info->len_wrap = (uint16_t)(free - lin);
+  info->ptr_lin  = &fn->ff[wr];
+  info->ptr_wrap = fn->ff;
+}
+
+void tu_fifo_advance_write_pointer(tu_fifo_t* f, uint16_t n) {
+  sim_func_t* fn = fn_of(f);
+  if (n > fn->ff_depth - fn->ff_count) n = (uint16_t)(fn->ff_depth - fn->ff_count);
+  fn->ff_count += n;
+  fn->cur.written += n;
+}
+
+bool tud_audio_n_clear_ep_in_ff(uint8_t func_id) {
+  s_fn[func_id].ff_rd = s_fn[func_id].ff_count = 0;
+  return true;
+}
+
+uint16_t tud_audio_n_available(uint8_t func_id) { return (uint16_t)s_fn[func_id].ff_count; }
+
+bool tud_audio_int_n_write(uint8_t func_id, const audio_interrupt_data_t* data) {
+  sim_func_t* fn = &s_fn[func_id];
+  if (func_id >= s_nfuncs || !fn->int_ep || fn->int_busy) return false;
+  fn->int_msg  = *data;
+  fn->int_busy = true;
+  s_ctrl_st.int_msgs++;
+  return true;
+}
+
+// TinyUSB 在流控开启时会截获时钟源 SAM_FREQ 的 CUR 值并重算标称包长
+static void calc_tx_packet_sz(sim_func_t* fn);
+
+// 实体请求的 wIndex 低字节是 AC 接口号：找出它属于哪个功能
+static sim_func_t* fn_by_ac_itf(uint8_t itf) {
+  for (uint8_t f = 0; f < s_nfuncs; f++) if (s_fn[f].ac_itf == itf) return &s_fn[f];
+  return NULL;
+}
+
+// 与 usbd_control.c 一样直接从调用方的缓冲发数据（不经音频类的控制缓冲），所以缓冲须在数据阶段结束前有效
+static const void* s_xfer_buf;
+static uint16_t    s_xfer_len;
+
+bool tud_control_xfer(uint8_t rhport, tusb_control_request_t const * request, void* buffer, uint16_t len) {
+  (void)rhport;
+  s_xfer_buf = buffer;
+  s_xfer_len = len < request->wLength ? len : request->wLength;
+  return true;
+}
+
+bool tud_control_status(uint8_t rhport, tusb_control_request_t const * request) {
+  (void)rhport; (void)request;
+  s_xfer_buf = NULL;
+  s_xfer_len = 0;
+  return true;
+}
+
+bool tud_audio_buffer_and_schedule_control_xfer(uint8_t rhport, tusb_control_request_t const * p_request, void* data, uint16_t len) {
+  (void)rhport;
+  if (len > p_request->wLength) len = p_request->wLength;
+  if (len > sizeof(s_ctrl_buf)) len = sizeof(s_ctrl_buf);
+  memcpy(s_ctrl_buf, data, len);
+  s_ctrl_len = len;
+  sim_func_t* fn = fn_by_ac_itf(TU_U16_LOW(p_request->wIndex));
+  if (fn && TU_U16_HIGH(p_request->wIndex) == s_clk_id && TU_U16_HIGH(p_request->wValue) == AUDIO_CS_CTRL_SAM_FREQ
+      && p_request->bRequest == AUDIO_CS_REQ_CUR && len >= 4) {
+    memcpy(&fn->rate_tx, data, 4);
+    calc_tx_packet_sz(fn);
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// 流控模型（与 TinyUSB audio_device.c 的 audiod_calc_tx_packet_sz / audiod_tx_packet_size 一致）
+//--------------------------------------------------------------------+
+static void calc_tx_packet_sz(sim_func_t* fn) {
+  memset(fn->pkt_sz, 0, sizeof(fn->pkt_sz));
+  if (fn->alt == 0 || fn->alt >= SIM_MAX_ALT || !fn->rate_tx) return;
+  const sim_alt_info_t* a = &s_alts[fn->alt];
+  uint16_t frame_bytes = (uint16_t)(a->bytes_per_sample * a->channels);
+  uint16_t nominal = (uint16_t)(fn->rate_tx / 1000);
+  uint16_t rem     = (uint16_t)(fn->rate_tx % 1000);
+  uint16_t sz_min  = (uint16_t)((nominal - 1) * frame_bytes);
+  uint16_t sz_norm = (uint16_t)(nominal * frame_bytes);
+  uint16_t sz_max  = (uint16_t)((nominal + 1) * frame_bytes);
+  if (sz_max > a->ep_size) {
+    printf("[SIM ] flow control: max packet %u > EP size %u\n", sz_max, a->ep_size);
+    return;
+  }
+  if (rem) { fn->pkt_sz[0] = sz_norm; fn->pkt_sz[1] = sz_norm; fn->pkt_sz[2] = sz_max; }
+  else     { fn->pkt_sz[0] = sz_min;  fn->pkt_sz[1] = sz_norm; fn->pkt_sz[2] = sz_max; }
+}
+
+static uint16_t tx_packet_size(sim_func_t* fn, uint16_t data_count, uint16_t fifo_depth, uint16_t max_depth) {
+  const uint16_t* sz = fn->pkt_sz;
+  if (sz[1] && sz[1] <= fifo_depth * 4) {
+    uint16_t packet_size;
+    uint16_t slot_size = (uint16_t)(sz[2] - sz[1]);
+    if (data_count < sz[0]) {
+      packet_size = 0;
+    } else if (data_count < fifo_depth / 2 - slot_size && !fn->ctrl_blackout) {
+      packet_size = sz[0];
+      fn->ctrl_blackout = 10;
+    } else if (data_count > fifo_depth / 2 + slot_size && !fn->ctrl_blackout) {
+      packet_size = sz[2];
+      fn->ctrl_blackout = (sz[0] == sz[1]) ? 0 : 10;
+    } else {
+      packet_size = sz[1];
+      if (fn->ctrl_blackout) fn->ctrl_blackout--;
+    }
+    return tu_min16(packet_size, max_depth);
+  }
+  return tu_min16(data_count, max_depth);
+}
+
+// audiod_tx_xfer_isr：按流控从 FIFO 取下一包排队，然后调用固件的 tx_done 回调
+static void tx_xfer_isr(uint8_t func, uint16_t n_bytes_sent) {
+  sim_func_t* fn = &s_fn[func];
+  uint16_t ep_sz = s_alts[fn->alt].ep_size;
+  uint16_t n = tx_packet_size(fn, (uint16_t)fn->ff_count, (uint16_t)fn->ff_depth, ep_sz);
+  fn->pending_len = ff_read(fn, fn->pending, n);
+
+  uint64_t t0 = bench_now_ns();
+  uint64_t c0 = bench_cycles();
+  tud_audio_tx_done_isr(SIM_RHPORT, n_bytes_sent, func, fn->ep_in, fn->alt);
+  fn->cur.isr_cycles = bench_cycles() - c0;
+  run_core1();
+  fn->cur.gen_ns += bench_now_ns() - t0;
+}
+
+//--------------------------------------------------------------------+
+// 描述符解析：每个 AC 接口开始一个新功能，紧随其后的 AS 接口属于它
+//--------------------------------------------------------------------+
+static bool parse_config(const uint8_t* p) {
+  uint16_t total = (uint16_t)(p[2] | (p[3] << 8));
+  uint8_t  cur_alt = 0, cur_sub = 0;
+  sim_func_t* fn = NULL;
+  memset(s_alts, 0, sizeof(s_alts));
+  s_nfuncs = 0;
+  for (uint16_t i = 0; i + 2 <= total; ) {
+    uint8_t len = p[i], type = p[i + 1];
+    if (len < 2 || i + len > total) { printf("[SIM ] bad descriptor at %u\n", i); return false; }
+    const uint8_t* d = p + i;
+    if (type == TUSB_DESC_INTERFACE) {
+      cur_alt = d[3]; cur_sub = d[6];
+      if (cur_sub == AUDIO_SUBCLASS_CONTROL) {
+        if (s_nfuncs >= SIM_FUNCS) { printf("[SIM ] more audio functions than CFG_TUD_AUDIO\n"); return false; }
+        fn = &s_fn[s_nfuncs++];
+        fn->ac_itf = d[2];
+        fn->as_itf = 0xFF;
+        fn->ep_in = fn->int_ep = 0;
+      }
+      if (cur_sub == AUDIO_SUBCLASS_STREAMING && fn) fn->as_itf = d[2];
+    } else if (type == TUSB_DESC_CS_INTERFACE && cur_sub == AUDIO_SUBCLASS_CONTROL) {
+      if (d[2] == AUDIO_CS_AC_INTERFACE_CLOCK_SOURCE)   s_clk_id = d[3];
+      if (d[2] == AUDIO_CS_AC_INTERFACE_FEATURE_UNIT)   s_fu_id = d[3];
+      if (d[2] == AUDIO_CS_AC_INTERFACE_INPUT_TERMINAL)  s_it_id = d[3];
+      if (d[2] == AUDIO_CS_AC_INTERFACE_OUTPUT_TERMINAL) s_ot_id = d[3];
+    } else if (type == TUSB_DESC_ENDPOINT && cur_sub == AUDIO_SUBCLASS_CONTROL && fn) {
+      if ((d[3] & 0x03) == TUSB_XFER_INTERRUPT && (d[2] & 0x80)) fn->int_ep = d[2];
+    } else if (type == TUSB_DESC_CS_INTERFACE && cur_sub == AUDIO_SUBCLASS_STREAMING && cur_alt < SIM_MAX_ALT) {
+      if (d[2] == AUDIO_CS_AS_INTERFACE_AS_GENERAL) {
+        s_alts[cur_alt].formats  = (uint32_t)(d[6] | (d[7] << 8) | (d[8] << 16) | ((uint32_t)d[9] << 24));
+        s_alts[cur_alt].channels = d[10];
+      }
+      if (d[2] == AUDIO_CS_AS_INTERFACE_FORMAT_TYPE) {
+        s_alts[cur_alt].bytes_per_sample = d[4];
+        s_alts[cur_alt].bits = d[5];
+      }
+    } else if (type == TUSB_DESC_ENDPOINT && cur_sub == AUDIO_SUBCLASS_STREAMING && fn && cur_alt < SIM_MAX_ALT) {
+      s_alts[cur_alt].ep_size = (uint16_t)(d[4] | (d[5] << 8));
+      fn->ep_in = d[2];
+    }
+    i = (uint16_t)(i + len);
+  }
+  return s_nfuncs > 0;
+}
+
+//--------------------------------------------------------------------+
+// 主机侧动作
+//--------------------------------------------------------------------+
+static tusb_control_request_t make_req(uint8_t dir_in, uint8_t type, uint8_t rcpt, uint8_t bRequest,
+                                       uint16_t wValue, uint16_t wIndex, uint16_t wLength) {
+  tusb_control_request_t r;
+  memset(&r, 0, sizeof(r));
+  r.bmRequestType_bit.direction = dir_in;
+  r.bmRequestType_bit.type      = type;
+  r.bmRequestType_bit.recipient = rcpt;
+  r.bRequest = bRequest;
+  r.wValue   = wValue;
+  r.wIndex   = wIndex;
+  r.wLength  = wLength;
+  return r;
+}
+
+bool sim_enumerate(void) {
+  const tusb_desc_device_t* dev = (const tusb_desc_device_t*)(const void*)tud_descriptor_device_cb();
+  if (!dev || dev->bDescriptorType != TUSB_DESC_DEVICE) return false;
+  const uint8_t* cfg = tud_descriptor_configuration_cb(0);
+  if (!cfg || !parse_config(cfg)) return false;
+  for (uint8_t i = 0; i <= 3; i++) tud_descriptor_string_cb(i, 0x0409);
+  s_mounted = true;
+  tud_mount_cb();
+  return true;
+}
+
+bool sim_set_interface(uint8_t itf, uint8_t alt) {
+  tusb_control_request_t r = make_req(TUSB_DIR_OUT, TUSB_REQ_TYPE_STANDARD, TUSB_REQ_RCPT_INTERFACE,
+                                      TUSB_REQ_SET_INTERFACE, alt, itf, 0);
+  uint8_t f = 0;
+  while (f < s_nfuncs && s_fn[f].as_itf != itf) f++;
+  if (f == s_nfuncs || alt >= SIM_MAX_ALT) return false;
+  sim_func_t* fn = &s_fn[f];
+  // 与 audiod_set_interface 顺序一致：关旧 EP（只有原来开着才回调）→ 开新 EP → 首次 tx_xfer_isr → set_itf_cb
+  if (fn->ep_open) {
+    tud_audio_set_itf_close_ep_cb(SIM_RHPORT, &r);
+    fn->ep_open = false;
+  }
+  fn->pending_len = 0;
+  fn->alt = alt;
+  calc_tx_packet_sz(fn);
+  if (alt != 0) {
+    fn->ep_open = true;
+    tx_xfer_isr(f, 0);
+  }
+  bool ok = tud_audio_set_itf_cb(SIM_RHPORT, &r);
+  run_core1();
+  return ok;
+}
+
+bool sim_control_set(uint8_t func, uint8_t entity, uint8_t sel, uint8_t ch, uint8_t req, const void* data, uint16_t len) {
+  if (func >= s_nfuncs) return false;
+  sim_func_t* fn = &s_fn[func];
+  tusb_control_request_t r = make_req(TUSB_DIR_OUT, TUSB_REQ_TYPE_CLASS, TUSB_REQ_RCPT_INTERFACE, req,
+                                      (uint16_t)((sel << 8) | ch), (uint16_t)((entity << 8) | fn->ac_itf), len);
+  uint8_t buf[CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ];
+  memcpy(buf, data, len);
+  uint64_t c0 = bench_cycles();
+  bool ok = tud_audio_set_req_entity_cb(SIM_RHPORT, &r, buf);
+  uint64_t c = bench_cycles() - c0;
+  s_ctrl_st.sets++;
+  s_ctrl_st.set_stalls += !ok;
+  s_ctrl_st.set_cyc_sum += c;
+  if (c > s_ctrl_st.set_cyc_max) s_ctrl_st.set_cyc_max = c;
+  if (ok && entity == s_clk_id && sel == AUDIO_CS_CTRL_SAM_FREQ && req == AUDIO_CS_REQ_CUR && len >= 4) {
+    memcpy(&fn->rate_tx, data, 4);
+    calc_tx_packet_sz(fn);
+  }
+  run_core1();
+  return ok;
+}
+
+bool sim_control_get(uint8_t func, uint8_t entity, uint8_t sel, uint8_t ch, uint8_t req, void* out, uint16_t* len) {
+  if (func >= s_nfuncs) return false;
+  tusb_control_request_t r = make_req(TUSB_DIR_IN, TUSB_REQ_TYPE_CLASS, TUSB_REQ_RCPT_INTERFACE, req,
+                                      (uint16_t)((sel << 8) | ch), (uint16_t)((entity << 8) | s_fn[func].ac_itf), *len);
+  s_ctrl_len = 0;
+  uint64_t c0 = bench_cycles();
+  bool ok = tud_audio_get_req_entity_cb(SIM_RHPORT, &r);
+  uint64_t c = bench_cycles() - c0;
+  s_ctrl_st.gets++;
+  s_ctrl_st.get_stalls += !ok;
+  s_ctrl_st.get_cyc_sum += c;
+  if (c > s_ctrl_st.get_cyc_max) s_ctrl_st.get_cyc_max = c;
+  if (ok) memcpy(out, s_ctrl_buf, s_ctrl_len);
+  *len = ok ? s_ctrl_len : 0;
+  return ok;
+}
+
+bool sim_vendor_control(uint8_t dir, uint8_t bRequest, uint16_t wValue, uint16_t wIndex, void* data, uint16_t* len) {
+  uint16_t want = len ? *len : 0;
+  tusb_control_request_t r = make_req(dir, TUSB_REQ_TYPE_VENDOR, TUSB_REQ_RCPT_DEVICE, bRequest, wValue, wIndex, want);
+  s_xfer_buf = NULL;
+  s_xfer_len = 0;
+  bool ok = tud_vendor_control_xfer_cb(SIM_RHPORT, CONTROL_STAGE_SETUP, &r);
+  if (dir == TUSB_DIR_IN && len) {
+    if (ok && data && s_xfer_buf) memcpy(data, s_xfer_buf, s_xfer_len);
+    *len = ok ? s_xfer_len : 0;
+  }
+  if (ok) tud_vendor_control_xfer_cb(SIM_RHPORT, CONTROL_STAGE_ACK, &r);
+  run_core1();
+  return ok;
+}
+
+// 一个 SOF：每个功能依次发出上一帧排队的包（完成中断里排下一包并回调固件），中断端点各被轮询一次
+void sim_frame(void) {
+  if (s_frame_done) next_frame();           // 没经过主循环的连续调用
+  s_frame_done = true;
+  if (s_suspended) return;                  // 挂起：没有 SOF，端点都不动
+  for (uint8_t f = 0; f < s_nfuncs; f++) {
+    sim_func_t* fn = &s_fn[f];
+    memset(&fn->cur, 0, sizeof(fn->cur));
+    fn->cur.frame = s_frame;
+    fn->cur.func  = f;
+    fn->cur.alt   = fn->alt;
+    fn->cur.rate  = fn->rate_tx;
+    if (fn->alt != 0) {
+      uint8_t  sent[sizeof(fn->pending)];
+      uint16_t sent_len = fn->pending_len;
+      memcpy(sent, fn->pending, sent_len);
+      fn->cur.pkt_bytes = sent_len;
+      tx_xfer_isr(f, sent_len);
+      fn->cur.fifo_level = (uint16_t)fn->ff_count;
+      if (s_pkt_hook) s_pkt_hook(&fn->cur, sent, s_pkt_ctx);
+    } else {
+      fn->cur.fifo_level = (uint16_t)fn->ff_count;
+      if (s_pkt_hook) s_pkt_hook(&fn->cur, NULL, s_pkt_ctx);
+    }
+    if (fn->int_busy) {
+      fn->int_rx    = fn->int_msg;
+      fn->int_ready = true;
+      fn->int_busy  = false;
+    }
+  }
+}
+
+static bool bus_quiet(void) {
+  if (s_suspended) return true;
+  for (uint8_t f = 0; f < s_nfuncs; f++)
+    if (s_fn[f].alt != 0 || s_fn[f].int_busy || s_fn[f].int_ready) return false;
+  return true;
+}
+
+void sim_suspend(void) {
+  if (s_suspended) return;
+  s_suspended = true;
+  tud_suspend_cb(false);
+  run_core1();
+}
+
+void sim_resume(void) {
+  if (!s_suspended) return;
+  s_suspended = false;
+  tud_resume_cb();
+  run_core1();
+}
+
+bool sim_core0_asleep(void) { return s_asleep; }
+void sim_wake(void)         { s_woken = true; }
+
+bool sim_int_read(uint8_t func, audio_interrupt_data_t* out) {
+  if (func >= s_nfuncs || !s_fn[func].int_ready) return false;
+  *out = s_fn[func].int_rx;
+  s_fn[func].int_ready = false;
+  return true;
+}
+
+void sim_set_packet_hook(sim_packet_fn fn, void* ctx) {
+  s_pkt_hook = fn;
+  s_pkt_ctx  = ctx;
+}
+
+void sim_run_firmware(int (*fw_main)(void), sim_task_fn task) {
+  for (uint8_t f = 0; f < SIM_FUNCS; f++) {
+    s_fn[f].ff_depth = SIM_FIFO_SZ;
+    s_fn[f].ff_handle.func = f;
+  }
+  s_task = task;
+  if (setjmp(s_exit_jmp) == 0) fw_main();
+  s_task = NULL;
+}
+
+uint32_t              sim_frame_number(void)     { return s_frame; }
+uint8_t               sim_func_count(void)       { return s_nfuncs; }
+uint8_t               sim_streaming_itf(uint8_t func) { return func < s_nfuncs ? s_fn[func].as_itf : 0xFF; }
+uint8_t               sim_cur_alt(uint8_t func)  { return func < s_nfuncs ? s_fn[func].alt : 0; }
+uint32_t              sim_flow_rate(uint8_t func) { return func < s_nfuncs ? s_fn[func].rate_tx : 0; }
+const sim_alt_info_t* sim_alt_info(uint8_t alt)  { return alt < SIM_MAX_ALT ? &s_alts[alt] : NULL; }
+uint8_t               sim_clock_id(void)         { return s_clk_id; }
+uint8_t               sim_feature_unit_id(void)  { return s_fu_id; }
+uint8_t               sim_input_terminal_id(void)  { return s_it_id; }
+uint8_t               sim_output_terminal_id(void) { return s_ot_id; }
+uint8_t               sim_int_ep(uint8_t func)   { return func < s_nfuncs ? s_fn[func].int_ep : 0; }
+const sim_ctrl_stats_t* sim_ctrl_stats(void)     { return &s_ctrl_st; }
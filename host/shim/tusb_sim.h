@@ -0,0 +1,94 @@
+#ifndef __TUSB_SIM_H__
+#define __TUSB_SIM_H__
+// ===== 主机仿真：TinyUSB 设备侧模型 =====
+// 模拟 1 ms SOF 帧时钟、EP IN 软件 FIFO、TinyUSB 的帧长流控（audiod_tx_packet_size）
+// 以及控制传输；固件回调原样被调用，core1 在每次 SEV 后同步运行到 WFE。
+// 每个音频功能（虚拟麦克风）有自己的 FIFO、Alt、流控和中断端点；func 参数即 TinyUSB 的 func_id。
+// core0 主循环的 WFE 也有模型：帧内的工作做完后，WFE 睡到下一帧的完成中断（时间走到下一帧起点），
+// 设备没有任何传输的帧（全部 Alt0、总线挂起）一直睡过去，直到主机有控制动作；忙等的主循环则在第二次
+// 空转的 tud_task() 里走到下一帧。两种主循环看到的帧时间线相同。
+#include <stdbool.h>
+#include <stdint.h>
+#include "tusb.h"
+
+#define SIM_MAX_ALT   8
+
+typedef struct {
+  uint32_t frame;          // SOF 帧号（1 ms）
+  uint8_t  func;           // 音频功能（每帧每个功能回调一次包钩子）
+  uint8_t  alt;            // 当前 AS Alt
+  uint32_t rate;           // 流控使用的采样率
+  uint16_t pkt_bytes;      // 本帧发到总线上的 ISO 包字节数
+  uint16_t written;        // 本帧固件写入 FIFO 的字节数（tud_audio_write + 零拷贝提交）
+  uint16_t copied;         // 其中经 tud_audio_write（暂存缓冲 → FIFO 拷贝）写入的字节数
+  uint16_t write_calls;    // 本帧 tud_audio_write 调用次数
+  uint16_t fifo_level;     // 本帧结束时 FIFO 字节数
+  uint64_t gen_ns;         // 本帧 ISR + core1 生产耗时（主机实测；core1 一轮会给所有欠数据的流补块）
+  uint64_t isr_cycles;     // 其中 tud_audio_tx_done_isr 本身的周期数
+} sim_frame_t;
+
+// 从配置描述符解析出的 AS Alt 参数
+typedef struct {
+  uint8_t  bytes_per_sample;
+  uint8_t  bits;
+  uint8_t  channels;
+  uint16_t ep_size;
+  uint32_t formats;
+} sim_alt_info_t;
+
+// 控制传输统计：实体请求回调（tud_audio_get/set_req_entity_cb）本身的主机周期数，及中断端点消息
+typedef struct {
+  uint32_t gets, sets;             // 请求数
+  uint32_t get_stalls, set_stalls; // 其中回调返回 false（stall）的个数
+  uint64_t get_cyc_sum, get_cyc_max;
+  uint64_t set_cyc_sum, set_cyc_max;
+  uint32_t int_msgs;               // 固件经 tud_audio_int_n_write 发出的状态消息数（所有功能）
+} sim_ctrl_stats_t;
+
+typedef void (*sim_packet_fn)(const sim_frame_t* f, const uint8_t* data, void* ctx);
+typedef bool (*sim_task_fn)(void);
+
+// 运行固件 main()：固件每次调用 tud_task() 都会回调 task；task 返回 false 时结束并返回这里
+void     sim_run_firmware(int (*fw_main)(void), sim_task_fn task);
+
+void     sim_set_packet_hook(sim_packet_fn fn, void* ctx);
+
+// 主机侧动作（都会按 TinyUSB 的顺序调用固件回调）
+bool     sim_enumerate(void);
+bool     sim_set_interface(uint8_t itf, uint8_t alt);
+// 实体请求发给功能 func 的 AC 接口（wIndex = 实体 << 8 | 该功能的 AC 接口号）
+bool     sim_control_set(uint8_t func, uint8_t entity, uint8_t sel, uint8_t ch, uint8_t req, const void* data, uint16_t len);
+bool     sim_control_get(uint8_t func, uint8_t entity, uint8_t sel, uint8_t ch, uint8_t req, void* out, uint16_t* len);
+// 厂商请求（Vendor | Device）：dir = TUSB_DIR_IN 时读回数据到 data，*len 为期望/实际长度
+bool     sim_vendor_control(uint8_t dir, uint8_t bRequest, uint16_t wValue, uint16_t wIndex, void* data, uint16_t* len);
+// flash 录音镜像：mmap 文件代替 XIP 窗口（须在 sim_run_firmware 之前调用；flash_image_sim.c）
+bool     sim_flash_image_load(const char* path);
+// PDM 麦克风：循环播放的 1-bit 位流文件代替 PIO + DMA（须在 sim_run_firmware 之前调用；pdm_capture_sim.c）
+bool     sim_pdm_load(const char* path);
+// PDM 时钟相对标称值的偏差（ppm），用来检验漂移校正
+void     sim_pdm_set_ppm(int32_t ppm);
+void     sim_frame(void);
+// 总线挂起 / 恢复：调用 tud_suspend_cb / tud_resume_cb；挂起期间 sim_frame 只推进时间（没有 SOF、传输和包钩子）
+void     sim_suspend(void);
+void     sim_resume(void);
+// task 回调里：core0 正在 WFE 里睡过没有传输的帧。此时主机的控制动作要先 sim_wake() 并返回，
+// 下一次（从 tud_task 里）回调时再执行，固件回调才在 tud_task 上下文里
+bool     sim_core0_asleep(void);
+void     sim_wake(void);
+// AC 中断端点：取出主机在上一个 SOF 从功能 func 收到的状态消息（每帧最多一条），没有则返回 false
+bool     sim_int_read(uint8_t func, audio_interrupt_data_t* out);
+
+uint32_t              sim_frame_number(void);
+uint8_t               sim_func_count(void);              // 配置描述符里的音频功能数
+uint8_t               sim_streaming_itf(uint8_t func);   // 功能 func 的 AS 接口号
+uint8_t               sim_cur_alt(uint8_t func);
+uint32_t              sim_flow_rate(uint8_t func);
+const sim_alt_info_t* sim_alt_info(uint8_t alt);
+uint8_t               sim_clock_id(void);
+uint8_t               sim_feature_unit_id(void);
+uint8_t               sim_input_terminal_id(void);
+uint8_t               sim_output_terminal_id(void);
+uint8_t               sim_int_ep(uint8_t func);          // 功能 func 的 AC 中断端点地址（0 = 没有）
+const sim_ctrl_stats_t* sim_ctrl_stats(void);
+
+#endif
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# 数据面遥测读取/作图：
+#   telemetry_plot.py usb [-n 30] [-i 1.0]   经厂商请求 VENDOR_REQ_TELEMETRY_GET 轮询设备（需要 pyusb）
+#   telemetry_plot.py log capture.log        解析固件 CFG_MIC_TELEM_PERIOD_MS 输出的 "@TM" 行（UART 抓包 / uac2_sim 输出）
+# 有 matplotlib 时画 ISR 周期直方图 + 周期/FIFO 水位随时间的曲线（-o 存成图片），否则打印文本表。
+import argparse
+import struct
+import sys
+import time
+
+VID, PID = 0xCAFE, 0x4002
+VENDOR_REQ_TELEMETRY_GET = 0x03
+HIST_BINS, HIST_SHIFT = 16, 8
+# 与 src/telemetry.h 的 telem_stats_t 一致（packed，小端）
+STATS_FMT = "<BBHHIIIIIII%dIIIIII" % HIST_BINS
+STATS_LEN = struct.calcsize(STATS_FMT)
+
+
+def bin_label(k):
+    return "<%d" % (1 << (k + HIST_SHIFT)) if k < HIST_BINS - 1 else ">=%d" % (1 << (k + HIST_SHIFT - 1))
+
+
+def from_usb_blob(t, blob):
+    v = struct.unpack(STATS_FMT, bytes(blob))
+    (ver, alt, fmin, fmax, cpu_hz, fs, n, cmin, cmax, slo, shi), hist = v[:11], list(v[11:11 + HIST_BINS])
+    short, zero, under, alt_sw, rate_sw = v[11 + HIST_BINS:]
+    s = (shi << 32) | slo
+    return dict(t=t, alt=alt, fs=fs, n=n, cyc_min=cmin, cyc_avg=(s / n if n else 0), cyc_max=cmax,
+                fifo_min=fmin, fifo_max=fmax, short=short, zero=zero, underruns=under,
+                alt_sw=alt_sw, rate_sw=rate_sw, cpu_hz=cpu_hz, hist=hist)
+
+
+def from_tm_line(line):
+    # @TM t_ms alt fs n cyc_min cyc_avg cyc_max fifo_min fifo_max short zero underruns alt_sw rate_sw cpu_hz h0..h15
+    f = [int(x) for x in line.split()[1:]]
+    keys = ["t", "alt", "fs", "n", "cyc_min", "cyc_avg", "cyc_max", "fifo_min", "fifo_max",
+            "short", "zero", "underruns", "alt_sw", "rate_sw", "cpu_hz"]
+    d = dict(zip(keys, f[:len(keys)]))
+    d["t"] /= 1000.0
+    d["hist"] = f[len(keys):len(keys) + HIST_BINS]
+    return d
+
+
+def poll_usb(count, interval):
+    try:
+        import usb.core
+    except ImportError:
+        sys.exit("pyusb not installed: pip install pyusb")
+    dev = usb.core.find(idVendor=VID, idProduct=PID)
+    if dev is None:
+        sys.exit("device %04x:%04x not found" % (VID, PID))
+    t0 = time.time()
+    for _ in range(count):
+        blob = dev.ctrl_transfer(0xC0, VENDOR_REQ_TELEMETRY_GET, 0, 0, STATS_LEN)
+        yield from_usb_blob(time.time() - t0, blob)
+        time.sleep(interval)
+
+
+def read_log(path):
+    with open(path, errors="replace") as f:
+        for line in f:
+            if line.startswith("@TM "):
+                yield from_tm_line(line)
+
+
+def print_table(samples):
+    print("%8s %3s %6s %7s %8s %8s %8s %9s %5s %4s %5s" %
+          ("t[s]", "alt", "fs", "n", "cyc_min", "cyc_avg", "cyc_max", "fifo[B]", "short", "zero", "under"))
+    for s in samples:
+        print("%8.3f %3d %6d %7d %8d %8.0f %8d %4d..%-4d %5d %4d %5d" %
+              (s["t"], s["alt"], s["fs"], s["n"], s["cyc_min"], s["cyc_avg"], s["cyc_max"],
+               s["fifo_min"], s["fifo_max"], s["short"], s["zero"], s["underruns"]))
+    if samples:
+        last = samples[-1]
+        deadline = last["cpu_hz"] // 1000
+        print("cycle histogram (last sample, 1 ms deadline = %d cycles):" % deadline)
+        for k, c in enumerate(last["hist"]):
+            if c:
+                print("  %10s %d" % (bin_label(k), c))
+
+
+def plot(samples, out):
+    import matplotlib
+    if out:
+        matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+    last = samples[-1]
+    fig, (ax0, ax1) = plt.subplots(2, 1, figsize=(9, 7))
+    ax0.bar(range(HIST_BINS), last["hist"], tick_label=[bin_label(k) for k in range(HIST_BINS)])
+    ax0.set_yscale("log")
+    ax0.set_title("tud_audio_tx_done_isr cycles (alt %d, %d Hz, 1 ms = %d cycles)"
+                  % (last["alt"], last["fs"], last["cpu_hz"] // 1000))
+    ax0.tick_params(axis="x", labelrotation=45)
+    t = [s["t"] for s in samples]
+    ax1.plot(t, [s["cyc_max"] for s in samples], label="cycles max")
+    ax1.plot(t, [s["cyc_avg"] for s in samples], label="cycles avg")
+    ax1.set_xlabel("t [s]")
+    ax1.set_ylabel("cycles")
+    ax2 = ax1.twinx()
+    ax2.step(t, [s["fifo_min"] for s in samples], "g--", where="post", label="FIFO min [B]")
+    ax2.step(t, [s["fifo_max"] for s in samples], "r--", where="post", label="FIFO max [B]")
+    ax2.set_ylabel("bytes")
+    ax1.legend(loc="upper left")
+    ax2.legend(loc="upper right")
+    fig.tight_layout()
+    if out:
+        fig.savefig(out)
+    else:
+        plt.show()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    sub = ap.add_subparsers(dest="src", required=True)
+    u = sub.add_parser("usb")
+    u.add_argument("-n", type=int, default=30, help="number of polls")
+    u.add_argument("-i", type=float, default=1.0, help="poll interval [s]")
+    lg = sub.add_parser("log")
+    lg.add_argument("file")
+    ap.add_argument("-o", help="save plot to file instead of showing it")
+    ap.add_argument("--text", action="store_true", help="print a table only")
+    a = ap.parse_args()
+
+    samples = list(poll_usb(a.n, a.i) if a.src == "usb" else read_log(a.file))
+    if not samples:
+        sys.exit("no telemetry samples")
+    print_table(samples)
+    if a.text:
+        return
+    try:
+        plot(samples, a.o)
+    except ImportError:
+        print("(matplotlib not installed: text only)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,367 @@
+// 数据面回归基准：把 core1 生产者 + USB ISR 消费者的每一级内核按 1 ms 帧跑一遍完整矩阵
+// （每个 CFG_MIC_CHANNELS 构建能声明的 采样率 × Alt 格式 × 通道数），逐级计时：
+//   sched    rate_sched_next：本帧样本数（消费者）
+//   gen      dds_render_q31：每通道正弦
+//   gain     gain_apply_q31：音量；每 250 ms 切一次静音，斜坡和零增益都算在内
+//   requant  16-bit Alt 的重新量化（CFG_MIC_REQUANT 的默认模式，静音通道跳过，同 audio_engine.c）
+//   pack     pcm_fmt_table 的交织打包内核
+//   fifo     pcm_ring_write（生产者）+ pcm_ring_read2 按回绕拆两段写进 EP IN FIFO 模型（消费者）
+// 每帧：消费者取走本帧字节，生产者按 audio_engine.c 的规则把环补到 CFG_MIC_RING_TARGET_MS 的深度。
+// 报告每级的周期/样本（扣除计时本身的开销）、平均与最坏帧耗时，以及最坏帧相对 1 ms 预算的余量。
+// 余量按单核串行算（真机上生产者在 core1、消费者在 core0），是保守值。
+//
+// 同一份源码也编进固件（根 CMakeLists.txt 的 uac2_bench 目标，PICO_ON_DEVICE）：SysTick 计周期，结果从 UART 输出。
+// 机器可读的结果行 "@UB fs fmt ch cyc/sample avg_ns worst_ns spread"：固件跟在每行表格后面打印，主机版写进 -o 的文件，
+// 主机版可以拿它当基线（spread = 各遍总周期/样本的中位数 − 最小值；没有这一列的旧基线按 0 处理）：
+//   uac2_bench -o base.txt                 记录基线（读基线时只看 @UB 行，其余行忽略）
+//   uac2_bench -b base.txt [-t 25] [-a 2]  与基线比较：任何组合的总周期/样本超出 max(t%, a 周期/样本) 再加两边的 spread，
+//                                          隔一会儿重测 CONFIRM 轮仍然超出，或最坏帧超出 1 ms 预算，退出码 1
+//   uac2_bench -b uart.log -n              拿固件的 UART 日志当“基线”，只打印主机/目标的比值，不判失败
+//   -f <frames>  每个组合每遍的帧数（默认主机 1000、固件 200），整个矩阵扫 PASSES 遍取最小值
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dds.h"
+#include "gain.h"
+#include "pcm_pack.h"
+#include "pcm_ring.h"
+#include "rate_sched.h"
+#include "requant.h"
+#include "audio_engine.h"
+#include "bench_util.h"
+#if !PICO_ON_DEVICE
+#include <unistd.h>
+#endif
+
+#define MAX_CH        8
+#define CHUNK         32                 // = audio_engine.c PRODUCE_CHUNK
+#define MUTE_PERIOD   250                // 帧
+#define FS_ISO_MAX    1023
+#define BUDGET_NS     1000000u           // 1 ms 帧
+#define MAX_CELLS     128
+#if PICO_ON_DEVICE
+#define DEFAULT_FRAMES  200
+#define PASSES          3                // SysTick 不受别的负载影响，几遍结果基本一样
+#else
+#define DEFAULT_FRAMES  1000
+#define PASSES          7
+#define CONFIRM         6                // 疑似回归的组合隔一会儿重测的轮数
+#define CONFIRM_GAP_US  500000           // 主机上的干扰（同一物理核上的别的负载、降频）常常成段地持续几秒
+#endif
+
+// 与 usb_descriptors.h 的 UAC2_EP_SIZE 相同：全速下每 1 ms 向上取整再 +1 个样本
+#define EP_SIZE(fs, bytes, ch)   ((((fs) + 999) / 1000 + 1) * (bytes) * (ch))
+
+typedef enum { ST_SCHED, ST_GEN, ST_GAIN, ST_REQUANT, ST_PACK, ST_FIFO, ST_COUNT } stage_t;
+static const char* const k_stage[ST_COUNT] = { "sched", "gen", "gain", "requant", "pack", "fifo" };
+static const char* const k_fmt[PCM_FMT_COUNT] = { "-", "s16", "s24", "s32", "f32" };
+
+// 各通道数构建的采样率表合起来；每个组合是否被声明由 EP 包长决定（同一张表服务所有 Alt，按最宽的 4 字节算）
+static const uint32_t k_rates[] = { 8000, 16000, 24000, 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+static const uint32_t k_chans[] = { 1, 2, 4, 8 };
+static const pcm_fmt_t k_fmts[] = { PCM_FMT_S16, PCM_FMT_S24, PCM_FMT_S32, PCM_FMT_F32 };
+
+typedef struct {
+  uint32_t fs, ch;
+  pcm_fmt_t fmt;
+  double   cyc[ST_COUNT];                // 周期/样本
+  double   total, avg_ns, worst_ns;
+  double   spread;                       // 各遍总周期/样本：中位数 − 最小值
+} result_t;
+
+static uint32_t s_tick_cost;             // 一对 bench_cycles() 本身的周期数
+static double   s_ns_per_cyc;
+
+static void calibrate(void) {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t a = bench_cycles(), b = bench_cycles();
+    if (b - a < best) best = b - a;
+  }
+  s_tick_cost = (uint32_t)best;
+  uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+  while (bench_now_ns() - t0 < 20000000u) {}
+  s_ns_per_cyc = (double)(bench_now_ns() - t0) / (double)(bench_cycles() - c0);
+}
+
+// ---- 被测链路：一个流的生产者 + 消费者 ----
+typedef struct {
+  dds_t        osc[MAX_CH];
+  gain_t       gain[MAX_CH];
+  requant_ch_t rq[MAX_CH];
+  uint32_t     rng;
+  rate_sched_t sched;
+  pcm_ring_t   ring;
+  uint8_t      ring_buf[CFG_MIC_RING_SZ] __attribute__((aligned(4)));
+  uint8_t      fifo[2 * FS_ISO_MAX] __attribute__((aligned(4)));   // EP IN FIFO 模型：2 帧深
+  uint32_t     fifo_sz, fifo_wr;
+  int32_t      blk[MAX_CH][CHUNK];
+  uint32_t     out[CHUNK * MAX_CH];
+} chain_t;
+
+static chain_t s_k;
+
+static void chain_init(chain_t* k, uint32_t fs, uint32_t ch, pcm_fmt_t fmt) {
+  for (uint32_t c = 0; c < ch; c++) {
+    dds_init(&k->osc[c], DDS_QUALITY_INTERP);
+    dds_set_freq(&k->osc[c], 440 + 220 * c, fs);
+    gain_init(&k->gain[c], GAIN_UNITY / 2);
+    requant_reset(&k->rq[c]);
+  }
+  k->rng = 0x2545F491u;
+  rate_sched_init(&k->sched, fs, 1, 1000);
+  pcm_ring_init(&k->ring, k->ring_buf, sizeof(k->ring_buf));
+  k->fifo_sz = 2 * EP_SIZE(fs, pcm_fmt_table[fmt].bytes, ch);
+  k->fifo_wr = 0;
+}
+
+#define LAP(st)  do { uint64_t t_ = bench_cycles(), d_ = t_ - t; \
+                      a[st] += d_ > s_tick_cost ? d_ - s_tick_cost : 0; t = t_; } while (0)
+
+// 跑 frames 帧（前面另加一帧只垫环、不计时）；acc = 每级周期总和，worst / sum = 整帧周期的最大值 / 总和；
+// 返回计时帧里生成的样本数（× 通道）
+static uint64_t run_pass(uint32_t fs, uint32_t ch, pcm_fmt_t fmt, uint32_t frames, uint64_t* acc, uint64_t* worst, uint64_t* sum) {
+  chain_t* k = &s_k;
+  chain_init(k, fs, ch, fmt);
+  const pcm_fmt_info_t* fi = &pcm_fmt_table[fmt];
+  requant_fn rq = fmt == PCM_FMT_S16 ? requant_table[CFG_MIC_REQUANT] : 0;
+  uint32_t frame_bytes = fi->bytes * ch;
+  uint32_t target = (fs / 1000 + 1) * frame_bytes * CFG_MIC_RING_TARGET_MS;
+  const int32_t* planar[MAX_CH];
+  for (uint32_t c = 0; c < ch; c++) planar[c] = k->blk[c];
+  uint64_t samples = 0, warmup[ST_COUNT] = { 0 };
+  memset(acc, 0, ST_COUNT * sizeof(uint64_t));
+  *worst = *sum = 0;
+
+  for (uint32_t f = 0; f <= frames; f++) {
+    bool timed = f > 0;
+    uint64_t* a = timed ? acc : warmup;
+    if (f % MUTE_PERIOD == 0)
+      for (uint32_t c = 0; c < ch; c++) gain_set_target(&k->gain[c], (f / MUTE_PERIOD) & 1 ? 0 : GAIN_UNITY / 2);
+    uint64_t f0 = bench_cycles(), t = f0;
+    // 消费者：本帧字节数 → 从环里拷进 EP FIFO（回绕处拆两段）
+    uint32_t n = rate_sched_next(&k->sched) * frame_bytes;
+    LAP(ST_SCHED);
+    if (timed) {
+      uint32_t n0 = k->fifo_sz - k->fifo_wr < n ? k->fifo_sz - k->fifo_wr : n;
+      pcm_ring_read2(&k->ring, k->fifo + k->fifo_wr, n0, k->fifo, n - n0);
+      k->fifo_wr = (k->fifo_wr + n) % k->fifo_sz;
+    }
+    LAP(ST_FIFO);
+    // 生产者：补到目标深度
+    while (pcm_ring_level(&k->ring) < target) {
+      for (uint32_t c = 0; c < ch; c++) dds_render_q31(&k->osc[c], k->blk[c], CHUNK);
+      LAP(ST_GEN);
+      for (uint32_t c = 0; c < ch; c++) gain_apply_q31(&k->gain[c], k->blk[c], CHUNK);
+      LAP(ST_GAIN);
+      for (uint32_t c = 0; rq && c < ch; c++)
+        if (k->gain[c].cur != 0 || k->gain[c].target != 0) rq(k->blk[c], CHUNK, &k->rq[c], &k->rng);
+      LAP(ST_REQUANT);
+      uint32_t len = fi->pack(planar, ch, CHUNK, k->out);
+      LAP(ST_PACK);
+      pcm_ring_write(&k->ring, k->out, len);
+      LAP(ST_FIFO);
+      if (timed) samples += CHUNK * ch;
+    }
+    if (!timed) continue;
+    uint64_t d = bench_cycles() - f0;
+    *sum += d;
+    if (d > *worst) *worst = d;
+  }
+  bench_sink(k->fifo);
+  return samples;
+}
+
+// 一遍（frames 帧）的结果
+static void run_once(result_t* r, uint32_t frames) {
+  uint64_t acc[ST_COUNT], worst, sum;
+  uint64_t samples = run_pass(r->fs, r->ch, r->fmt, frames, acc, &worst, &sum);
+  r->total = 0.0;
+  for (int s = 0; s < ST_COUNT; s++) r->total += r->cyc[s] = (double)acc[s] / (double)samples;
+  r->avg_ns   = (double)sum / frames * s_ns_per_cyc;
+  r->worst_ns = (double)worst * s_ns_per_cyc;
+}
+
+static int by_total(const void* a, const void* b) {
+  double x = ((const result_t*)a)->total, y = ((const result_t*)b)->total;
+  return (x > y) - (x < y);
+}
+
+// 整个矩阵扫 PASSES 遍，每个组合取总周期最小的那一遍：干扰（抢占、缓存被别的进程冲掉、降频）只会让一遍变慢，
+// 最小值是最接近内核本身开销的估计，重跑时也最稳定。中位数与最小值之差记作这个组合的抖动（偶发的一遍慢不算进去），
+// 比较基线时一起参考。最坏帧同样取各遍最坏值中最小的一个：滤掉偶发的一次抢占，留下每遍都会出现的峰值
+static void run_matrix(result_t* cells, int n, uint32_t frames) {
+  static result_t pass[MAX_CELLS][PASSES];
+  for (int p = 0; p < PASSES; p++)
+    for (int i = 0; i < n; i++) {
+      pass[i][p] = cells[i];
+      run_once(&pass[i][p], frames);
+    }
+  for (int i = 0; i < n; i++) {
+    double worst = pass[i][0].worst_ns;
+    for (int p = 1; p < PASSES; p++) if (pass[i][p].worst_ns < worst) worst = pass[i][p].worst_ns;
+    qsort(pass[i], PASSES, sizeof(result_t), by_total);
+    cells[i] = pass[i][0];
+    cells[i].worst_ns = worst;
+    cells[i].spread   = pass[i][PASSES / 2].total - pass[i][0].total;
+  }
+}
+
+//--------------------------------------------------------------------+
+// 基线（只有主机版读写文件）
+//--------------------------------------------------------------------+
+#if !PICO_ON_DEVICE
+typedef struct { uint32_t fs, ch; char fmt[8]; double total, avg_ns, worst_ns, spread; } base_t;
+
+static base_t* s_base;
+static int     s_nbase;
+
+static bool base_load(const char* path) {
+  FILE* fp = fopen(path, "r");
+  if (!fp) return false;
+  char line[256];
+  base_t b;
+  while (fgets(line, sizeof(line), fp)) {
+    const char* p = strstr(line, "@UB ");          // UART 日志里可能带前缀
+    b.spread = 0.0;
+    if (!p || sscanf(p, "@UB %u %7s %u %lf %lf %lf %lf", &b.fs, b.fmt, &b.ch, &b.total, &b.avg_ns, &b.worst_ns,
+                     &b.spread) < 6) continue;
+    base_t* nb = realloc(s_base, (size_t)(s_nbase + 1) * sizeof(base_t));
+    if (!nb) break;
+    s_base = nb;
+    s_base[s_nbase++] = b;
+  }
+  fclose(fp);
+  return true;
+}
+
+static const base_t* base_find(const result_t* r) {
+  for (int i = 0; i < s_nbase; i++)
+    if (s_base[i].fs == r->fs && s_base[i].ch == r->ch && !strcmp(s_base[i].fmt, k_fmt[r->fmt])) return &s_base[i];
+  return NULL;
+}
+
+// 回归：超出 max(相对容差, 绝对下限)，再加上两边记录的 spread（各遍之间本来就会有的抖动）
+static bool is_regression(const result_t* r, const base_t* b, double tol, double floor_cyc) {
+  double slack = b->total * tol / 100.0;
+  if (slack < floor_cyc) slack = floor_cyc;
+  slack += b->spread > r->spread ? b->spread : r->spread;
+  return r->total > b->total + slack;
+}
+
+// 疑似回归的组合隔 CONFIRM_GAP_US 重测，每个组合保留历次里最小的总周期：真回归每次都在，干扰过一阵就没了
+static void confirm(result_t* cells, int n, uint32_t frames, double tol, double floor_cyc) {
+  static result_t redo[MAX_CELLS];
+  static int      idx[MAX_CELLS];
+  for (int round = 0; round < CONFIRM; round++) {
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+      const base_t* b = base_find(&cells[i]);
+      if (b && is_regression(&cells[i], b, tol, floor_cyc)) { idx[m] = i; redo[m++] = cells[i]; }
+    }
+    if (m == 0) return;
+    usleep(CONFIRM_GAP_US);
+    run_matrix(redo, m, frames);
+    for (int j = 0; j < m; j++) {
+      result_t* c = &cells[idx[j]];
+      if (redo[j].worst_ns < c->worst_ns) c->worst_ns = redo[j].worst_ns;
+      if (redo[j].total < c->total) {
+        double worst = c->worst_ns;
+        *c = redo[j];
+        c->worst_ns = worst;
+      }
+    }
+  }
+}
+#endif
+
+int main(int argc, char** argv) {
+  uint32_t frames = DEFAULT_FRAMES;
+  FILE* out = NULL;
+  double tol = 25.0, floor_cyc = 2.0;
+  bool report_only = false, have_base = false;
+#if PICO_ON_DEVICE
+  (void)argc; (void)argv;
+  stdio_init_all();
+#else
+  int opt;
+  while ((opt = getopt(argc, argv, "f:o:b:t:a:nh")) != -1) {
+    switch (opt) {
+      case 'f': frames = (uint32_t)atoi(optarg); break;
+      case 'o': if (!(out = fopen(optarg, "w"))) { perror(optarg); return 2; } break;
+      case 'b': if (!base_load(optarg)) { perror(optarg); return 2; } have_base = true; break;
+      case 't': tol = atof(optarg); break;
+      case 'a': floor_cyc = atof(optarg); break;
+      case 'n': report_only = true; break;
+      default:
+        fprintf(stderr, "usage: %s [-f frames] [-o baseline] [-b baseline [-t pct] [-a cycles] [-n]]\n", argv[0]);
+        return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (frames < 1) frames = 1;
+#endif
+  bench_init();
+  dds_table_init();
+  calibrate();
+
+  printf("uac2_bench: %u frames per combination x %d sweeps (minimum), timer pair %u cycles, %.3f ns/cycle\n",
+         frames, PASSES, s_tick_cost, s_ns_per_cyc);
+  printf("%6s %3s %2s |", "Hz", "fmt", "ch");
+  for (int s = 0; s < ST_COUNT; s++) printf(" %7s", k_stage[s]);
+  printf(" %7s | %9s %9s %7s%s\n", "total", "avg ns", "worst ns", "margin", have_base ? "   vs base" : "");
+
+  static result_t cell[MAX_CELLS];
+  int cells = 0;
+  for (unsigned ci = 0; ci < sizeof(k_chans) / sizeof(k_chans[0]); ci++)
+    for (unsigned ri = 0; ri < sizeof(k_rates) / sizeof(k_rates[0]); ri++)
+      for (unsigned fi = 0; fi < sizeof(k_fmts) / sizeof(k_fmts[0]); fi++)
+        if (EP_SIZE(k_rates[ri], 4, k_chans[ci]) <= FS_ISO_MAX && cells < MAX_CELLS)
+          cell[cells++] = (result_t){ .fs = k_rates[ri], .ch = k_chans[ci], .fmt = k_fmts[fi] };
+  run_matrix(cell, cells, frames);
+#if !PICO_ON_DEVICE
+  if (have_base && !report_only) confirm(cell, cells, frames, tol, floor_cyc);
+#endif
+
+  int regress = 0, over = 0;
+  double worst_margin = 100.0;
+  for (int i = 0; i < cells; i++) {
+    const result_t* r = &cell[i];
+    double margin = 100.0 * (1.0 - r->worst_ns / BUDGET_NS);
+    if (margin < worst_margin) worst_margin = margin;
+    over += margin < 0.0;
+    printf("%6u %3s %2u |", r->fs, k_fmt[r->fmt], r->ch);
+    for (int s = 0; s < ST_COUNT; s++) printf(" %7.2f", r->cyc[s]);
+    printf(" %7.2f | %9.0f %9.0f %6.1f%%", r->total, r->avg_ns, r->worst_ns, margin);
+#if !PICO_ON_DEVICE
+    const base_t* b = have_base ? base_find(r) : NULL;
+    if (b) {
+      double ratio = r->total / b->total;
+      bool bad = !report_only && is_regression(r, b, tol, floor_cyc);
+      regress += bad;
+      printf("   %5.2fx%s", ratio, bad ? "  REGRESSION" : "");
+    } else if (have_base) {
+      printf("   (no base)");
+    }
+    if (out) fprintf(out, "@UB %u %s %u %.3f %.0f %.0f %.3f\n", r->fs, k_fmt[r->fmt], r->ch, r->total, r->avg_ns,
+                     r->worst_ns, r->spread);
+    printf("\n");
+#else
+    // 机器可读的一行紧跟在表格行后面，UART 日志整个存下来就能当主机版的基线文件
+    printf("\n@UB %u %s %u %.3f %.0f %.0f %.3f\n", r->fs, k_fmt[r->fmt], r->ch, r->total, r->avg_ns, r->worst_ns,
+           r->spread);
+#endif
+  }
+#if PICO_ON_DEVICE
+  (void)out; (void)tol; (void)floor_cyc; (void)report_only;
+#else
+  if (out) fclose(out);
+#endif
+  printf("%d combinations, worst-frame margin min %.1f%% of 1 ms", cells, worst_margin);
+  if (have_base) printf(", %d regression(s) over max(%.0f%%, %.1f cycles/sample) + spread", regress, tol, floor_cyc);
+  printf("%s\n", over ? ", BUDGET EXCEEDED" : "");
+#if PICO_ON_DEVICE
+  while (true) tight_loop_contents();
+#endif
+  return regress || over ? 1 : 0;
+}
@@ -0,0 +1,600 @@
+// UAC2 主机仿真：把固件（src/ + lib/tusb/）链接到 TinyUSB 替身上，
+// 按脚本模拟主机的枚举/Alt 切换/SET_CUR 序列，以 1 ms SOF 驱动数据面。
+// 报告：每帧包长分布、长期采样率误差、每帧生成耗时、每次切换（SET_INTERFACE / 流中 SET_CUR）到
+// 第一个满长且无静音帧的包的时间（time-to-first-audio）、实体控制请求的回调耗时；可导出逐帧 CSV 与每段 WAV。
+// 多个虚拟麦克风（CFG_MIC_FUNCS > 1）时按功能分段，另报告全速总线周期性带宽的占用峰值
+// （按 Linux 主机控制器驱动的 usb_calc_bus_time 估算）和按同时开流数分组的每帧生成耗时。
+// core0 主循环的空闲统计（VENDOR_REQ_IDLE_GET）按“开流数 / 是否挂起”分窗口报告：WFE 次数、睡眠占比、进入 WFE 到 tx_done 的周期数。
+//
+// 脚本（分号或换行分隔）：
+//   enum            枚举：取描述符 + 像 Windows 一样对每个功能探测一遍实体控制（见 probe）
+//   func <n>        之后的 probe/rate/alt/vol/mute/prefill 发给第 n 个功能（默认 0）
+//   probe [n]       把枚举时的控制探测重复 n 次（默认 1）：时钟 RANGE/CUR/VALID，
+//                   FU 每通道 MUTE/VOLUME RANGE+CUR/AGC，IT 通道簇，各实体 LATENCY
+//   rate <Hz>       SET_CUR 时钟源采样率
+//   alt <n>         SET_INTERFACE（AS 接口）
+//   vol <dB> [ch]   SET_CUR FU 音量（ch 省略 = 0 = Master）
+//   mute <0|1> [ch] SET_CUR FU 静音
+//   prefill <n>     厂商请求：EP IN 预填充帧数（VENDOR_REQ_PREFILL_SET）
+//   source <n>      厂商请求：信号源 0 = 测试音，1 = flash 录音（需要 -f），2 = PDM 麦克风（需要 -p）
+//   latprobe <ms>   厂商请求：功能 0 换成每 ms 一个的延迟标记（0 = 关闭）；固件输出 "@LP" 行，
+//                   配合 -w / -c 的输出交给 host/latprobe.py 算延迟分布（CSV 的 seg 列对应 WAV 文件名里的段号）
+//   requant <n>     厂商请求：16-bit Alt 的重新量化 0 = 截断，1 = TPDF 抖动，2/3 = TPDF + 一阶/二阶噪声整形
+//   suspend         总线挂起（tud_suspend_cb）：之后的 run 只推进时间，没有 SOF 和传输
+//   resume          总线恢复（tud_resume_cb）；在流的功能从这里开始重新计 time-to-first-audio
+//   run <ms>        推进 n 个 SOF 帧
+// 固件从 AC 中断端点发来状态消息时，像主机驱动一样立刻 GET 对应控制的 CUR。
+// -d <ppm> 让仿真的 PDM 时钟偏离标称值，报告里给出采集缓冲的漂移校正计数（丢 / 补块、溢出重对齐）。
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tusb_sim.h"
+#include "usb_descriptors.h"
+#include "vendor_req.h"
+#include "ep_in.h"
+#include "evlog.h"
+#include "telemetry.h"
+#include "latprobe.h"
+#include "idle.h"
+#include "pdm_capture.h"
+
+#define DEFAULT_SCRIPT "enum; rate 44100; alt 1; run 3000; alt 0; rate 96000; alt 2; run 3000"
+#define MAX_OPS        256
+#define MAX_SEGMENTS   64
+#define MAX_SIZES      16
+#define MAX_FUNCS      CFG_TUD_AUDIO
+#define BUS_PERIODIC_NS 900000u          // 全速：周期性传输最多占每帧 90%
+
+int uac2_firmware_main(void);   // 固件 main()，编译时改名
+
+typedef enum { OP_ENUM, OP_FUNC, OP_PROBE, OP_RATE, OP_ALT, OP_VOL, OP_MUTE, OP_PREFILL, OP_SOURCE, OP_LATPROBE, OP_REQUANT, OP_SUSPEND, OP_RESUME, OP_RUN } op_kind_t;
+typedef struct { op_kind_t kind; int32_t arg; uint8_t ch; } op_t;
+
+static op_t     s_ops[MAX_OPS];
+static int      s_nops, s_pc;
+static uint32_t s_run_left;
+static uint8_t  s_func;                  // 脚本当前操作的功能
+
+// ---- 每段（连续同 Alt/同采样率的流）统计 ----
+typedef struct {
+  uint8_t  func;
+  uint8_t  alt, bytes_per_sample, bits, channels;
+  uint32_t rate;
+  uint32_t first_frame, frames;
+  uint64_t bytes;                        // 发到总线上的字节
+  uint64_t written;                      // 固件写进 FIFO 的字节
+  uint32_t zero_pkts;
+  uint16_t sizes[MAX_SIZES];
+  uint32_t size_cnt[MAX_SIZES];
+  uint32_t min_fifo, max_fifo;
+  bool     has_prefill;
+  ep_in_stats_t prefill;                 // 段结束时经 VENDOR_REQ_PREFILL_GET 读回
+  bool     has_telem;
+  uint32_t snap_frames;                  // 上次读回时的帧数：没有新帧就不覆盖
+  telem_stats_t telem;                   // 段结束时经 VENDOR_REQ_TELEMETRY_GET 读回（自上次 set_itf 起累计）
+  FILE*    wav;
+  uint32_t wav_bytes;
+  uint32_t switch_frame;                 // 开启本段的主机动作发生在哪一帧之前（UINT32_MAX = 无）
+  const char* switch_what;
+  uint32_t ttfa;                         // 到第一个有声包为止的帧数（含该包，0 = 还没有）
+  uint32_t pre_pkts;                     // 在它之前的静音/短包/零包数
+  uint32_t dropouts;                     // 在它之后出现的全零采样帧数
+} segment_t;
+
+static segment_t s_seg[MAX_SEGMENTS];
+static int       s_nseg;
+static int       s_open_seg[MAX_FUNCS] = { [0 ... MAX_FUNCS - 1] = -1 };   // 每个功能当前的段
+static const char* s_wav_prefix;
+static FILE*     s_csv;
+static uint32_t  s_switch_frame[MAX_FUNCS] = { [0 ... MAX_FUNCS - 1] = UINT32_MAX };   // 最近一次开流/改采样率的主机动作
+static const char* s_switch_what[MAX_FUNCS];
+
+// ---- 逐帧样本（排序后取分位数）----
+typedef struct { uint64_t* v; uint32_t n, cap; } samples_t;
+
+// ---- core0 空闲统计：每次开/关流、挂起/恢复之前读回一个窗口（VENDOR_REQ_IDLE_GET 读出即清零）----
+typedef struct {
+  uint32_t first_frame, last_frame;
+  uint8_t  streams;                      // 窗口内在流的功能数
+  bool     suspended;
+  idle_stats_t st;
+} idle_win_t;
+
+static idle_win_t s_idle[MAX_SEGMENTS];
+static int        s_nidle;
+static idle_win_t s_idle_cur;            // 正在累计的窗口（只用到起点和状态）
+static bool       s_suspended;
+
+static samples_t s_gen_ns;              // 每个流帧的生成耗时（ISR + core1）
+static samples_t s_isr_cyc;             // 每个流帧 tud_audio_tx_done_isr 的周期数
+static samples_t s_gen_by_n[MAX_FUNCS + 1];   // 每个 SOF 所有功能合计的生成耗时，按同时在流的功能数分组
+static uint64_t  s_total_written, s_total_copied;
+static uint64_t  s_frame_gen;           // 当前 SOF 已累计的生成耗时
+static uint32_t  s_frame_streams;       // 当前 SOF 在流的功能数
+static uint32_t  s_frame_bus_ns;        // 当前 SOF 的周期性带宽预留
+static uint32_t  s_bus_peak_ns, s_bus_peak_streams;
+static bool      s_pdm_used;            // 给了 -p：报告 PDM 采集的校正计数
+
+static void samples_push(samples_t* s, uint64_t x) {
+  if (s->n == s->cap) {
+    s->cap = s->cap ? s->cap * 2 : 4096;
+    s->v = realloc(s->v, s->cap * sizeof(uint64_t));
+  }
+  s->v[s->n++] = x;
+}
+
+//--------------------------------------------------------------------+
+// WAV
+//--------------------------------------------------------------------+
+static void put32(uint8_t* p, uint32_t v) { p[0]=(uint8_t)v; p[1]=(uint8_t)(v>>8); p[2]=(uint8_t)(v>>16); p[3]=(uint8_t)(v>>24); }
+static void put16(uint8_t* p, uint16_t v) { p[0]=(uint8_t)v; p[1]=(uint8_t)(v>>8); }
+
+static void wav_header(FILE* f, uint32_t rate, uint8_t channels, uint8_t bytes, uint8_t bits,
+                       uint16_t fmt_tag, uint32_t data_bytes) {
+  uint8_t h[44];
+  memcpy(h, "RIFF", 4); put32(h + 4, 36 + data_bytes); memcpy(h + 8, "WAVEfmt ", 8);
+  put32(h + 16, 16); put16(h + 20, fmt_tag); put16(h + 22, channels);
+  put32(h + 24, rate); put32(h + 28, rate * channels * bytes);
+  put16(h + 32, (uint16_t)(channels * bytes)); put16(h + 34, bits);
+  memcpy(h + 36, "data", 4); put32(h + 40, data_bytes);
+  fseek(f, 0, SEEK_SET);
+  fwrite(h, 1, sizeof(h), f);
+}
+
+static void segment_close(segment_t* g) {
+  if (!g->wav) return;
+  uint16_t tag = (g->bits == 32 && (sim_alt_info(g->alt)->formats & AUDIO_DATA_FORMAT_TYPE_I_IEEE_FLOAT)) ? 3 : 1;
+  wav_header(g->wav, g->rate, g->channels, g->bytes_per_sample, g->bits, tag, g->wav_bytes);
+  fclose(g->wav);
+  g->wav = NULL;
+}
+
+// 有声包 = 满长（≥ 本采样率每毫秒的整数样本数）且没有任何全零采样帧；之前的包都算切换代价
+static void packet_audio(segment_t* g, const sim_frame_t* f, const uint8_t* data) {
+  uint32_t fb = (uint32_t)g->bytes_per_sample * g->channels, zero = 0;
+  for (uint32_t off = 0; off + fb <= f->pkt_bytes; off += fb) {
+    uint32_t k = 0;
+    while (k < fb && data[off + k] == 0) k++;
+    zero += (k == fb);
+  }
+  if (g->ttfa) { g->dropouts += zero; return; }
+  if (f->pkt_bytes >= g->rate / 1000 * fb && zero == 0) g->ttfa = g->frames;
+  else g->pre_pkts++;
+}
+
+//--------------------------------------------------------------------+
+// 全速周期性带宽：主机在 SET_INTERFACE / 配置时按 wMaxPacketSize 预留（drivers/usb/core/hcd.c usb_calc_bus_time）
+//--------------------------------------------------------------------+
+static uint32_t bit_time(uint32_t bytes) { return 7u * 8u * bytes / 6u; }   // 最坏位填充
+static uint32_t fs_iso_in_ns(uint32_t bytes) { return 7268u + 1000u + 8354u * (31u + 10u * bit_time(bytes)) / 1000u; }
+static uint32_t fs_int_ns(uint32_t bytes)    { return 9107u + 1000u + 8354u * (31u + 10u * bit_time(bytes)) / 1000u; }
+#define INT_EP_BYTES  6                 // AC 中断端点 wMaxPacketSize（状态消息）
+
+//--------------------------------------------------------------------+
+// 包钩子：每个 SOF 帧、每个功能调用一次
+//--------------------------------------------------------------------+
+static void csv_row(const sim_frame_t* f, int seg) {
+  if (s_csv)
+    fprintf(s_csv, "%u,%u,%d,%u,%u,%u,%u,%u,%u,%u,%llu,%llu\n", f->frame, f->func, seg, f->alt, f->rate, f->pkt_bytes,
+            f->written, f->copied, f->write_calls, f->fifo_level,
+            (unsigned long long)f->gen_ns, (unsigned long long)f->isr_cycles);
+}
+
+static void on_packet(const sim_frame_t* f, const uint8_t* data, void* ctx) {
+  (void)ctx;
+  // 每个 SOF 的合计：最后一个功能回调之后结算
+  if (sim_int_ep(f->func)) s_frame_bus_ns += fs_int_ns(INT_EP_BYTES);
+  if (f->alt != 0) {
+    s_frame_bus_ns += fs_iso_in_ns(sim_alt_info(f->alt)->ep_size);
+    s_frame_gen    += f->gen_ns;
+    s_frame_streams++;
+  }
+  if (f->func + 1 == sim_func_count()) {
+    if (s_frame_streams) samples_push(&s_gen_by_n[s_frame_streams], s_frame_gen);
+    if (s_frame_bus_ns > s_bus_peak_ns) { s_bus_peak_ns = s_frame_bus_ns; s_bus_peak_streams = s_frame_streams; }
+    s_frame_gen = 0;
+    s_frame_streams = s_frame_bus_ns = 0;
+  }
+  if (f->alt == 0) { csv_row(f, -1); return; }
+
+  int* open = &s_open_seg[f->func];
+  segment_t* g = (*open >= 0) ? &s_seg[*open] : NULL;
+  if (!g || g->alt != f->alt || g->rate != f->rate || g->first_frame + g->frames != f->frame ||
+      s_switch_frame[f->func] != UINT32_MAX) {
+    if (g) segment_close(g);
+    *open = -1;
+    if (s_nseg >= MAX_SEGMENTS) { csv_row(f, -1); return; }
+    *open = s_nseg;
+    g = &s_seg[s_nseg++];
+    memset(g, 0, sizeof(*g));
+    const sim_alt_info_t* a = sim_alt_info(f->alt);
+    g->func = f->func;
+    g->alt = f->alt; g->rate = f->rate; g->first_frame = f->frame;
+    g->bytes_per_sample = a->bytes_per_sample; g->bits = a->bits; g->channels = a->channels;
+    g->min_fifo = UINT32_MAX;
+    g->switch_frame = s_switch_frame[f->func];
+    g->switch_what  = s_switch_what[f->func];
+    s_switch_frame[f->func] = UINT32_MAX;
+    if (s_wav_prefix) {
+      char path[512];
+      if (sim_func_count() > 1)
+        snprintf(path, sizeof(path), "%s_f%u_seg%d_alt%u_%u.wav", s_wav_prefix, f->func, *open, f->alt, f->rate);
+      else
+        snprintf(path, sizeof(path), "%s_seg%d_alt%u_%u.wav", s_wav_prefix, *open, f->alt, f->rate);
+      g->wav = fopen(path, "wb");
+      if (g->wav) wav_header(g->wav, g->rate, g->channels, g->bytes_per_sample, g->bits, 1, 0);
+    }
+  }
+
+  csv_row(f, *open);
+  g->frames++;
+  g->bytes += f->pkt_bytes;
+  g->written += f->written;
+  if (f->pkt_bytes == 0) g->zero_pkts++;
+  if (f->fifo_level < g->min_fifo) g->min_fifo = f->fifo_level;
+  if (f->fifo_level > g->max_fifo) g->max_fifo = f->fifo_level;
+  for (int i = 0; i < MAX_SIZES; i++) {
+    if (g->size_cnt[i] == 0) { g->sizes[i] = f->pkt_bytes; g->size_cnt[i] = 1; break; }
+    if (g->sizes[i] == f->pkt_bytes) { g->size_cnt[i]++; break; }
+  }
+  packet_audio(g, f, data);
+  if (g->wav && f->pkt_bytes) {
+    fwrite(data, 1, f->pkt_bytes, g->wav);
+    g->wav_bytes += f->pkt_bytes;
+  }
+
+  samples_push(&s_gen_ns, f->gen_ns);
+  samples_push(&s_isr_cyc, f->isr_cycles);
+  s_total_written += f->written;
+  s_total_copied  += f->copied;
+}
+
+//--------------------------------------------------------------------+
+// 脚本
+//--------------------------------------------------------------------+
+static bool parse_script(const char* text) {
+  char* buf = strdup(text);
+  for (char* tok = strtok(buf, ";\n"); tok; tok = strtok(NULL, ";\n")) {
+    char cmd[16]; long arg = 0, ch = 0;
+    int n = sscanf(tok, " %15s %ld %ld", cmd, &arg, &ch);
+    if (n < 1) continue;
+    if (s_nops >= MAX_OPS) { free(buf); return false; }
+    op_t* o = &s_ops[s_nops++];
+    o->arg = (int32_t)arg;
+    o->ch  = (uint8_t)ch;
+    if      (!strcmp(cmd, "enum")) o->kind = OP_ENUM;
+    else if (!strcmp(cmd, "func")) o->kind = OP_FUNC;
+    else if (!strcmp(cmd, "probe")) o->kind = OP_PROBE;
+    else if (!strcmp(cmd, "rate")) o->kind = OP_RATE;
+    else if (!strcmp(cmd, "alt"))  o->kind = OP_ALT;
+    else if (!strcmp(cmd, "vol"))  o->kind = OP_VOL;
+    else if (!strcmp(cmd, "mute")) o->kind = OP_MUTE;
+    else if (!strcmp(cmd, "prefill")) o->kind = OP_PREFILL;
+    else if (!strcmp(cmd, "source"))  o->kind = OP_SOURCE;
+    else if (!strcmp(cmd, "latprobe")) o->kind = OP_LATPROBE;
+    else if (!strcmp(cmd, "requant"))  o->kind = OP_REQUANT;
+    else if (!strcmp(cmd, "suspend")) o->kind = OP_SUSPEND;
+    else if (!strcmp(cmd, "resume"))  o->kind = OP_RESUME;
+    else if (!strcmp(cmd, "run"))  o->kind = OP_RUN;
+    else { fprintf(stderr, "unknown script command: %s\n", cmd); free(buf); return false; }
+  }
+  free(buf);
+  return true;
+}
+
+static uint32_t s_int_seen;             // 收到并处理的中断端点状态消息
+
+static void host_get(uint8_t func, uint8_t entity, uint8_t sel, uint8_t ch, uint8_t req, uint16_t want) {
+  uint8_t buf[CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ];
+  uint16_t len = want;
+  sim_control_get(func, entity, sel, ch, req, buf, &len);
+}
+
+// usbaudio2.sys 枚举时的顺序：时钟 → FU 每个逻辑通道 → Terminal（响应长度取各控制的最大值）
+static void host_probe(uint8_t func) {
+  uint8_t clk = sim_clock_id(), fu = sim_feature_unit_id();
+  host_get(func, clk, AUDIO_CS_CTRL_SAM_FREQ, 0, AUDIO_CS_REQ_RANGE, CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ);
+  host_get(func, clk, AUDIO_CS_CTRL_SAM_FREQ, 0, AUDIO_CS_REQ_CUR, 4);
+  host_get(func, clk, AUDIO_CS_CTRL_CLK_VALID, 0, AUDIO_CS_REQ_CUR, 1);
+  for (uint8_t ch = 0; ch <= CHANNELS; ch++) {
+    host_get(func, fu, AUDIO_FU_CTRL_MUTE, ch, AUDIO_CS_REQ_CUR, 1);
+    host_get(func, fu, AUDIO_FU_CTRL_VOLUME, ch, AUDIO_CS_REQ_RANGE, 8);
+    host_get(func, fu, AUDIO_FU_CTRL_VOLUME, ch, AUDIO_CS_REQ_CUR, 2);
+    host_get(func, fu, AUDIO_FU_CTRL_AGC, ch, AUDIO_CS_REQ_CUR, 1);
+  }
+  host_get(func, sim_input_terminal_id(), AUDIO_TE_CTRL_CONNECTOR, 0, AUDIO_CS_REQ_CUR, 6);
+  host_get(func, sim_input_terminal_id(), AUDIO_TE_CTRL_LATENCY, 0, AUDIO_CS_REQ_CUR, 4);
+  host_get(func, fu, AUDIO_FU_CTRL_LATENCY, 0, AUDIO_CS_REQ_CUR, 4);
+  host_get(func, sim_output_terminal_id(), AUDIO_TE_CTRL_LATENCY, 0, AUDIO_CS_REQ_CUR, 4);
+}
+
+// 主机把每个功能当成一个独立的麦克风设备，逐个探测
+static void host_enumerate(void) {
+  sim_enumerate();
+  for (uint8_t f = 0; f < sim_func_count(); f++) host_probe(f);
+}
+
+// 状态消息：wValue = CS << 8 | CN，wIndex = 实体 << 8 | 接口；主机重新读 CUR
+static void host_interrupt(void) {
+  for (uint8_t f = 0; f < sim_func_count(); f++) {
+    audio_interrupt_data_t m;
+    if (!sim_int_read(f, &m)) continue;
+    uint8_t ent = TU_U16_HIGH(m.wIndex), sel = TU_U16_HIGH(m.wValue), ch = TU_U16_LOW(m.wValue);
+    uint32_t v = 0;
+    uint16_t len = sizeof(v);
+    sim_control_get(f, ent, sel, ch, AUDIO_CS_REQ_CUR, &v, &len);
+    printf("[HOST] frame %u: interrupt f%u itf=%u ent=0x%02X sel=0x%02X ch=%u -> CUR %u\n",
+           sim_frame_number(), f, TU_U16_LOW(m.wIndex), ent, sel, ch, v);
+    s_int_seen++;
+  }
+}
+
+// 流参数要变之前（以及脚本结束时）像主机工具一样用厂商请求读回该功能当前段的预填充统计与遥测（只有功能 0）
+static void snapshot_stats(uint8_t func) {
+  if (s_open_seg[func] < 0) return;
+  segment_t* g = &s_seg[s_open_seg[func]];
+  if (g->has_prefill && g->snap_frames == g->frames) return;
+  g->snap_frames = g->frames;
+  uint16_t len = sizeof(g->prefill);
+  g->has_prefill = sim_vendor_control(TUSB_DIR_IN, VENDOR_REQ_PREFILL_GET, 0, func, &g->prefill, &len) &&
+                   len == sizeof(g->prefill);
+  if (func != 0) return;
+  len = sizeof(g->telem);
+  g->has_telem = sim_vendor_control(TUSB_DIR_IN, VENDOR_REQ_TELEMETRY_GET, 0, 0, &g->telem, &len) &&
+                 len == sizeof(g->telem);
+}
+
+static void idle_snapshot(void) {
+  idle_win_t* w = &s_idle_cur;
+  uint16_t len = sizeof(w->st);
+  bool ok = sim_vendor_control(TUSB_DIR_IN, VENDOR_REQ_IDLE_GET, 0, 0, &w->st, &len) && len == sizeof(w->st);
+  w->last_frame = sim_frame_number();
+  if (ok && w->last_frame > w->first_frame && s_nidle < MAX_SEGMENTS) s_idle[s_nidle++] = *w;
+  w->first_frame = w->last_frame;
+  w->streams = 0;
+  for (uint8_t f = 0; f < sim_func_count(); f++) w->streams += sim_cur_alt(f) != 0;
+  w->suspended = s_suspended;
+}
+
+// 固件每次 tud_task() 执行一个脚本动作或推进一帧
+static bool sim_task(void) {
+  host_interrupt();
+  if (s_run_left) { sim_frame(); s_run_left--; return true; }
+  if (sim_core0_asleep() && (s_pc >= s_nops || s_ops[s_pc].kind != OP_RUN)) {
+    sim_wake();                          // 控制动作（或结束时的读回）要在 tud_task 里处理：先叫醒 core0
+    return true;
+  }
+  if (s_pc >= s_nops) {
+    for (uint8_t f = 0; f < sim_func_count(); f++) snapshot_stats(f);
+    idle_snapshot();
+    return false;
+  }
+  const op_t* o = &s_ops[s_pc++];
+  uint8_t f = s_func;
+  if (o->kind == OP_ALT || o->kind == OP_RATE || o->kind == OP_PREFILL) snapshot_stats(f);
+  if (o->kind == OP_ALT || o->kind == OP_SUSPEND || o->kind == OP_RESUME) idle_snapshot();
+  switch (o->kind) {
+    case OP_ENUM: host_enumerate(); break;
+    case OP_FUNC: if (o->arg < 0 || o->arg >= sim_func_count()) fprintf(stderr, "func %d: device has %u functions\n", (int)o->arg, sim_func_count());
+                  else s_func = (uint8_t)o->arg;
+                  break;
+    case OP_PROBE: for (int32_t k = 0; k < (o->arg > 0 ? o->arg : 1); k++) host_probe(f); break;
+    case OP_RATE: { uint32_t fs = (uint32_t)o->arg;
+                    if (sim_cur_alt(f) != 0) { s_switch_frame[f] = sim_frame_number(); s_switch_what[f] = "SET_CUR"; }
+                    sim_control_set(f, sim_clock_id(), AUDIO_CS_CTRL_SAM_FREQ, 0, AUDIO_CS_REQ_CUR, &fs, 4); } break;
+    case OP_ALT:  if (o->arg != 0) { s_switch_frame[f] = sim_frame_number(); s_switch_what[f] = "SET_INTERFACE"; }
+                  sim_set_interface(sim_streaming_itf(f), (uint8_t)o->arg); break;
+    case OP_VOL:  { int16_t v = (int16_t)(o->arg * 256);
+                    sim_control_set(f, sim_feature_unit_id(), AUDIO_FU_CTRL_VOLUME, o->ch, AUDIO_CS_REQ_CUR, &v, 2); } break;
+    case OP_MUTE: { uint8_t m = (uint8_t)o->arg;
+                    sim_control_set(f, sim_feature_unit_id(), AUDIO_FU_CTRL_MUTE, o->ch, AUDIO_CS_REQ_CUR, &m, 1); } break;
+    case OP_PREFILL: sim_vendor_control(TUSB_DIR_OUT, VENDOR_REQ_PREFILL_SET, (uint16_t)o->arg, f, NULL, NULL); break;
+    case OP_SOURCE:
+      if (!sim_vendor_control(TUSB_DIR_OUT, VENDOR_REQ_SOURCE_SET, (uint16_t)o->arg, 0, NULL, NULL))
+        fprintf(stderr, "source %d rejected (no flash image / PDM bitstream? use -f / -p)\n", (int)o->arg);
+      break;
+    case OP_LATPROBE: sim_vendor_control(TUSB_DIR_OUT, VENDOR_REQ_LATPROBE_SET, (uint16_t)o->arg, 0, NULL, NULL); break;
+    case OP_REQUANT:
+      if (!sim_vendor_control(TUSB_DIR_OUT, VENDOR_REQ_REQUANT_SET, (uint16_t)o->arg, 0, NULL, NULL))
+        fprintf(stderr, "requant %d rejected\n", (int)o->arg);
+      break;
+    case OP_SUSPEND:
+      for (uint8_t k = 0; k < sim_func_count(); k++) snapshot_stats(k);
+      sim_suspend();
+      s_suspended = true;
+      break;
+    case OP_RESUME:
+      for (uint8_t k = 0; k < sim_func_count(); k++) {
+        if (sim_cur_alt(k) == 0) continue;
+        s_switch_frame[k] = sim_frame_number();
+        s_switch_what[k]  = "resume";
+      }
+      sim_resume();
+      s_suspended = false;
+      break;
+    case OP_RUN:  s_run_left = (uint32_t)o->arg; break;
+  }
+  if (o->kind == OP_ALT || o->kind == OP_SUSPEND || o->kind == OP_RESUME) idle_snapshot();
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// 报告
+//--------------------------------------------------------------------+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+static void samples_report(samples_t* s, const char* what) {
+  if (!s->n) return;
+  qsort(s->v, s->n, sizeof(uint64_t), cmp_u64);
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < s->n; i++) sum += s->v[i];
+  printf("%s: min %llu  avg %.0f  p99 %llu  max %llu  over %u frames\n", what,
+         (unsigned long long)s->v[0], (double)sum / s->n,
+         (unsigned long long)s->v[s->n * 99 / 100], (unsigned long long)s->v[s->n - 1], s->n);
+}
+
+static void report(void) {
+  printf("\n==== UAC2 simulation report ====\n");
+  for (int i = 0; i < s_nseg; i++) {
+    segment_t* g = &s_seg[i];
+    uint32_t frame_bytes = (uint32_t)g->bytes_per_sample * g->channels;
+    double samples = (double)g->bytes / frame_bytes;
+    double rate    = samples * 1000.0 / g->frames;
+    double ppm     = g->rate ? (rate - g->rate) / g->rate * 1e6 : 0.0;
+    double gen     = (double)g->written / frame_bytes * 1000.0 / g->frames;
+    double gen_ppm = g->rate ? (gen - g->rate) / g->rate * 1e6 : 0.0;
+    printf("seg %d: func %u alt %u (%u-bit x%u) %u Hz, frames %u [%u..%u]\n", i, g->func, g->alt, g->bits, g->channels,
+           g->rate, g->frames, g->first_frame, g->first_frame + g->frames - 1);
+    printf("  delivered %.0f samples -> %.3f Hz (error %+.1f ppm), zero-length packets %u\n",
+           samples, rate, ppm, g->zero_pkts);
+    printf("  generated %.3f Hz (error %+.1f ppm); the difference is what accumulated in the EP FIFO\n",
+           gen, gen_ppm);
+    printf("  EP FIFO level min/max: %u / %u bytes\n", g->min_fifo, g->max_fifo);
+    if (g->switch_frame != UINT32_MAX) {
+      if (g->ttfa) {
+        printf("  time to first audio: %u ms after %s (%u silent/short packets before it), %u zero frames after it\n",
+               g->first_frame + g->ttfa - g->switch_frame, g->switch_what, g->pre_pkts, g->dropouts);
+      } else {
+        printf("  time to first audio: none within %u ms after %s\n", g->frames, g->switch_what);
+      }
+    }
+    if (g->has_prefill) {
+      const ep_in_stats_t* p = &g->prefill;
+      printf("  prefill %u frames: FIFO depth %u B, added latency %u us, min level %u B (%u us);"
+             " deferred %u, silence frames %u, batched ISRs %u\n",
+             p->target_frames, p->fifo_depth, p->latency_us, p->min_level, p->min_level_us,
+             p->deferred, p->silence_frames, p->batched);
+    }
+    if (g->has_telem) {
+      const telem_stats_t* t = &g->telem;
+      uint64_t sum = ((uint64_t)t->cyc_sum_hi << 32) | t->cyc_sum_lo;
+      printf("  telemetry: %u callbacks, SysTick cycles min/avg/max %u / %.0f / %u; FIFO %u..%u B;"
+             " short %u, zero %u, underruns %u; switches alt %u rate %u\n",
+             t->isr_count, t->cyc_min, t->isr_count ? (double)sum / t->isr_count : 0.0, t->cyc_max,
+             t->fifo_min, t->fifo_max, t->pkt_short, t->pkt_zero, t->underruns, t->alt_switches, t->rate_switches);
+      printf("  cycle histogram:");
+      for (int k = 0; k < TELEM_HIST_BINS; k++) {
+        if (t->hist[k]) printf(" <%u:%u", 1u << (k + TELEM_HIST_SHIFT), t->hist[k]);
+      }
+      printf("\n");
+    }
+    printf("  packet sizes:");
+    for (int k = 0; k < MAX_SIZES && g->size_cnt[k]; k++) printf(" %uB x%u", g->sizes[k], g->size_cnt[k]);
+    printf("\n");
+  }
+  const sim_ctrl_stats_t* c = sim_ctrl_stats();
+  printf("entity control requests: GET %u (%u stalled), SET %u (%u stalled)\n",
+         c->gets, c->get_stalls, c->sets, c->set_stalls);
+  printf("  callback host cycles: GET avg %.0f max %llu, SET avg %.0f max %llu\n",
+         c->gets ? (double)c->get_cyc_sum / c->gets : 0.0, (unsigned long long)c->get_cyc_max,
+         c->sets ? (double)c->set_cyc_sum / c->sets : 0.0, (unsigned long long)c->set_cyc_max);
+  printf("  interrupt EP");
+  for (uint8_t f = 0; f < sim_func_count(); f++) printf(" 0x%02X", sim_int_ep(f));
+  printf(": %u status messages sent, %u handled by host\n", c->int_msgs, s_int_seen);
+  samples_report(&s_gen_ns, "frame generation (ISR + core1, host ns)");
+  if (sim_func_count() > 1) {
+    for (uint32_t n = 1; n <= MAX_FUNCS; n++) {
+      char what[64];
+      snprintf(what, sizeof(what), "  per SOF, %u stream%s open (host ns)", n, n > 1 ? "s" : "");
+      samples_report(&s_gen_by_n[n], what);
+    }
+  }
+  // 全速周期性带宽：每个功能的中断端点在配置后一直占着，ISO 端点按所开 Alt 的 wMaxPacketSize 预留
+  const sim_alt_info_t* a1 = sim_alt_info(1);
+  uint32_t int_ns = fs_int_ns(INT_EP_BYTES), iso1_ns = a1 ? fs_iso_in_ns(a1->ep_size) : 0;
+  uint32_t fit = iso1_ns ? (BUS_PERIODIC_NS - sim_func_count() * int_ns) / iso1_ns : 0;
+  printf("USB periodic bandwidth (full speed, Linux usb_calc_bus_time): peak %.1f of %.0f us/frame with %u stream(s) open;"
+         " interrupt EP %.1f us each, Alt1 ISO EP (%u B) %.1f us -> %u concurrent Alt1 stream(s) fit\n",
+         s_bus_peak_ns / 1000.0, BUS_PERIODIC_NS / 1000.0, s_bus_peak_streams, int_ns / 1000.0,
+         a1 ? a1->ep_size : 0, iso1_ns / 1000.0, fit);
+  if (s_bus_peak_ns > BUS_PERIODIC_NS)
+    printf("  over budget: a real host refuses the SET_INTERFACE that crosses it (Linux -ENOSPC, Windows \"not enough USB bandwidth\")\n");
+  samples_report(&s_isr_cyc, "tud_audio_tx_done_isr (host cycles)");
+  // 仿真里固件的工作不占仿真时间：睡眠占比是上限，硬件上的值由 time_us_32 实测；唤醒延迟是主机周期
+  printf("core0 main loop idle (VENDOR_REQ_IDLE_GET, per window):\n");
+  for (int i = 0; i < s_nidle; i++) {
+    const idle_win_t* w = &s_idle[i];
+    const idle_stats_t* t = &w->st;
+    uint64_t sum = ((uint64_t)t->lat_sum_hi << 32) | t->lat_sum_lo;
+    char what[32];
+    if (w->suspended) snprintf(what, sizeof(what), "suspended");
+    else              snprintf(what, sizeof(what), "%u stream%s open", w->streams, w->streams == 1 ? "" : "s");
+    printf("  frames %u..%u (%s): asleep %.1f%% of %.1f ms, %.2f WFE/ms",
+           w->first_frame, w->last_frame - 1, what, t->window_us ? 100.0 * t->sleep_us / t->window_us : 0.0,
+           t->window_us / 1000.0, t->window_us ? t->sleeps * 1000.0 / t->window_us : 0.0);
+    if (t->serviced) printf(", WFE entry -> tx_done avg %.0f max %u cycles", (double)sum / t->serviced, t->lat_max);
+    printf("\n");
+  }
+  if (s_nidle) printf("  bus suspends %u, %u ms suspended in total\n",
+                      s_idle[s_nidle - 1].st.suspends, s_idle[s_nidle - 1].st.suspended_ms);
+  // EP IN 写路径：经 tud_audio_write 的字节要先进固件暂存缓冲（CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX）再拷一次
+  printf("EP IN writes: %llu B total, %llu B copied via tud_audio_write, %llu B written in place;"
+         " staging buffer %u B\n",
+         (unsigned long long)s_total_written, (unsigned long long)s_total_copied,
+         (unsigned long long)(s_total_written - s_total_copied),
+         s_total_copied ? (unsigned)CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX : 0u);
+  if (s_pdm_used) {
+    pdm_capture_stats_t ps;
+    pdm_capture_get_stats(&ps);
+    printf("PDM capture: %u blocks dropped, %u repeated (%u B each), %u overruns\n",
+           ps.dropped, ps.repeated, (unsigned)PDM_CAPTURE_SLIP, ps.overruns);
+  }
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr, "usage: %s [-s script] [-w wav_prefix] [-c frames.csv] [-f flash_image.wav] [-p bitstream.pdm] [-d pdm_ppm] [-q]\n", argv0);
+  fprintf(stderr, "  default script: \"%s\"\n", DEFAULT_SCRIPT);
+}
+
+int main(int argc, char** argv) {
+  const char* script = DEFAULT_SCRIPT;
+  bool quiet = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:w:c:f:p:d:qh")) != -1) {
+    switch (opt) {
+      case 's': script = optarg; break;
+      case 'w': s_wav_prefix = optarg; break;
+      case 'c': s_csv = fopen(optarg, "w"); break;
+      case 'f': if (!sim_flash_image_load(optarg)) { perror(optarg); return 2; } break;
+      case 'p': if (!sim_pdm_load(optarg)) { perror(optarg); return 2; } s_pdm_used = true; break;
+      case 'd': sim_pdm_set_ppm(atoi(optarg)); break;
+      case 'q': quiet = true; break;
+      default:  usage(argv[0]); return 2;
+    }
+  }
+  if (!parse_script(script)) return 2;
+  if (s_csv) fprintf(s_csv, "frame,func,seg,alt,rate,pkt_bytes,written,copied,write_calls,fifo_level,gen_ns,isr_cycles\n");
+
+  // 固件日志可选静音（报告照常输出）
+  int saved_stdout = -1;
+  if (quiet) {
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    int nul = open("/dev/null", O_WRONLY);
+    dup2(nul, STDOUT_FILENO);
+    close(nul);
+  }
+
+  sim_set_packet_hook(on_packet, NULL);
+  sim_run_firmware(uac2_firmware_main, sim_task);
+  while (evlog_drain(EVLOG_DRAIN_MAX)) {}   // 脚本结束时主循环还没来得及输出的事件
+  for (int k = 0; k < CFG_MIC_LATPROBE_DEPTH; k++) latprobe_poll();
+
+  if (quiet) {
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+  }
+  for (int i = 0; i < s_nseg; i++) segment_close(&s_seg[i]);
+  if (s_csv) fclose(s_csv);
+  report();
+  free(s_gen_ns.v);
+  free(s_isr_cyc.v);
+  for (uint32_t n = 0; n <= MAX_FUNCS; n++) free(s_gen_by_n[n].v);
+  return 0;
+}
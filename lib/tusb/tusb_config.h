@@ -25,9 +25,10 @@
 //--------------------------------------------------------------------+
 // 类驱动：只开 Audio（UAC2）
 //--------------------------------------------------------------------+
-#define CFG_TUD_AUDIO               1
+#define CFG_TUD_AUDIO               CFG_MIC_FUNCS   // 每个虚拟麦克风一个音频功能（uac2_rates.h）
 #define CFG_TUD_AUDIO_ENABLE_EP_IN  1     // 作为麦克风（IN 传到主机）
 #define CFG_TUD_AUDIO_ENABLE_EP_OUT 0
+#define CFG_TUD_AUDIO_ENABLE_INTERRUPT_EP 1   // AC 中断端点：控制值变化时通知主机（src/uac2_ctrl.c）
 
 // 支持帧大小流控（44.1 kHz 需要）
 #define CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL 1  // 必开：44.1kHz 抖包需要帧长流控（Async IN）
@@ -37,17 +38,37 @@
 #define CFG_TUD_MEM_ALIGN           __attribute__((aligned(4)))
 
 // ------- 必填：告知音频函数描述符长度与接口数量（见 usb_descriptors.c） -------
-#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN        (TUD_AUDIO_MIC_ONE_CH_DESC_LEN + ALT2_BLOCK_LEN)
-#define CFG_TUD_AUDIO_FUNC_1_N_AS_INT        3   // AS 接口：Alt0(关闭) + Alt1(16bit) + Alt2(24bit)
+#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN        UAC2_FUNC_DESC_LEN
+#define CFG_TUD_AUDIO_FUNC_1_N_AS_INT        1   // AS 接口个数（不是 Alt 数；Alt 见 usb_descriptors.h 的 UAC2_ALT_TABLE）
 
-// EP IN 最大包长（按 96kHz, 24bit, mono 算：96k * 3 / 1000 = 288 字节）
-#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX    288
+// EP IN 最大包长：由采样率表最大值、最宽的 Alt 与通道数推导（192kHz, 32bit, mono：193 * 4 = 772 字节）
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX    EP_SZ_MAX
 
-// EP 软件缓冲至少与 max EP size 相同
-#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ (10*CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX)
+// EP IN 预填充（src/ep_in.c）：FIFO 里保持 N 帧（1 ms/帧）提前量，N 可经厂商请求在 [2, MAX] 内调整。
+// 帧长流控把水位稳定在 FIFO 深度的一半，所以运行时按当前格式把深度设为 2 × N 帧，
+// 静态缓冲只需按最宽格式放下 2 × (MAX + 1) 帧（+1 留给最长包）。
+#ifndef CFG_MIC_PREFILL_FRAMES
+#define CFG_MIC_PREFILL_FRAMES               2
+#endif
+#ifndef CFG_MIC_PREFILL_MAX_FRAMES
+#define CFG_MIC_PREFILL_MAX_FRAMES           4
+#endif
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ (2 * (CFG_MIC_PREFILL_MAX_FRAMES + 1) * CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX)
+
+// 控制缓冲（用于音量/静音等控制请求）；须放得下采样率 RANGE 响应
+#define CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ     (UAC2_RATE_RANGE_LEN > 64 ? UAC2_RATE_RANGE_LEN : 64)
 
-// 控制缓冲（用于音量/静音等控制请求）
-#define CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ     64
+// 其余功能与功能 1 完全相同（描述符由同一个 UAC2_DESC_FUNC 展开）
+#define CFG_TUD_AUDIO_FUNC_2_DESC_LEN        CFG_TUD_AUDIO_FUNC_1_DESC_LEN
+#define CFG_TUD_AUDIO_FUNC_2_N_AS_INT        CFG_TUD_AUDIO_FUNC_1_N_AS_INT
+#define CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX    CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX
+#define CFG_TUD_AUDIO_FUNC_2_EP_IN_SW_BUF_SZ CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ
+#define CFG_TUD_AUDIO_FUNC_2_CTRL_BUF_SZ     CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ
+#define CFG_TUD_AUDIO_FUNC_3_DESC_LEN        CFG_TUD_AUDIO_FUNC_1_DESC_LEN
+#define CFG_TUD_AUDIO_FUNC_3_N_AS_INT        CFG_TUD_AUDIO_FUNC_1_N_AS_INT
+#define CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX    CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX
+#define CFG_TUD_AUDIO_FUNC_3_EP_IN_SW_BUF_SZ CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ
+#define CFG_TUD_AUDIO_FUNC_3_CTRL_BUF_SZ     CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ
 
 // 不做软件编码/解码
 #define CFG_TUD_AUDIO_ENABLE_ENCODING        0
@@ -0,0 +1,65 @@
+#ifndef __UAC2_RATES_H__
+#define __UAC2_RATES_H__
+
+// —— 通道数（编译期选择描述符变体）：1 / 2 / 4 / 8 ——
+#ifndef CFG_MIC_CHANNELS
+#define CFG_MIC_CHANNELS    1
+#endif
+
+// —— 虚拟麦克风个数：一个设备里 N 个独立的 UAC2 功能（各自的时钟/FU/AS 接口/端点）——
+// TinyUSB 的音频类最多 3 个功能（CFG_TUD_AUDIO_FUNC_1..3_*）；全速总线能同时跑几路见 Readme
+#ifndef CFG_MIC_FUNCS
+#define CFG_MIC_FUNCS       1
+#endif
+#if CFG_MIC_FUNCS < 1 || CFG_MIC_FUNCS > 3
+#error "CFG_MIC_FUNCS must be 1, 2 or 3"
+#endif
+
+// —— 采样率表（唯一来源）——
+// Clock Source 的 RANGE/CUR/VALID、EP wMaxPacketSize、FIFO 尺寸都由这里推导。
+// X(min, max, res)：min==max 且 res==0 为离散采样率；res>0 为连续/步进区间（UAC2 RANGE 子区间）。
+// 子区间必须升序、互不重叠（UAC2 规范要求）。
+// 全速 ISO 每帧最多 1023 字节，通道越多最高采样率越低（usb_descriptors.c 里静态断言）。
+#if CFG_MIC_CHANNELS == 1
+#define UAC2_RATE_TABLE(X) \
+  X(  8000,  32000, 8000)  \
+  X( 44100,  44100,    0)  \
+  X( 48000,  48000,    0)  \
+  X( 88200,  88200,    0)  \
+  X( 96000,  96000,    0)  \
+  X(176400, 176400,    0)  \
+  X(192000, 192000,    0)
+#define UAC2_RATE_MAX       192000   // 表中最大值（决定 EP 尺寸），rate_sched.c 里静态断言校验
+#define UAC2_RATE_DEFAULT   44100
+#elif CFG_MIC_CHANNELS == 2
+#define UAC2_RATE_TABLE(X) \
+  X(  8000,  32000, 8000)  \
+  X( 44100,  44100,    0)  \
+  X( 48000,  48000,    0)  \
+  X( 88200,  88200,    0)  \
+  X( 96000,  96000,    0)
+#define UAC2_RATE_MAX       96000
+#define UAC2_RATE_DEFAULT   44100
+#elif CFG_MIC_CHANNELS == 4
+#define UAC2_RATE_TABLE(X) \
+  X(  8000,  32000, 8000)  \
+  X( 44100,  44100,    0)  \
+  X( 48000,  48000,    0)
+#define UAC2_RATE_MAX       48000
+#define UAC2_RATE_DEFAULT   48000
+#elif CFG_MIC_CHANNELS == 8
+#define UAC2_RATE_TABLE(X) \
+  X(  8000,  24000, 8000)
+#define UAC2_RATE_MAX       24000
+#define UAC2_RATE_DEFAULT   24000
+#else
+#error "CFG_MIC_CHANNELS must be 1, 2, 4 or 8"
+#endif
+
+#define UAC2_RATE_COUNT_(mn, mx, res)  + 1
+#define UAC2_RATE_COUNT     (0 UAC2_RATE_TABLE(UAC2_RATE_COUNT_))
+
+// GET RANGE(SAM_FREQ) 响应长度：wNumSubRanges(2) + N × {dMIN, dMAX, dRES}(12)
+#define UAC2_RATE_RANGE_LEN (2 + 12 * UAC2_RATE_COUNT)
+
+#endif
@@ -2,52 +2,15 @@
 #include "tusb_config.h"
 #include "tusb.h"
 #include "usb_descriptors.h"
-
-// ---- 小工具：16字节一行的 hexdump ----
-static void dump_hex(const void* data, uint16_t len, const char* tag)
-{
-  const uint8_t* p = (const uint8_t*)data;
-  printf("[DUMP] %s, %u bytes\n", tag, len);
-  for (uint16_t i = 0; i < len; i += 16) {
-    printf("  %04x: ", i);
-    for (uint16_t j = 0; j < 16 && i + j < len; ++j) printf("%02X ", p[i + j]);
-    printf("\n");
-  }
-}
-
-// ---- 解析并打印 Config 头部几个关键字段 ----
-static void explain_cfg_header(const uint8_t* p)
-{
-  uint16_t wTotal = p[2] | (p[3] << 8);
-  uint8_t  nItf   = p[4];
-  uint8_t  attr   = p[7];
-  uint8_t  maxPwr = p[8];
-  printf("[CHK ] CFG: wTotal=%u, bNumInterfaces=%u, bmAttr=0x%02X, bMaxPower=%u (%umA)\n",
-         wTotal, nItf, attr, maxPwr, maxPwr*2);
-}
-// ---- 简单解析 AC Header 的 wTotalLength（类特定 AC Header 的第二第三字节）----
-// 要求：AC 接口在 IAD 后，应先出现标准 AC 接口，再跟 Class-Specific AC Header (HEADER subtype)
-static void explain_ac_header(const uint8_t* p, uint16_t len)
-{
-  // 粗略扫描：找第一个 0x24(=CS_INTERFACE), 子类型=0x01(HEADER)
-  for (uint16_t i=0; i+3 < len; ) {
-    uint8_t bLen  = p[i+0];
-    uint8_t bType = p[i+1];
-    uint8_t bSub  = p[i+2];
-    if (bLen==0 || i + bLen > len) break;
-    if (bType==0x24 && bSub==0x01 && bLen >= 9) { // UAC2 HEADER 至少 9B（包含 bcdADC 和 wTotalLength 等）
-      uint16_t acTotal = p[i+6] | (p[i+7] << 8);
-      printf("[CHK ] AC Header: wTotalLength=%u (class-specific part)\n", acTotal);
-      return;
-    }
-    i += bLen;
-  }
-  printf("[WARN] AC Header not found or too short\n");
-}
+#include "evlog.h"
 
 //--------------------------------------------------------------------+
 // 设备描述符
 //--------------------------------------------------------------------+
+// 变体（功能数、通道数）编进 bcdDevice 的低两个 BCD 位和产品名：各变体的配置描述符完全不同，
+// 按 VID/PID/bcdDevice 缓存拓扑的主机（Windows）换刷另一个变体后才会重新读描述符。例如 3 × 8ch = 0x0138
+#define UAC2_BCD_DEVICE  (0x0100 | (UAC2_FUNCS << 4) | CFG_MIC_CHANNELS)
+
 static const tusb_desc_device_t desc_device = {
     .bLength            = sizeof(tusb_desc_device_t),
     .bDescriptorType    = TUSB_DESC_DEVICE,
@@ -58,7 +21,7 @@ static const tusb_desc_device_t desc_device = {
     .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
     .idVendor           = 0xCafe,
     .idProduct          = 0x4002,
-    .bcdDevice          = 0x0100,
+    .bcdDevice          = UAC2_BCD_DEVICE,
     .iManufacturer      = 0x01,
     .iProduct           = 0x02,
     .iSerialNumber      = 0x03,
@@ -66,151 +29,159 @@ static const tusb_desc_device_t desc_device = {
 };
 
 uint8_t const * tud_descriptor_device_cb(void) {
-  printf("[DESC] device requested, %u bytes\n", (unsigned)sizeof(desc_device));
+  EVLOG2(EV_DESC_DEVICE, 0, sizeof(desc_device));
   return (uint8_t const *) &desc_device;
 }
 
 //--------------------------------------------------------------------+
-// 字符串描述符（最小）
+// 字符串描述符：编译期用 u"" 字面量编成 UTF-16LE，回调只返回指针
 //--------------------------------------------------------------------+
-char const* string_desc_arr[] = {
-  (const char[]){ 0x09, 0x04 },     // 0: 语言 ID (English US)
-  "TinyUSB UAC2 Mic",               // 1: Manufacturer
-  "RP2040 Mono Mic",                // 2: Product
-  "123456",                         // 3: Serial
-  "UAC2"                            // 4: Audio Interface
-};
+// bLength = 2 + 2 × 字符数，正好是 sizeof(u"...")（结尾的 u'\0' 顶替 2 字节头）
+#define UAC2_STR_DESC(_name, _s) \
+  static const struct { uint16_t hdr; uint16_t utf16[sizeof(u"" _s) / 2 - 1]; } _name = \
+    { (uint16_t)((TUSB_DESC_STRING << 8) | sizeof(u"" _s)), u"" _s }; \
+  _Static_assert(sizeof(_name) == sizeof(u"" _s) && sizeof(u"" _s) <= 255, "string descriptor " #_name " too long")
+
+#define UAC2_XSTR_(_x)  #_x
+#define UAC2_XSTR(_x)   UAC2_XSTR_(_x)
+#if CFG_MIC_CHANNELS == 1
+#define UAC2_PRODUCT_CH "Mono"
+#else
+#define UAC2_PRODUCT_CH UAC2_XSTR(CFG_MIC_CHANNELS) "ch"
+#endif
+#if UAC2_FUNCS == 1
+#define UAC2_PRODUCT    "RP2040 " UAC2_PRODUCT_CH " Mic"                         // "RP2040 Mono Mic" / "RP2040 8ch Mic"
+#else
+#define UAC2_PRODUCT    "RP2040 " UAC2_XSTR(UAC2_FUNCS) "x " UAC2_PRODUCT_CH " Mic"  // "RP2040 3x 2ch Mic"
+#endif
 
-static uint16_t _desc_str[32];
+static const uint16_t _str_langid[] = { (TUSB_DESC_STRING << 8) | 4, 0x0409 };   // 0: 语言 ID (English US)
+UAC2_STR_DESC(_str_manufacturer, "TinyUSB UAC2 Mic");                              // 1
+UAC2_STR_DESC(_str_product,      UAC2_PRODUCT);                                    // 2
+UAC2_STR_DESC(_str_serial,       "123456");                                        // 3
+UAC2_STR_DESC(_str_mic_1,        "UAC2 Mic 1");                                    // 4..: 每个功能的 IAD/AC 接口名，
+UAC2_STR_DESC(_str_mic_2,        "UAC2 Mic 2");                                    //      主机按它区分多个虚拟麦克风
+UAC2_STR_DESC(_str_mic_3,        "UAC2 Mic 3");
+#define UAC2_STR_FUNC(_f)  (4 + (_f))
+
+#define UAC2_STR_PTR(_name)  ((const uint16_t*)(const void*)&(_name))
+static const uint16_t* const _desc_str[] = {
+  _str_langid, UAC2_STR_PTR(_str_manufacturer), UAC2_STR_PTR(_str_product), UAC2_STR_PTR(_str_serial),
+  UAC2_STR_PTR(_str_mic_1), UAC2_STR_PTR(_str_mic_2), UAC2_STR_PTR(_str_mic_3),
+};
+_Static_assert(UAC2_STR_FUNC(UAC2_FUNCS - 1) < sizeof(_desc_str) / sizeof(_desc_str[0]), "one interface string per function");
 
 uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
   (void) langid;
-  uint8_t chr_count;
-  printf("[DESC] string index=%u requested\n", index);
-
-  if ( index == 0 ) {
-    memcpy(&_desc_str[1], string_desc_arr[0], 2);
-    chr_count = 1;
-  } else {
-    if ( !(index < sizeof(string_desc_arr)/sizeof(string_desc_arr[0])) ) return NULL;
-    const char* str = string_desc_arr[index];
-    chr_count = (uint8_t) strlen(str);
-    if ( chr_count > 31 ) chr_count = 31;
-    for(uint8_t i=0; i<chr_count; i++) _desc_str[1+i] = str[i];
-  }
-
-  _desc_str[0] = (TUSB_DESC_STRING << 8 ) | (2*chr_count + 2);
-  return _desc_str;
+  EVLOG1(EV_DESC_STRING, index);
+  return index < sizeof(_desc_str) / sizeof(_desc_str[0]) ? _desc_str[index] : NULL;
 }
 
 //--------------------------------------------------------------------+
 // 配置 + 音频描述符
 //--------------------------------------------------------------------+
 
-// 96 kHz, 单声道。本工程提供 Alt1=16bit 与 Alt2=24bit 两套格式。
-#define CHANNELS          1
-#define MAX_FREQ_HZ       96000
-
-// 另准备 24bit 的参数
-#define BYTES_PER_SAMPLE_16   2
-#define BITS_USED_16          16
-#define BYTES_PER_SAMPLE_24   3
-#define BITS_USED_24          24
-
-#define EP_SZ_16  TUD_AUDIO_EP_SIZE(MAX_FREQ_HZ, BYTES_PER_SAMPLE_16, CHANNELS) // 96
-#define EP_SZ_24  TUD_AUDIO_EP_SIZE(MAX_FREQ_HZ, BYTES_PER_SAMPLE_24, CHANNELS) // 144
-
-static const uint8_t _cfg_audio_dual[] = {
+// CHANNELS 通道，Alt1..N 按 UAC2_ALT_TABLE 展开；EP 尺寸按 uac2_rates.h 的最高采样率计算（见 usb_descriptors.h）
+// 一致性检查全部是静态断言：描述符字节、长度宏和 EP 尺寸对不上时编译失败，运行时不再遍历/校验
+
+// 每个 Alt：有效位不超过 subslot，包长不超过全速 ISO 上限
+#define UAC2_ALT_CHECK_(_name, _type, _bytes, _bits, _fmt) \
+  _Static_assert((_bits) <= 8 * (_bytes), #_name ": bit resolution exceeds the subslot size"); \
+  _Static_assert(UAC2_ALT_EP_SIZE(_bytes) <= EP_SZ_FS_ISO_LIMIT, \
+                 #_name ": EP size exceeds the full-speed ISO limit, lower UAC2_RATE_MAX for this channel count");
+UAC2_ALT_TABLE(UAC2_ALT_CHECK_)
+
+// N 通道 FU：Master 与每个逻辑通道都带 Mute/Volume/AGC（可读写）
+#define UAC2_FU_CTRL_MUTE_VOL  U32_TO_U8S_LE((AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_MUTE_POS) \
+                                           | (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_VOLUME_POS) \
+                                           | (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_AGC_POS))
+#define UAC2_FU_CTRL_REPEAT_1  UAC2_FU_CTRL_MUTE_VOL
+#define UAC2_FU_CTRL_REPEAT_2  UAC2_FU_CTRL_REPEAT_1, UAC2_FU_CTRL_REPEAT_1
+#define UAC2_FU_CTRL_REPEAT_4  UAC2_FU_CTRL_REPEAT_2, UAC2_FU_CTRL_REPEAT_2
+#define UAC2_FU_CTRL_REPEAT_8  UAC2_FU_CTRL_REPEAT_4, UAC2_FU_CTRL_REPEAT_4
+#define UAC2_FU_CTRL_REPEAT_(_n)  UAC2_FU_CTRL_REPEAT_##_n
+#define UAC2_FU_CTRL_REPEAT(_n)   UAC2_FU_CTRL_REPEAT_(_n)
+
+// 功能 _f 的一个带等时 IN 端点（Iso + Async + Data）的 AS 备用设置
+#define UAC2_DESC_AS_ALT(_f, _alt, _formats, _bytes, _bits, _epsize) \
+  TUD_AUDIO_DESC_STD_AS_INT(/*itf*/(uint8_t)(ITF_NUM_AUDIO_STREAMING_N(_f)), /*alt*/(_alt), /*nEPs*/0x01, /*str*/0x00), \
+  TUD_AUDIO_DESC_CS_AS_INT(/*termid*/UAC2_OT_ID, /*ctrl*/AUDIO_CTRL_NONE, /*formattype*/AUDIO_FORMAT_TYPE_I, \
+                           /*formats*/(_formats), /*nchannelsphysical*/CHANNELS, /*channelcfg*/CHANNEL_CONFIG, /*str*/0x00), \
+  TUD_AUDIO_DESC_TYPE_I_FORMAT(/*subslot*/(_bytes), /*bits*/(_bits)), \
+  TUD_AUDIO_DESC_STD_AS_ISO_EP(/*ep*/EPNUM_AUDIO_IN_N(_f), \
+      /*attr*/(uint8_t)((uint8_t)TUSB_XFER_ISOCHRONOUS | (uint8_t)TUSB_ISO_EP_ATT_ASYNCHRONOUS | (uint8_t)TUSB_ISO_EP_ATT_DATA), \
+      /*maxEPsize*/(_epsize), /*interval*/0x01), \
+  TUD_AUDIO_DESC_CS_AS_ISO_EP(/*attr*/AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK, \
+      /*ctrl*/AUDIO_CTRL_NONE, /*lockunit*/AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED, /*lockdelay*/0x0000)
+
+#define UAC2_DESC_FEATURE_UNIT_N_CHANNEL(_unitid, _srcid, _stridx) \
+  UAC2_FU_DESC_LEN(CHANNELS), TUSB_DESC_CS_INTERFACE, AUDIO_CS_AC_INTERFACE_FEATURE_UNIT, _unitid, _srcid, \
+  /*master*/UAC2_FU_CTRL_MUTE_VOL, /*ch1..N*/UAC2_FU_CTRL_REPEAT(CHANNELS), _stridx
+
+// AS Alt1..N：按表展开，仅格式与包长不同。X 宏只收表里的参数，功能号靠每个功能一份的包装宏带进去
+#define UAC2_DESC_ALT_(_f, _name, _type, _bytes, _bits) \
+  UAC2_DESC_AS_ALT(_f, _name, _type, _bytes, _bits, UAC2_ALT_EP_SIZE(_bytes)),
+#define UAC2_DESC_ALT_F0_(_name, _type, _bytes, _bits, _fmt)  UAC2_DESC_ALT_(0, _name, _type, _bytes, _bits)
+#define UAC2_DESC_ALT_F1_(_name, _type, _bytes, _bits, _fmt)  UAC2_DESC_ALT_(1, _name, _type, _bytes, _bits)
+#define UAC2_DESC_ALT_F2_(_name, _type, _bytes, _bits, _fmt)  UAC2_DESC_ALT_(2, _name, _type, _bytes, _bits)
+
+// AC 类特定部分（Header 之后）：CLK + IT + OT + FU
+#define UAC2_AC_CS_LEN  ( TUD_AUDIO_DESC_CLK_SRC_LEN + TUD_AUDIO_DESC_INPUT_TERM_LEN \
+                        + TUD_AUDIO_DESC_OUTPUT_TERM_LEN + UAC2_FU_DESC_LEN(CHANNELS) )
+
+// 一个完整的麦克风功能（IAD + AC + 中断 EP + AS Alt0..N）；_f 须是字面量 0..2（拼接 Alt 包装宏）。
+// 各功能的实体 ID 相同，接口号/端点号按 _f 错开
+#define UAC2_DESC_FUNC(_f) \
+  TUD_AUDIO_DESC_IAD(ITF_NUM_AUDIO_CONTROL_N(_f), 0x02, UAC2_STR_FUNC(_f)), \
+  TUD_AUDIO_DESC_STD_AC(ITF_NUM_AUDIO_CONTROL_N(_f), /*nEPs*/0x01, UAC2_STR_FUNC(_f)), \
+  /* AC Header：CLK→IT→FU→OT。totallen = CLK+IT+OT+FU。bmControls：Latency 只读（各 Terminal 的 TE_LATENCY 可读） */ \
+  TUD_AUDIO_DESC_CS_AC(/*bcdADC*/0x0200, /*category*/AUDIO_FUNC_MICROPHONE, /*totallen*/UAC2_AC_CS_LEN, \
+                       /*ctrl*/(AUDIO_CTRL_R << AUDIO_CS_AS_INTERFACE_CTRL_LATENCY_POS)), \
+  TUD_AUDIO_DESC_CLK_SRC(/*clkid*/UAC2_CLK_ID, /*attr*/AUDIO_CLOCK_SOURCE_ATT_INT_VAR_CLK, \
+                         /*ctrl*/(AUDIO_CTRL_RW << AUDIO_CLOCK_SOURCE_CTRL_CLK_FRQ_POS) \
+                               | (AUDIO_CTRL_R << AUDIO_CLOCK_SOURCE_CTRL_CLK_VAL_POS), \
+                         /*assocTerm*/UAC2_IT_ID, /*stridx*/0x00), \
+  TUD_AUDIO_DESC_INPUT_TERM(/*termid*/UAC2_IT_ID, /*termtype*/AUDIO_TERM_TYPE_IN_GENERIC_MIC, \
+                            /*assocTerm*/UAC2_OT_ID, /*clkid*/UAC2_CLK_ID, \
+                            /*nchannelslogical*/CHANNELS, /*channelcfg*/CHANNEL_CONFIG, \
+                            /*idxchannelnames*/0x00, /*ctrl*/(AUDIO_CTRL_R << AUDIO_IN_TERM_CTRL_CONNECTOR_POS), /*stridx*/0x00), \
+  TUD_AUDIO_DESC_OUTPUT_TERM(/*termid*/UAC2_OT_ID, /*termtype*/AUDIO_TERM_TYPE_USB_STREAMING, \
+                             /*assocTerm*/UAC2_IT_ID, /*srcid*/UAC2_FU_ID, /*clkid*/UAC2_CLK_ID, /*ctrl*/0x0000, /*stridx*/0x00), \
+  UAC2_DESC_FEATURE_UNIT_N_CHANNEL(/*unitid*/UAC2_FU_ID, /*srcid*/UAC2_IT_ID, /*str*/0x00), \
+  /* AC 中断端点（状态消息，1 ms 轮询） */ \
+  TUD_AUDIO_DESC_STD_AC_INT_EP(/*ep*/EPNUM_AUDIO_INT_N(_f), /*interval*/0x01), \
+  /* AS Alt0：0 带宽 */ \
+  TUD_AUDIO_DESC_STD_AS_INT(/*itf*/(uint8_t)(ITF_NUM_AUDIO_STREAMING_N(_f)), /*alt*/0x00, /*nEPs*/0x00, /*str*/0x00), \
+  /* AS Alt1..N */ \
+  UAC2_ALT_TABLE(UAC2_DESC_ALT_F##_f##_)
+
+static const uint8_t _cfg_audio[] = {
   // Config header
-  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN_DUAL_ALT, 0x80, 250),
-// 先放“单位宽”模板（我们选 16bit 做 Alt1）
-  TUD_AUDIO_DESC_IAD(ITF_NUM_AUDIO_CONTROL, 0x02, 0x00),
-  TUD_AUDIO_DESC_STD_AC(ITF_NUM_AUDIO_CONTROL, 0x00, 0x00),
-// AC Header：CLK→IT→FU→OT。totallen = CLK+IT+OT+FU。
-  TUD_AUDIO_DESC_CS_AC(/*bcdADC*/0x0200, /*category*/AUDIO_FUNC_MICROPHONE,
-                       /*totallen*/ TUD_AUDIO_DESC_CLK_SRC_LEN
-                                   + TUD_AUDIO_DESC_INPUT_TERM_LEN
-                                   + TUD_AUDIO_DESC_OUTPUT_TERM_LEN
-                                   + TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN,
-                       /*ctrl*/AUDIO_CS_AS_INTERFACE_CTRL_LATENCY_POS),
-  TUD_AUDIO_DESC_CLK_SRC(/*clkid*/UAC2_CLK_ID, /*attr*/AUDIO_CLOCK_SOURCE_ATT_INT_VAR_CLK,
-                         /*ctrl*/(AUDIO_CTRL_RW << AUDIO_CLOCK_SOURCE_CTRL_CLK_FRQ_POS),
-                         /*assocTerm*/UAC2_IT_ID, /*stridx*/0x00),
-  TUD_AUDIO_DESC_INPUT_TERM(/*termid*/UAC2_IT_ID, /*termtype*/AUDIO_TERM_TYPE_IN_GENERIC_MIC,
-                            /*assocTerm*/UAC2_OT_ID, /*clkid*/UAC2_CLK_ID,
-                            /*nchannelslogical*/0x01, /*channelcfg*/AUDIO_CHANNEL_CONFIG_NON_PREDEFINED,
-                            /*idxchannelnames*/0x00, /*ctrl*/(AUDIO_CTRL_RW << AUDIO_IN_TERM_CTRL_CONNECTOR_POS), /*stridx*/0x00),
-  TUD_AUDIO_DESC_OUTPUT_TERM(/*termid*/UAC2_OT_ID, /*termtype*/AUDIO_TERM_TYPE_USB_STREAMING,
-                             /*assocTerm*/UAC2_IT_ID, /*srcid*/UAC2_FU_ID, /*clkid*/UAC2_CLK_ID, /*ctrl*/0x0000, /*stridx*/0x00),
-  TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL(/*unitid*/UAC2_FU_ID, /*srcid*/UAC2_IT_ID,
-      /*master*/ (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_MUTE_POS)
-               | (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_VOLUME_POS),
-      /*ch1*/    (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_MUTE_POS)
-               | (AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_VOLUME_POS),
-      /*str*/0x00),
-
-  // AS Alt0：0 带宽
-  TUD_AUDIO_DESC_STD_AS_INT(/*itf*/(uint8_t)(ITF_NUM_AUDIO_STREAMING), /*alt*/0x00, /*nEPs*/0x00, /*str*/0x00),
-
-  // AS Alt1：16-bit
-  TUD_AUDIO_DESC_STD_AS_INT(/*itf*/(uint8_t)(ITF_NUM_AUDIO_STREAMING), /*alt*/0x01, /*nEPs*/0x01, /*str*/0x00),
-  TUD_AUDIO_DESC_CS_AS_INT(/*termid*/UAC2_OT_ID, /*ctrl*/AUDIO_CTRL_NONE,
-                           /*formattype*/AUDIO_FORMAT_TYPE_I,
-                           /*formats*/AUDIO_DATA_FORMAT_TYPE_I_PCM,
-                           /*nchannelsphysical*/0x01, /*channelcfg*/AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, /*str*/0x00),
-  TUD_AUDIO_DESC_TYPE_I_FORMAT(/*subslot*/BYTES_PER_SAMPLE_16, /*bits*/BITS_USED_16),
-  // 等时 IN（Iso + Async + Data）
-  TUD_AUDIO_DESC_STD_AS_ISO_EP(/*ep*/EPNUM_AUDIO_IN,
-      /*attr*/(uint8_t)((uint8_t)TUSB_XFER_ISOCHRONOUS
-                      | (uint8_t)TUSB_ISO_EP_ATT_ASYNCHRONOUS
-                      | (uint8_t)TUSB_ISO_EP_ATT_DATA),
-      /*maxEPsize*/EP_SZ_16, /*interval*/0x01),
-  TUD_AUDIO_DESC_CS_AS_ISO_EP(/*attr*/AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK,
-      /*ctrl*/AUDIO_CTRL_NONE, /*lockunit*/AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED, /*lockdelay*/0x0000),
-
-  // AS Alt2：24-bit（再追加一套）
-  TUD_AUDIO_DESC_STD_AS_INT(/*itf*/(uint8_t)(ITF_NUM_AUDIO_STREAMING), /*alt*/0x02, /*nEPs*/0x01, /*str*/0x00),
-  TUD_AUDIO_DESC_CS_AS_INT(/*termid*/UAC2_OT_ID, /*ctrl*/AUDIO_CTRL_NONE,
-                           /*formattype*/AUDIO_FORMAT_TYPE_I,
-                           /*formats*/AUDIO_DATA_FORMAT_TYPE_I_PCM,
-                           /*nchannelsphysical*/0x01, /*channelcfg*/AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, /*str*/0x00),
-  TUD_AUDIO_DESC_TYPE_I_FORMAT(/*subslot*/BYTES_PER_SAMPLE_24, /*bits*/BITS_USED_24),
-  TUD_AUDIO_DESC_STD_AS_ISO_EP(/*ep*/EPNUM_AUDIO_IN,
-      /*attr*/(uint8_t)((uint8_t)TUSB_XFER_ISOCHRONOUS
-                      | (uint8_t)TUSB_ISO_EP_ATT_ASYNCHRONOUS
-                      | (uint8_t)TUSB_ISO_EP_ATT_DATA),
-      /*maxEPsize*/EP_SZ_24, /*interval*/0x01),
-  TUD_AUDIO_DESC_CS_AS_ISO_EP(/*attr*/AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK,
-      /*ctrl*/AUDIO_CTRL_NONE, /*lockunit*/AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED, /*lockdelay*/0x0000),
+  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x80, 250),
+  UAC2_DESC_FUNC(0)
+#if UAC2_FUNCS > 1
+  UAC2_DESC_FUNC(1)
+#endif
+#if UAC2_FUNCS > 2
+  UAC2_DESC_FUNC(2)
+#endif
 };
+_Static_assert(sizeof(_cfg_audio) == CONFIG_TOTAL_LEN, "CONFIG_TOTAL_LEN out of sync with descriptor");
+_Static_assert(sizeof(_cfg_audio) - TUD_CONFIG_DESC_LEN == UAC2_FUNCS * CFG_TUD_AUDIO_FUNC_1_DESC_LEN,
+               "CFG_TUD_AUDIO_FUNC_1_DESC_LEN out of sync with descriptor");
+_Static_assert(CONFIG_TOTAL_LEN <= 0xFFFF && UAC2_AC_CS_LEN <= 0xFFFF, "wTotalLength overflow");
+// EP IN 软件 FIFO：预填 N 帧时深度设为 2N 帧（src/ep_in.c），N 取上限、最宽 Alt 时也要放得下
+_Static_assert(CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ >= 2 * CFG_MIC_PREFILL_MAX_FRAMES * EP_SZ_MAX,
+               "EP IN software FIFO cannot hold 2 x CFG_MIC_PREFILL_MAX_FRAMES frames of the widest alt");
+// RP2040 的 USB DPRAM：除 EP0 外约 3712 字节给端点缓冲，按 64 字节向上取整分配；
+// 每个功能 = 最宽 Alt 的 ISO IN + 一个中断 IN
+#define UAC2_DPRAM_ROUND(_n)  ((((_n) + 63) / 64) * 64)
+_Static_assert(UAC2_FUNCS * (UAC2_DPRAM_ROUND(EP_SZ_MAX) + UAC2_DPRAM_ROUND(sizeof(audio_interrupt_data_t))) <= 3712,
+               "endpoint buffers of all functions exceed the RP2040 USB DPRAM");
 
 // 返回配置描述符
 const uint8_t* tud_descriptor_configuration_cb(uint8_t index) {
   (void)index;
-  uint16_t len = sizeof(_cfg_audio_dual);
-  printf("[DESC] config requested, total_len=%u bytes\n", len);
-  // 仅第一次返回时 dump（避免刷屏）。用一个静态标志。
-  static bool dumped = false;
-  if (!dumped) {
-    // 打印前 9 字节 Config 头，确认 wTotalLength / bNumInterfaces
-    explain_cfg_header(_cfg_audio_dual);
-    // 打印整个配置 + 解释 AC Header 的 wTotalLength
-    dump_hex(_cfg_audio_dual, len, "CONFIG+IAD+AC+AS");
-    explain_ac_header(_cfg_audio_dual, len);
-    // 基本一致性检查
-    uint16_t wTotal = _cfg_audio_dual[2] | (_cfg_audio_dual[3] << 8);
-    if (wTotal != len) {
-      printf("[ERR ] Config.wTotalLength(%u) != builder_len(%u)\n", wTotal, len);
-    }
-    // Audio 函数期望长度（供驱动内部使用）是否与实际一致
-#ifdef CFG_TUD_AUDIO_FUNC_1_DESC_LEN
-  if (CFG_TUD_AUDIO_FUNC_1_DESC_LEN != len - TUD_CONFIG_DESC_LEN) {
-    printf("[WARN] CFG_TUD_AUDIO_FUNC_1_DESC_LEN=%u != function_len=%u\n",
-           (unsigned)CFG_TUD_AUDIO_FUNC_1_DESC_LEN, len - TUD_CONFIG_DESC_LEN);
-  }
-#endif
-    dumped = true;
- }
-  (void)len;
-  return _cfg_audio_dual;
+  EVLOG2(EV_DESC_CONFIG, 0, sizeof(_cfg_audio));
+  return _cfg_audio;
 }
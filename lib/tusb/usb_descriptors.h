@@ -1,41 +1,88 @@
 #ifndef __USB_DESCRIPTORS_H__
 #define __USB_DESCRIPTORS_H__
 #include "pico/stdlib.h"
+#include "uac2_rates.h"
 
-// —— 接口号（示例，按你工程里实际为准）——
+// —— 虚拟麦克风个数（见 uac2_rates.h）：每个功能占一对接口（AC + AS）和一对端点（ISO IN + 中断 IN）——
+#define UAC2_FUNCS  CFG_MIC_FUNCS
+
+// —— 接口号：功能 f 的 AC = 2f，AS = 2f + 1 ——
+#define ITF_NUM_AUDIO_CONTROL_N(_f)    (2 * (_f))
+#define ITF_NUM_AUDIO_STREAMING_N(_f)  (2 * (_f) + 1)
+#define UAC2_ITF_FUNC(_itf)            ((_itf) / 2)        // 接口号 → 功能号
 enum {
-  ITF_NUM_AUDIO_CONTROL = 0,
-  ITF_NUM_AUDIO_STREAMING,
-  ITF_NUM_TOTAL
+  ITF_NUM_AUDIO_CONTROL   = ITF_NUM_AUDIO_CONTROL_N(0),     // 功能 0（单麦克风时就是全部）
+  ITF_NUM_AUDIO_STREAMING = ITF_NUM_AUDIO_STREAMING_N(0),
+  ITF_NUM_TOTAL           = 2 * UAC2_FUNCS
 };
 
-// —— 端点号（示例，按你工程里实际为准）——
-#define EPNUM_AUDIO_IN  0x81
+// —— 端点号：功能 f 的 ISO IN = 0x81 + 2f，AC 中断 IN = 0x82 + 2f ——
+#define EPNUM_AUDIO_IN_N(_f)   (0x81 + 2 * (_f))
+#define EPNUM_AUDIO_INT_N(_f)  (0x82 + 2 * (_f))   // AC 中断端点：控制值变化时向主机发 6 字节状态消息
+#define EPNUM_AUDIO_IN         EPNUM_AUDIO_IN_N(0)
+#define EPNUM_AUDIO_INT        EPNUM_AUDIO_INT_N(0)
 
-// —— UAC2 实体 ID：保持与描述符一致 —— 
+// —— UAC2 实体 ID：保持与描述符一致；每个功能用同一组 ID（实体请求按 wIndex 的接口号区分功能）——
 #define UAC2_CLK_ID  0x10  // Clock Source ID
 #define UAC2_FU_ID   0x20  // Feature Unit ID（含 Mute/Volume）
 #define UAC2_IT_ID   0x30  // Input Terminal
 #define UAC2_OT_ID   0x40  // Output Terminal
 
-// --AS Alt和传输位数的关系
+// —— AS 备用设置表（唯一来源）——
+// 描述符里的 Alt1..N、各 Alt 的 EP 包长、Alt → 打包格式的映射都由这里展开；加一种格式只改这一处。
+// X(alt 名, 格式类型, 每样本字节 subslot, 有效位数, pcm_fmt_t)，按 Alt 号升序（Alt0 = 停流，不在表里）
+#define UAC2_ALT_TABLE(X) \
+  X(AS_ALT1_16BIT,   AUDIO_DATA_FORMAT_TYPE_I_PCM,        2, 16, PCM_FMT_S16) \
+  X(AS_ALT2_24BIT,   AUDIO_DATA_FORMAT_TYPE_I_PCM,        3, 24, PCM_FMT_S24) \
+  X(AS_ALT3_32BIT,   AUDIO_DATA_FORMAT_TYPE_I_PCM,        4, 32, PCM_FMT_S32) \
+  X(AS_ALT4_FLOAT32, AUDIO_DATA_FORMAT_TYPE_I_IEEE_FLOAT, 4, 32, PCM_FMT_F32)
+
+#define UAC2_ALT_ENUM_(_name, _type, _bytes, _bits, _fmt)  _name,
 enum {
   AS_ALT0_STOP = 0,
-  AS_ALT1_16BIT,
-  AS_ALT2_24BIT
+  UAC2_ALT_TABLE(UAC2_ALT_ENUM_)
+  AS_ALT_COUNT
 };
 
-#define ALT2_BLOCK_LEN  ( TUD_AUDIO_DESC_STD_AS_INT_LEN \
+// —— 流格式：CFG_MIC_CHANNELS 通道（见 uac2_rates.h）——
+#define CHANNELS              CFG_MIC_CHANNELS
+#if CHANNELS == 2
+#define CHANNEL_CONFIG        (AUDIO_CHANNEL_CONFIG_FRONT_LEFT | AUDIO_CHANNEL_CONFIG_FRONT_RIGHT)
+#else
+#define CHANNEL_CONFIG        AUDIO_CHANNEL_CONFIG_NON_PREDEFINED   // 多麦阵列：无预定义空间位置
+#endif
+
+// EP 最大包长：按采样率表最大值算（FS：每 1ms 向上取整再 +1 个样本，与 TUD_AUDIO_EP_SIZE 一致）
+// 纯算术表达式，tusb_config.h 和 #if 里都能用
+#define UAC2_EP_SIZE(_fs, _bytes, _ch)  (((((_fs) + 999) / 1000) + 1) * (_bytes) * (_ch))
+#define UAC2_ALT_EP_SIZE(_bytes)        UAC2_EP_SIZE(UAC2_RATE_MAX, (_bytes), CHANNELS)   // 1ch@192k 24bit: 579
+// 表中最宽的 subslot：各 Alt 的字节数按位或成掩码再取最高位（仍是常量表达式）
+#define UAC2_ALT_BYTES_BIT_(_name, _type, _bytes, _bits, _fmt)  | (1 << (_bytes))
+#define UAC2_ALT_BYTES_MASK   (0 UAC2_ALT_TABLE(UAC2_ALT_BYTES_BIT_))
+#define UAC2_ALT_BYTES_MAX    (UAC2_ALT_BYTES_MASK >= 16 ? 4 : UAC2_ALT_BYTES_MASK >= 8 ? 3 : UAC2_ALT_BYTES_MASK >= 4 ? 2 : 1)
+#define EP_SZ_MAX             UAC2_ALT_EP_SIZE(UAC2_ALT_BYTES_MAX)
+#define EP_SZ_FS_ISO_LIMIT    1023                                               // 全速 ISO 单包上限
+
+// Feature Unit：Master + 每通道各一组 Mute/Volume 控制位
+#define UAC2_FU_DESC_LEN(_nch)  (6 + ((_nch) + 1) * 4)
+
+// 音频功能描述符总长（IAD + AC + 中断 EP + AS Alt0..N）：TUD_AUDIO_MIC_ONE_CH_DESC_LEN 已含 Alt0/Alt1，
+// FU 按通道数展开，其余每个 Alt 追加一个 AS_ALT_BLOCK_LEN
+#define UAC2_FUNC_DESC_LEN  ( TUD_AUDIO_MIC_ONE_CH_DESC_LEN \
+                            - TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN \
+                            + UAC2_FU_DESC_LEN(CHANNELS) \
+                            + TUD_AUDIO_DESC_STD_AC_INT_EP_LEN \
+                            + (AS_ALT_COUNT - 2) * AS_ALT_BLOCK_LEN )
+
+#define AS_ALT_BLOCK_LEN  ( TUD_AUDIO_DESC_STD_AS_INT_LEN \
                         + TUD_AUDIO_DESC_CS_AS_INT_LEN \
                         + TUD_AUDIO_DESC_TYPE_I_FORMAT_LEN \
                         + TUD_AUDIO_DESC_STD_AS_ISO_EP_LEN \
                         + TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN )
 
-#define CONFIG_TOTAL_LEN_DUAL_ALT (TUD_CONFIG_DESC_LEN \
-                                 + TUD_AUDIO_MIC_ONE_CH_DESC_LEN \
-                                 + ALT2_BLOCK_LEN)
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + UAC2_FUNCS * UAC2_FUNC_DESC_LEN)
 
 // 配置描述符回调
 extern const uint8_t* tud_descriptor_configuration_cb(uint8_t index);
-extern const uint16_t TUD_AUDIO_MIC_DESC_LEN;
+
 #endif
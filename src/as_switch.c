@@ -0,0 +1,104 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "usb_descriptors.h"
+#include "audio_engine.h"
+#include "ep_in.h"
+#include "evlog.h"
+#include "as_switch.h"
+
+typedef struct {
+  as_sw_state_t state;
+  pcm_fmt_t     fmt;       // ARMED / RUNNING 的格式（停流后保留，作为下一次的猜测）
+  uint32_t      fs;
+  as_sw_state_t resume;    // SUSPENDED：挂起前的状态
+} sw_t;
+
+static sw_t s_sw[UAC2_FUNCS];
+
+// 唤醒 core1 并自旋等它应用配置、生成到目标深度；返回等待的微秒数
+static uint32_t wait_ready(uint8_t func) {
+  uint32_t t0 = time_us_32();
+  __sev();
+  while (!audio_engine_ready(func) && time_us_32() - t0 < CFG_MIC_SWITCH_WAIT_US) tight_loop_contents();
+  return time_us_32() - t0;
+}
+
+static void arm(uint8_t func, pcm_fmt_t fmt, uint32_t fs) {
+  sw_t* w  = &s_sw[func];
+  w->fmt   = fmt;
+  w->fs    = fs;
+  w->state = AS_SW_ARMED;
+  audio_engine_flush(func);                   // 旧数据不再需要，给预生成腾出环空间
+  audio_engine_preroll(func, fmt, fs);
+  ep_in_prepare(func, fmt, fs);
+  __sev();                                    // 停流时没有 tx_done 唤醒 core1
+  EVLOG2(EV_AS_ARM, EVLOG_FUNC(func, fmt), fs);
+}
+
+void as_switch_init(uint8_t func, pcm_fmt_t fmt, uint32_t fs) {
+  s_sw[func].state = AS_SW_STOPPED;
+  arm(func, fmt, fs);
+}
+
+void as_switch_rate(uint8_t func, uint32_t fs) {
+  sw_t* w = &s_sw[func];
+  if (w->state != AS_SW_RUNNING) {
+    if (w->fmt != PCM_FMT_NONE) arm(func, w->fmt, fs);
+    return;
+  }
+  w->fs = fs;
+  audio_engine_configure(func, w->fmt, fs);
+  uint32_t waited = wait_ready(func);
+  ep_in_start(func, w->fmt, fs);              // 流进行中改采样率：重新预填
+  __sev();
+  EVLOG3(EV_AS_OPEN, EVLOG_FUNC(func, w->fmt), 2, waited);
+}
+
+void as_switch_open(uint8_t func, pcm_fmt_t fmt, uint32_t fs) {
+  if (fmt == PCM_FMT_NONE) {
+    as_switch_close(func);
+    return;
+  }
+  sw_t* w = &s_sw[func];
+  bool hit = w->state == AS_SW_ARMED && fmt == w->fmt && fs == w->fs;
+  ep_in_stats_t st;
+  ep_in_get_stats(func, &st);
+  audio_engine_set_prefill(func, st.target_frames);
+  w->fmt   = fmt;
+  w->fs    = fs;
+  w->state = AS_SW_RUNNING;
+  audio_engine_configure(func, fmt, fs);      // 与预生成参数相同时只把它转为开流
+  uint32_t waited = wait_ready(func);
+  ep_in_start(func, fmt, fs);                 // 清 FIFO、按新格式设深度并立即预填
+  __sev();                                    // 预填取走了环里的数据：第一个 tx_done 之前就让 core1 补上
+  EVLOG3(EV_AS_OPEN, EVLOG_FUNC(func, fmt), hit, waited);
+}
+
+void as_switch_close(uint8_t func) {
+  ep_in_stop(func);
+  if (s_sw[func].state == AS_SW_RUNNING) arm(func, s_sw[func].fmt, s_sw[func].fs);
+}
+
+void as_switch_suspend(uint8_t func) {
+  sw_t* w = &s_sw[func];
+  if (w->state == AS_SW_SUSPENDED) return;
+  w->resume = w->state;
+  w->state  = AS_SW_SUSPENDED;
+  ep_in_stop(func);
+  audio_engine_preroll(func, PCM_FMT_NONE, w->fs);   // 生产者停下（实时源停采），fmt/fs 留着恢复时用
+  audio_engine_flush(func);
+  __sev();                                    // 让 core1 应用停流配置后回到 WFE
+  EVLOG2(EV_AS_SUSPEND, EVLOG_FUNC(func, w->fmt), w->resume);
+}
+
+void as_switch_resume(uint8_t func) {
+  sw_t* w = &s_sw[func];
+  if (w->state != AS_SW_SUSPENDED) return;
+  w->state = AS_SW_STOPPED;
+  if (w->resume == AS_SW_RUNNING)    as_switch_open(func, w->fmt, w->fs);   // 主机接着收这条流：生成并预填
+  else if (w->resume == AS_SW_ARMED) arm(func, w->fmt, w->fs);
+}
+
+as_sw_state_t as_switch_state(uint8_t func) {
+  return s_sw[func].state;
+}
@@ -0,0 +1,40 @@
+#ifndef __AS_SWITCH_H__
+#define __AS_SWITCH_H__
+#include <stdint.h>
+#include "pcm_pack.h"
+
+// ===== AS 接口切换状态机 =====
+// Windows 每次改格式都走 Alt1/2 → Alt0 → SET_CUR(采样率) → Alt1/2。目标是 SET_INTERFACE 之后第一包就有声：
+//   STOPPED ──init──▶ ARMED(fmt, fs) ──open 同参数──▶ RUNNING(fmt, fs)
+//   RUNNING ──close / Alt0──▶ ARMED(fmt, fs) ──SET_CUR──▶ ARMED(fmt, fs')
+// * ARMED：core1 已按 (fmt, fs) 把环填到目标深度，EP IN 的包长调度也已算好；fmt 取上一次开流的格式
+//   （上电时是 Alt1），主机重开同一个 Alt 时预生成的数据直接用于预填，不再等 core1；
+// * open 的参数与 ARMED 不同（换了 Alt）时重新配置，短暂自旋等 core1 应答并生成（≤ CFG_MIC_SWITCH_WAIT_US），
+//   超时才用静音预填；
+// * 流中 SET_CUR：同样先等 core1 切到新采样率再重新预填。
+// 振荡器相位在所有切换中连续（只改步进不复位相位）。
+// 总线挂起时任何状态 ──suspend──▶ SUSPENDED：停发、停止生成（PDM 停采）、丢弃环里的数据，core1 回到 WFE；
+//   ──resume──▶ 挂起前的状态：ARMED 重新预生成；RUNNING 立即按原参数开流并预填，恢复后的第一包就有数据。
+// 每个虚拟麦克风（func）一台独立的状态机；全部在 core0 的控制回调（tud_task 上下文）里调用。
+
+#ifndef CFG_MIC_SWITCH_WAIT_US
+#define CFG_MIC_SWITCH_WAIT_US   200
+#endif
+
+typedef enum { AS_SW_STOPPED = 0, AS_SW_ARMED, AS_SW_RUNNING, AS_SW_SUSPENDED } as_sw_state_t;
+
+// 上电：按默认格式/采样率预生成（core1 启动前调用）
+void as_switch_init(uint8_t func, pcm_fmt_t fmt, uint32_t fs);
+// SET_CUR(SAM_FREQ)
+void as_switch_rate(uint8_t func, uint32_t fs);
+// SET_INTERFACE：fmt = PCM_FMT_NONE 表示 Alt0
+void as_switch_open(uint8_t func, pcm_fmt_t fmt, uint32_t fs);
+// tud_audio_set_itf_close_ep_cb
+void as_switch_close(uint8_t func);
+// tud_suspend_cb / tud_resume_cb
+void as_switch_suspend(uint8_t func);
+void as_switch_resume(uint8_t func);
+
+as_sw_state_t as_switch_state(uint8_t func);
+
+#endif
@@ -0,0 +1,349 @@
+#include <string.h>
+#include "audio_engine.h"
+#include "dds.h"
+#include "gain.h"
+#include "evlog.h"
+#include "flash_src.h"
+#include "resampler.h"
+#include "pdm_capture.h"
+#include "pdm_decim.h"
+#include "latprobe.h"
+#include "requant.h"
+
+#define TONE_FREQ_HZ     440
+#define TONE_STEP_HZ     220                       // 第 k 通道 = 440 + 220*k Hz，便于主机侧区分通道
+#define TONE_FUNC_STEP_HZ 37                       // 第 f 条流（虚拟麦克风）整体再上移 37*f Hz（素数：与常用采样率少公因子）
+#define PRODUCE_CHUNK    32                        // 每次生成的帧数（4 的倍数，满足 24-bit 整字打包）
+#define TONE_LEVEL_SHIFT 1                         // 测试音电平 0.5 FS（-6 dBFS）；录音按原电平播放
+
+_Static_assert(PRODUCE_CHUNK <= RS_BLOCK, "resampler block smaller than the produce chunk");
+_Static_assert(PRODUCE_CHUNK <= PDM_BLOCK, "PDM decimator block smaller than the produce chunk");
+_Static_assert(PRODUCE_CHUNK <= 32 && CFG_MIC_RING_SZ >= AUDIO_RING_WORST, "PCM ring cannot hold two targets plus two chunks");
+_Static_assert(PDM_CAPTURE_HALF % (PRODUCE_CHUNK * PDM_OSR_LOW / 8) == 0, "PDM block must not straddle the capture buffer");
+
+#define LOAD_ACQ(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_REL(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+// 每条流（= 一个 UAC2 功能）的全部状态
+typedef struct {
+  uint8_t    ring_buf[CFG_MIC_RING_SZ] __attribute__((aligned(4)));
+  pcm_ring_t ring;
+
+  // 控制面 → 生产者：seqlock（奇数 = 正在写）
+  volatile uint32_t cfg_seq;
+  volatile uint8_t  cfg_fmt;
+  volatile uint32_t cfg_fs;
+  const rs_ratio_t* volatile cfg_rs;   // 录音 → 流采样率的重采样比例（SET_CUR 时选定，只有流 0 用）
+  volatile uint8_t  cfg_live;          // 0 = 预生成（未开流），1 = 开流；单字节，不走 seqlock
+  volatile uint8_t  cfg_prefill;       // EP IN 预填帧数（单字节，原子）
+
+  // 生产者 → 消费者：已生效的配置序号 + 切换点
+  volatile uint32_t ack_seq;
+  volatile uint32_t switch_pos;
+
+  // 生产者私有状态
+  dds_t       osc[AUDIO_CHANNELS];
+  gain_t      gain[AUDIO_CHANNELS];
+  requant_ch_t rq[AUDIO_CHANNELS];     // 16-bit 重新量化的误差反馈状态
+  uint32_t    rng;                     // 抖动的 xorshift32 状态
+  uint32_t    seq;                     // 已应用的 cfg 序号
+  uint8_t     bps;                     // 0 = 停流
+  pcm_pack_fn pack;                    // 当前格式的打包内核
+  uint32_t    fs;
+  uint32_t    target;                  // 目标预生成字节数（应答前写好，消费者在 acquire 应答之后可读）
+  uint8_t     live;
+
+  // 消费者私有状态
+  uint32_t    synced_seq;
+} stream_t;
+
+static stream_t s_st[AUDIO_STREAMS];
+
+// 控制面 → 生产者：流 0 的信号源、16-bit 重新量化模式（单字节，原子）
+static volatile uint8_t  s_src_req;
+static volatile uint8_t  s_requant;
+
+// 生产者私有：录音 / PDM 只有一份，跟随流 0
+static uint8_t  s_src = AUDIO_SRC_TONE;
+static flash_src_t s_flash;     // 启动时解析，之后只由生产者推进
+static bool     s_flash_ok;
+static resampler_t s_rs;        // 录音采样率 ≠ 流采样率时使用
+static bool     s_pdm_ok;
+static pdm_decim_t s_pdm;       // osr = 0：当前采样率不支持 PDM（输出静音）
+static uint32_t s_pdm_fs;       // 采集所跟随的流采样率，0 = 停止
+static uint32_t s_pdm_overruns;
+static uint32_t s_pdm_lead;     // 采集（重新）开始后先垫的静音样本数
+
+void audio_engine_init(int dds_quality, int32_t gain_q30) {
+  for (uint32_t k = 0; k < AUDIO_STREAMS; k++) {
+    stream_t* st = &s_st[k];
+    pcm_ring_init(&st->ring, st->ring_buf, sizeof(st->ring_buf));
+    for (uint32_t c = 0; c < AUDIO_CHANNELS; c++) {
+      dds_init(&st->osc[c], (dds_quality_t)dds_quality);
+      gain_init(&st->gain[c], 0);
+      gain_set_target(&st->gain[c], gain_q30);  // 从 0 斜坡升到初始增益
+      requant_reset(&st->rq[c]);
+    }
+    st->rng = 0x2545F491u + k * 0x9E3779B9u;    // 各流的抖动互不相关（非 0）
+    st->cfg_seq = st->ack_seq = st->seq = st->synced_seq = 0;
+    st->cfg_fmt = PCM_FMT_NONE;
+    st->bps  = 0;
+    st->pack = 0;
+    st->cfg_fs  = st->fs = 0;
+    st->cfg_rs  = 0;
+    st->cfg_live = st->live = 0;
+  }
+  resampler_reset(&s_rs, 0);
+  s_src_req = s_src = AUDIO_SRC_TONE;
+  s_requant = CFG_MIC_REQUANT;
+}
+
+bool audio_engine_attach_image(const void* image, uint32_t len) {
+  s_flash_ok = flash_src_open(&s_flash, image, len);
+  resampler_table_init(s_flash_ok ? s_flash.fs : 0);   // 为录音采样率 → 每个声明的采样率预先建表
+  if (CFG_MIC_SOURCE == AUDIO_SRC_FLASH) audio_engine_set_source(AUDIO_SRC_FLASH);
+  return s_flash_ok;
+}
+
+bool audio_engine_attach_pdm(void) {
+  s_pdm_ok = pdm_capture_init();
+  if (s_pdm_ok) pdm_decim_table_init();
+  if (CFG_MIC_SOURCE == AUDIO_SRC_PDM) audio_engine_set_source(AUDIO_SRC_PDM);
+  return s_pdm_ok;
+}
+
+bool audio_engine_set_source(audio_src_t src) {
+  if (src >= AUDIO_SRC_COUNT || (src == AUDIO_SRC_FLASH && !s_flash_ok) || (src == AUDIO_SRC_PDM && !s_pdm_ok)) return false;
+  s_src_req = (uint8_t)src;
+  return true;
+}
+
+bool audio_engine_set_requant(uint16_t mode) {
+  if (mode >= REQUANT_COUNT) return false;
+  s_requant = (uint8_t)mode;
+  return true;
+}
+
+bool audio_engine_source_runs_at(uint8_t stream, uint32_t fs) {
+  return stream != 0 || s_src_req != AUDIO_SRC_PDM || pdm_osr_for(fs) != 0;
+}
+
+static void log_rate_path(void) {
+  const stream_t* st = &s_st[0];
+  if (s_src != AUDIO_SRC_FLASH || !st->fs || s_flash.fs == st->fs) return;
+  if (s_rs.r) EVLOG3(EV_SRC_RESAMPLE, s_rs.r->taps, ((uint32_t)s_rs.r->L << 16) | s_rs.r->M, st->fs);
+  else        EVLOG3(EV_SRC_RATE, 0, s_flash.fs, st->fs);
+}
+
+// 生产者：PDM 时钟跟随流 0 的（信号源, 采样率, 是否在流）变化。OSR 变了才重建 CIC 表；抽取器状态总是复位
+static void pdm_retune(void) {
+  const stream_t* st = &s_st[0];
+  uint32_t fs = (s_src == AUDIO_SRC_PDM && st->bps && st->live) ? st->fs : 0;   // 0 = 不需要采集（预生成时也不采）
+  if (fs == s_pdm_fs) return;
+  uint32_t osr = fs ? pdm_osr_for(fs) : 0;
+  pdm_decim_init(&s_pdm, osr);
+  pdm_capture_start(osr * fs);
+  s_pdm_fs   = fs;
+  // 预填取走的帧 + 目标深度，再加一块：位流按整块才能取用；采集侧先攒 PDM_CAPTURE_FILL 才放数据，这段也要垫上
+  s_pdm_lead = (fs / 1000 + 1) * (CFG_MIC_RING_TARGET_MS + st->cfg_prefill) + PRODUCE_CHUNK;
+  if (osr) s_pdm_lead += PDM_CAPTURE_FILL * 8 / osr;
+  if (fs) EVLOG3(EV_PDM_CLOCK, osr, osr * fs, fs);
+}
+
+static void cfg_write(stream_t* st, pcm_fmt_t fmt, uint32_t fs, uint8_t live) {
+  uint8_t f = (uint8_t)(fmt < PCM_FMT_COUNT ? fmt : PCM_FMT_NONE);
+  if (f != st->cfg_fmt || fs != st->cfg_fs) {
+    uint32_t seq = st->cfg_seq;
+    STORE_REL(&st->cfg_seq, seq + 1);
+    st->cfg_fmt = f;
+    st->cfg_fs  = fs;
+    st->cfg_rs  = (st == &s_st[0] && s_flash_ok) ? resampler_find(s_flash.fs, fs) : 0;   // 只查表，系数上电时已生成
+    STORE_REL(&st->cfg_seq, seq + 2);
+  }
+  STORE_REL(&st->cfg_live, live);
+}
+
+void audio_engine_configure(uint8_t stream, pcm_fmt_t fmt, uint32_t fs) {
+  cfg_write(&s_st[stream], fmt, fs, 1);
+}
+
+void audio_engine_preroll(uint8_t stream, pcm_fmt_t fmt, uint32_t fs) {
+  cfg_write(&s_st[stream], fmt, fs, 0);
+}
+
+void audio_engine_set_prefill(uint8_t stream, uint32_t frames) {
+  s_st[stream].cfg_prefill = (uint8_t)(frames < 255u ? frames : 255u);
+}
+
+void audio_engine_flush(uint8_t stream) {
+  pcm_ring_t* r = &s_st[stream].ring;
+  pcm_ring_discard_to(r, pcm_ring_head(r));
+}
+
+bool audio_engine_ready(uint8_t stream) {
+  stream_t* st = &s_st[stream];
+  if (LOAD_ACQ(&st->ack_seq) != st->cfg_seq) return false;
+  uint32_t level = pcm_ring_level(&st->ring);
+  uint32_t since = pcm_ring_head(&st->ring) - LOAD_ACQ(&st->switch_pos);
+  uint32_t need  = st->target < CFG_MIC_RING_SZ / 2 ? st->target : CFG_MIC_RING_SZ / 2;
+  return (since < level ? since : level) >= need;
+}
+
+void audio_engine_set_gain(uint8_t stream, uint8_t ch, int32_t gain_q30) {
+  if (ch < AUDIO_CHANNELS) gain_set_target(&s_st[stream].gain[ch], gain_q30);
+}
+
+// 生产者：发现新配置则应用；配置正在被写时下次再试
+static void producer_sync(stream_t* st) {
+  uint32_t seq = LOAD_ACQ(&st->cfg_seq);
+  if (seq == st->seq || (seq & 1u)) return;
+  uint8_t  fmt = st->cfg_fmt;
+  uint32_t fs  = st->cfg_fs;
+  const rs_ratio_t* rs = st->cfg_rs;
+  if (LOAD_ACQ(&st->cfg_seq) != seq) return;
+
+  uint32_t k = (uint32_t)(st - s_st);
+  st->seq  = seq;
+  st->bps  = pcm_fmt_table[fmt].bytes;
+  st->pack = pcm_fmt_table[fmt].pack;
+  if (fs != st->fs) {
+    for (uint32_t c = 0; c < AUDIO_CHANNELS; c++)
+      dds_set_freq(&st->osc[c], TONE_FREQ_HZ + TONE_STEP_HZ * c + TONE_FUNC_STEP_HZ * k, fs);
+    st->fs = fs;
+    if (k == 0) {
+      resampler_reset(&s_rs, rs);
+      log_rate_path();
+    }
+  }
+  st->target = (fs / 1000 + 1) * st->bps * AUDIO_CHANNELS * CFG_MIC_RING_TARGET_MS;
+  if (k == 0) pdm_retune();
+  STORE_REL(&st->switch_pos, pcm_ring_head(&st->ring));
+  STORE_REL(&st->ack_seq, seq);
+  EVLOG2(EV_ENGINE_CFG, EVLOG_FUNC(k, fmt), fs);
+}
+
+// 录音 → 平面 Q31（流采样率）。只对文件实有的声道做重采样，其余输出通道按 c % channels 复制
+static void render_flash(int32_t* const* planar) {
+  if (!s_rs.r) {
+    flash_src_render_q31(&s_flash, planar, AUDIO_CHANNELS, PRODUCE_CHUNK);
+    return;
+  }
+  uint32_t nch = s_flash.channels < AUDIO_CHANNELS ? s_flash.channels : AUDIO_CHANNELS;
+  int32_t* in[AUDIO_CHANNELS];
+  for (uint32_t c = 0; c < nch; c++) in[c] = resampler_in(&s_rs, c);
+  flash_src_render_q31(&s_flash, in, nch, resampler_need(&s_rs, PRODUCE_CHUNK));
+  resampler_run_q31(&s_rs, planar, nch, PRODUCE_CHUNK);
+  for (uint32_t c = nch; c < AUDIO_CHANNELS; c++) memcpy(planar[c], planar[c % nch], PRODUCE_CHUNK * sizeof(int32_t));
+}
+
+// PDM → 平面 Q31：位流不够一块时返回 false（等下一次唤醒）；采样率超出 PDM 能力时输出静音。
+// 实时源不能超前生成：开始采集后先往环里垫 CFG_MIC_RING_TARGET_MS + 一块的静音，之后消费者总是落后采集这么多，
+// 而不是每帧都在等刚到的位流。单声道麦克风复制到全部输出通道
+static bool render_pdm(int32_t* const* planar) {
+  if (!s_pdm.osr || s_pdm_lead) {
+    for (uint32_t c = 0; c < AUDIO_CHANNELS; c++) memset(planar[c], 0, PRODUCE_CHUNK * sizeof(int32_t));
+    s_pdm_lead = s_pdm_lead > PRODUCE_CHUNK ? s_pdm_lead - PRODUCE_CHUNK : 0;
+    return true;
+  }
+  uint32_t bytes = PRODUCE_CHUNK * s_pdm.osr / 8;
+  const uint8_t* bits = pdm_capture_peek(bytes);
+  pdm_capture_stats_t ps;
+  pdm_capture_get_stats(&ps);
+  if (ps.overruns != s_pdm_overruns) {
+    s_pdm_overruns = ps.overruns;
+    EVLOG2(EV_PDM_OVERRUN, 0, ps.overruns);
+  }
+  if (!bits) return false;
+  pdm_decim_run(&s_pdm, bits, planar[0], PRODUCE_CHUNK);
+  pdm_capture_release(bytes);
+  for (uint32_t c = 1; c < AUDIO_CHANNELS; c++) memcpy(planar[c], planar[0], PRODUCE_CHUNK * sizeof(int32_t));
+  return true;
+}
+
+// 流 0：跟进信号源切换（录音 / PDM 只跟随流 0）
+static void source_sync(void) {
+  uint8_t src = s_src_req;
+  if (src == s_src) return;
+  s_src = src;
+  resampler_reset(&s_rs, s_rs.r);                    // 不带着上次播放的历史
+  EVLOG3(EV_SRC_SELECT, src, s_flash.fs, s_flash.frames);
+  log_rate_path();
+  pdm_retune();
+}
+
+// 给一条流生成一块：平面生成（每通道一条连续缓冲，DDS/增益内循环不跨通道跳址）→ 交织打包 → 写环。
+// 暂存区所有流共用（生产者串行处理）
+static bool produce_stream(stream_t* st, audio_src_t src) {
+  // 只统计切换点之后的新格式数据（旧数据由消费者下一次取数时丢弃）
+  uint32_t queued = pcm_ring_level(&st->ring);
+  uint32_t since  = pcm_ring_head(&st->ring) - st->switch_pos;
+  if (since < queued) queued = since;
+  if (queued >= st->target) return false;
+  // 切换点之前的旧数据还占着环：放不下一整块就先不生成（生成了再丢会让信号源状态白白前进）
+  if (pcm_ring_space(&st->ring) < (uint32_t)st->bps * AUDIO_CHANNELS * PRODUCE_CHUNK) return false;
+
+  static int32_t  blk[AUDIO_CHANNELS][PRODUCE_CHUNK];
+  static uint32_t out[PRODUCE_CHUNK * AUDIO_CHANNELS];   // 最宽格式 4 字节/样本
+  const int32_t* planar[AUDIO_CHANNELS];
+  int32_t* planar_w[AUDIO_CHANNELS];
+  for (uint32_t c = 0; c < AUDIO_CHANNELS; c++) planar_w[c] = blk[c];
+
+  if (src == AUDIO_SRC_FLASH) render_flash(planar_w);
+  if (src == AUDIO_SRC_PDM && (!st->live || !render_pdm(planar_w))) return false;   // 实时源没法提前生成
+
+  for (uint32_t c = 0; c < AUDIO_CHANNELS; c++) {
+    if (src == AUDIO_SRC_TONE) {
+      dds_render_q31(&st->osc[c], blk[c], PRODUCE_CHUNK);
+      for (uint32_t i = 0; i < PRODUCE_CHUNK; i++) blk[c][i] >>= TONE_LEVEL_SHIFT;
+    }
+    gain_apply_q31(&st->gain[c], blk[c], PRODUCE_CHUNK);
+    planar[c] = blk[c];
+  }
+  int probe = 0;
+  if (st == &s_st[0])   // 延迟探针打开时换成标记脉冲串（增益之后：任何音量下都是原值）
+    probe = latprobe_render(planar_w, AUDIO_CHANNELS, PRODUCE_CHUNK, st->fs, pcm_ring_head(&st->ring), st->bps * AUDIO_CHANNELS);
+  // 16-bit：抖动 + 噪声整形后再截断；静音的通道保持数字零，标记脉冲串不加抖动
+  requant_fn rq = st->bps == 2 && !probe ? requant_table[s_requant] : 0;
+  for (uint32_t c = 0; rq && c < AUDIO_CHANNELS; c++)
+    if (st->gain[c].cur != 0 || st->gain[c].target != 0) rq(blk[c], PRODUCE_CHUNK, &st->rq[c], &st->rng);
+  return pcm_ring_write(&st->ring, out, st->pack(planar, AUDIO_CHANNELS, PRODUCE_CHUNK, out)) != 0;
+}
+
+bool audio_engine_produce(void) {
+  bool did = false;
+  for (uint32_t k = 0; k < AUDIO_STREAMS; k++) {   // 一轮：每条流先跟进配置，欠数据就补一块
+    stream_t* st = &s_st[k];
+    producer_sync(st);
+    uint8_t live = st->cfg_live;
+    if (live != st->live) {
+      st->live = live;
+      if (k == 0) pdm_retune();
+    }
+    if (k == 0) source_sync();
+    if (st->bps == 0) continue;
+    did |= produce_stream(st, k == 0 ? (audio_src_t)s_src : AUDIO_SRC_TONE);
+  }
+  return did;
+}
+
+uint32_t audio_engine_pop2(uint8_t stream, uint8_t* d0, uint32_t n0, uint8_t* d1, uint32_t n1) {
+  stream_t* st = &s_st[stream];
+  uint32_t ack = LOAD_ACQ(&st->ack_seq);
+  if (ack != st->cfg_seq) return 0;               // 生产者尚未切到新格式
+  if (ack != st->synced_seq) {
+    pcm_ring_discard_to(&st->ring, LOAD_ACQ(&st->switch_pos));   // 丢弃旧格式残留
+    st->synced_seq = ack;
+  }
+  uint32_t tail = pcm_ring_tail(&st->ring);
+  uint32_t n = pcm_ring_read2(&st->ring, d0, n0, d1, n1);
+  if (stream == 0 && n) latprobe_on_pop(tail, tail + n);   // 标记进 EP FIFO 的时刻
+  return n;
+}
+
+uint32_t audio_engine_pop(uint8_t stream, uint8_t* dst, uint32_t n) {
+  return audio_engine_pop2(stream, dst, n, 0, 0);
+}
+
+const pcm_ring_t* audio_engine_ring(uint8_t stream) {
+  return &s_st[stream].ring;
+}
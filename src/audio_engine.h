@@ -0,0 +1,78 @@
+#ifndef __AUDIO_ENGINE_H__
+#define __AUDIO_ENGINE_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcm_ring.h"
+#include "uac2_rates.h"
+#include "pcm_pack.h"
+
+// ===== 音频引擎：生产者（信号链）/ 消费者（USB ISR）拆分 =====
+// 生产者在 core1 上按通道平面跑 DDS → 增益，再交织打包，把现成的 PCM 字节写进 SPSC 环；
+// 消费者 tud_audio_tx_done_isr 只按 per_ms 字节数从环里取数并写 EP FIFO。
+// 格式/采样率变化走 seqlock 配置 + 应答：生产者应答后，消费者丢弃旧格式数据。
+// 每个虚拟麦克风（UAC2 功能）一条独立的流：各自的环、配置、振荡器和增益；生产者每次唤醒
+// 在一轮里把所有欠数据的流各补一块（共用平面/打包暂存区）。录音与 PDM 只有一份，固定给流 0，
+// 其余流是测试音（每条流整体错开 TONE_FUNC_STEP_HZ，主机侧能分清是哪个麦克风）。
+
+#define AUDIO_CHANNELS          CFG_MIC_CHANNELS
+#define AUDIO_STREAMS           CFG_MIC_FUNCS
+
+#ifndef CFG_MIC_RING_TARGET_MS
+#define CFG_MIC_RING_TARGET_MS  2       // 生产者保持的预生成深度
+#endif
+// 环的最坏需求（最高采样率、最宽的 4 字节样本）：切换格式时旧格式的目标深度 + 一块还没被消费者丢掉，
+// 新格式又要生成目标深度 + 一块。32 = audio_engine.c 的 PRODUCE_CHUNK 上限（那里静态断言）
+#define AUDIO_RING_WORST        (2u * 4u * AUDIO_CHANNELS * ((UAC2_RATE_MAX / 1000u + 1u) * CFG_MIC_RING_TARGET_MS + 32u))
+#ifndef CFG_MIC_RING_SZ
+#define CFG_MIC_RING_SZ         (AUDIO_RING_WORST <= 4096u ? 4096u : 8192u)   // 字节，2 的幂；1ch 192k/32bit 约 5 ms
+#endif
+
+// 信号源：DDS 测试音（默认）、flash 里的录音（flash_src.h）或 PDM 麦克风（pdm_capture.h + pdm_decim.h）
+typedef enum { AUDIO_SRC_TONE = 0, AUDIO_SRC_FLASH, AUDIO_SRC_PDM, AUDIO_SRC_COUNT } audio_src_t;
+
+#ifndef CFG_MIC_SOURCE
+#define CFG_MIC_SOURCE          AUDIO_SRC_TONE   // 上电信号源；录音镜像无效时退回测试音
+#endif
+
+// 所有流的增益都从 0 斜坡升到 gain_q30
+void     audio_engine_init(int dds_quality, int32_t gain_q30);
+// core1 启动前调用一次：解析录音镜像，返回是否可用
+bool     audio_engine_attach_image(const void* image, uint32_t len);
+// core1 启动前调用一次：占用 PDM 采集资源并设计抽取滤波器，返回是否可用
+bool     audio_engine_attach_pdm(void);
+
+// ---- 控制面（core0：SET_INTERFACE / SET_CUR）；stream = TinyUSB 的 func_id ----
+// fmt = PCM_FMT_NONE 表示停流（Alt0）；打包内核在生产者应用配置时按 fmt 查表选定一次。
+// 与当前配置相同时不重新配置：环里已生成的数据保留，振荡器相位连续
+void     audio_engine_configure(uint8_t stream, pcm_fmt_t fmt, uint32_t fs);
+// 预生成：按 (fmt, fs) 配置生产者并把环填到目标深度，但还不算开流（PDM 等实时源不采集）。
+// 之后以相同参数 configure 即转为开流，预生成的数据原样交给消费者
+void     audio_engine_preroll(uint8_t stream, pcm_fmt_t fmt, uint32_t fs);
+// 消费者侧：丢弃环里全部数据（停流后调用，给下一次预生成腾出空间）
+void     audio_engine_flush(uint8_t stream);
+// 生产者已应用最新配置且新格式数据达到目标深度（或环的一半）
+bool     audio_engine_ready(uint8_t stream);
+// 开流时 EP IN 预填会一次取走的帧数：实时源开始采集时要多垫这么多毫秒静音，否则消费者一开流就超前于采集
+void     audio_engine_set_prefill(uint8_t stream, uint32_t frames);
+// ch 为 0 起的通道号；gain 已包含 Master 与该通道的 Volume/Mute
+void     audio_engine_set_gain(uint8_t stream, uint8_t ch, int32_t gain_q30);
+// 切换流 0 的信号源（生产者下一块生效）；所选信号源不可用（无录音镜像 / 无 PDM）时返回 false
+bool     audio_engine_set_source(audio_src_t src);
+// 所有 16-bit 流的重新量化模式（requant_mode_t，生产者下一块生效）；超出范围返回 false
+bool     audio_engine_set_requant(uint16_t mode);
+// 流当前（已请求的）信号源能否在 fs 下出声：PDM 要求该采样率有可用的 OSR，其余信号源总是可以（Clock Validity 用）
+bool     audio_engine_source_runs_at(uint8_t stream, uint32_t fs);
+
+// ---- 生产者（core1 主循环）----
+// 给每条欠数据的流各生成一块；无事可做（全部停流或环已达目标深度）时返回 false
+bool     audio_engine_produce(void);
+
+// ---- 消费者（USB ISR）----
+// 取出恰好 n 字节（整帧）；数据不足或格式切换未完成时返回 0（调用方补静音）
+uint32_t audio_engine_pop(uint8_t stream, uint8_t* dst, uint32_t n);
+// 同上，直接写进两段目标（EP IN FIFO 的线性区 + 回绕区），整体 n0 + n1 字节
+uint32_t audio_engine_pop2(uint8_t stream, uint8_t* d0, uint32_t n0, uint8_t* d1, uint32_t n1);
+
+const pcm_ring_t* audio_engine_ring(uint8_t stream);
+
+#endif
@@ -0,0 +1,57 @@
+#include <math.h>
+#include "dds.h"
+
+// 四分之一波表 sin(0..π/2)，Q31。多留 2 点：镜像象限取 idx=1024，插值还要取 idx+1。
+static int32_t s_qtab[DDS_QTAB_SIZE + 2];
+
+void dds_table_init(void) {
+  for (uint32_t i = 0; i < DDS_QTAB_SIZE + 2; i++) {
+    double v = sin(M_PI / 2.0 * (double)i / (double)DDS_QTAB_SIZE) * 2147483647.0;
+    if (v > 2147483647.0) v = 2147483647.0;
+    s_qtab[i] = (int32_t)lrint(v);
+  }
+}
+
+void dds_init(dds_t* o, dds_quality_t quality) {
+  o->phase   = 0;
+  o->step    = 0;
+  o->quality = quality;
+}
+
+void dds_set_freq(dds_t* o, uint32_t freq_hz, uint32_t fs) {
+  o->step = fs ? (uint32_t)(((uint64_t)freq_hz << 32) / fs) : 0;
+}
+
+// 相位 → 象限内位置：第 1/3 象限镜像，第 2/3 象限取负
+#define DDS_QUADRANT(p)   ((p) >> 30)
+#define DDS_IN_QUAD(p, q) (((q) & 1u) ? (0x40000000u - ((p) & 0x3FFFFFFFu)) : ((p) & 0x3FFFFFFFu))
+
+static inline int32_t dds_fast(uint32_t p) {
+  uint32_t q = DDS_QUADRANT(p);
+  uint32_t x = DDS_IN_QUAD(p, q);
+  int32_t  y = s_qtab[x >> (30 - DDS_QTAB_BITS)];
+  return (q & 2u) ? -y : y;
+}
+
+static inline int32_t dds_interp(uint32_t p) {
+  uint32_t q    = DDS_QUADRANT(p);
+  uint32_t x    = DDS_IN_QUAD(p, q);
+  uint32_t idx  = x >> (30 - DDS_QTAB_BITS);
+  int32_t  frac = (int32_t)((x >> (30 - DDS_QTAB_BITS - 10)) & 0x3FF);   // 10-bit 小数
+  int32_t  y0   = s_qtab[idx];
+  // 相邻点差 < 2^22，先右移 1 位再乘 10-bit 小数，32-bit 内不溢出（M0+ 只有 32x32 乘法）
+  int32_t  d    = (s_qtab[idx + 1] - y0) >> 1;
+  int32_t  y    = y0 + ((d * frac) >> 9);
+  return (q & 2u) ? -y : y;
+}
+
+void dds_render_q31(dds_t* o, int32_t* dst, uint32_t n) {
+  uint32_t p = o->phase;
+  uint32_t s = o->step;
+  if (o->quality == DDS_QUALITY_FAST) {
+    for (uint32_t i = 0; i < n; i++) { dst[i] = dds_fast(p);   p += s; }
+  } else {
+    for (uint32_t i = 0; i < n; i++) { dst[i] = dds_interp(p); p += s; }
+  }
+  o->phase = p;
+}
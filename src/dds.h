@@ -0,0 +1,35 @@
+#ifndef __DDS_H__
+#define __DDS_H__
+#include <stdint.h>
+
+// ===== DDS（直接数字频率合成）正弦发生器 =====
+// 32-bit 相位累加器 + 四分之一波表，全程整数运算，替代 ISR 里的 sinf()/lrintf()。
+// 输出为 Q31（int32，满幅 ±2^31），由调用方再做增益和 16/24-bit 截位。
+
+#define DDS_QTAB_BITS   10                      // 四分之一周期 1024 点
+#define DDS_QTAB_SIZE   (1u << DDS_QTAB_BITS)
+
+// 精度/速度档位
+typedef enum {
+  DDS_QUALITY_FAST = 0,   // 直接查表：12-bit 有效相位，THD+N 约 -62 dB，最省周期
+  DDS_QUALITY_INTERP,     // 查表 + 线性插值：22-bit 有效相位，THD+N 约 -120 dB（默认）
+} dds_quality_t;
+
+typedef struct {
+  uint32_t      phase;    // 2^32 = 一个周期
+  uint32_t      step;     // 每样本相位增量 = f / fs * 2^32
+  dds_quality_t quality;
+} dds_t;
+
+// 上电时生成一次波表（只在初始化时用到 libm）
+void dds_table_init(void);
+
+void dds_init(dds_t* o, dds_quality_t quality);
+
+// 改频率/采样率时调用（控制面，非数据面）；相位保持连续
+void dds_set_freq(dds_t* o, uint32_t freq_hz, uint32_t fs);
+
+// 连续生成 n 个 Q31 样本；档位分支在块外只判断一次
+void dds_render_q31(dds_t* o, int32_t* dst, uint32_t n);
+
+#endif
@@ -0,0 +1,181 @@
+#include <string.h>
+#include "tusb_config.h"
+#include "tusb.h"
+#include "hardware/sync.h"
+#include "usb_descriptors.h"
+#include "audio_engine.h"
+#include "rate_sched.h"
+#include "ep_in.h"
+
+// 注：tud_audio_tx_done_isr 在 USB 中断里回调（usbd 的 xfer_isr → audiod_xfer_isr），控制请求则在 tud_task() 里。
+// 控制面开/停流时屏蔽中断再动 FIFO 与状态；流进行中改预填帧数只挂起请求，由下一次 tx_done 在中断里生效
+// ——那时 TinyUSB 刚取走下一包，直到下一帧结束前都不会再碰 FIFO。
+
+typedef enum { PUT_NONE = 0, PUT_DATA, PUT_SILENCE } put_result_t;
+
+typedef struct {
+  bool          active;
+  uint32_t      frame_bytes;     // 每个采样帧（所有通道）的字节数
+  uint32_t      fs;
+  rate_sched_t  sched;           // 每 1 ms 的样本数
+  rate_sched_t  sched0;          // 当前 (格式, 采样率) 的初始调度（ep_in_prepare 时算好）
+  uint16_t      target;          // 预填充帧数 N
+  volatile uint16_t req;         // 挂起的新 N（0 = 无），由 ep_in_service 生效
+  uint32_t      debt;            // 已被主机取走、尚未补上的帧数
+  ep_in_stats_t st;
+} ep_state_t;
+
+static ep_state_t s_ep[UAC2_FUNCS];
+
+// 把一帧（n 字节）从环写进 FIFO；环里没数据时 force 决定补静音还是放弃
+static put_result_t fifo_put(uint8_t func, tu_fifo_t* ff, uint32_t n, bool force) {
+  put_result_t r = PUT_DATA;
+#if CFG_MIC_EP_IN_ZERO_COPY
+  // 直接写进 FIFO：线性区 + 回绕区两段，从环拷入后一次提交写指针
+  tu_fifo_buffer_info_t info;
+  tu_fifo_get_write_info(ff, &info);
+  if (n > (uint32_t)info.len_lin + info.len_wrap) return PUT_NONE;
+  uint32_t n0 = n < info.len_lin ? n : info.len_lin;
+  uint8_t* d0 = (uint8_t*)info.ptr_lin;
+  uint8_t* d1 = (uint8_t*)info.ptr_wrap;
+  if (audio_engine_pop2(func, d0, n0, d1, n - n0) == 0) {
+    if (!force) return PUT_NONE;
+    memset(d0, 0, n0);
+    memset(d1, 0, n - n0);
+    r = PUT_SILENCE;
+  }
+  tu_fifo_advance_write_pointer(ff, (uint16_t)n);
+#else
+  static uint8_t buf[CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX] __attribute__((aligned(4)));   // 各功能共用（只在 USB 中断或屏蔽中断时调用）
+  if (n > sizeof(buf) || tu_fifo_remaining(ff) < n) return PUT_NONE;
+  if (audio_engine_pop(func, buf, n) == 0) {
+    if (!force) return PUT_NONE;
+    memset(buf, 0, n);
+    r = PUT_SILENCE;
+  }
+  tud_audio_n_write(func, buf, (uint16_t)n);
+#endif
+  return r;
+}
+
+// 帧长流控把水位拉向 FIFO 深度的一半：深度 = 2 × N 帧（按当前格式），复用驱动的静态缓冲。
+// 只在 TinyUSB 不会碰 FIFO 的时候调用：屏蔽中断时，或 tx_done 回调里
+static uint16_t fifo_set_depth(tu_fifo_t* ff, uint32_t depth) {
+  if (depth > CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ) depth = CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ;
+  tu_fifo_clear(ff);
+  tu_fifo_buffer_info_t info;
+  tu_fifo_get_write_info(ff, &info);                          // 清空后写指针在缓冲起点
+  tu_fifo_config(ff, info.ptr_lin, (uint16_t)depth, 1, true); // 与 audiod_init 相同：1 字节元素、可覆盖
+  return (uint16_t)depth;
+}
+
+static inline uint32_t bytes_to_us(const ep_state_t* e, uint32_t bytes) {
+  uint32_t bps = e->fs * e->frame_bytes;
+  return bps ? (uint32_t)((uint64_t)bytes * 1000000u / bps) : 0;
+}
+
+// 重新设定深度并立即预填 N 帧（环里还没有新格式数据时就是静音）；调用约束同 fifo_set_depth
+static void prime(uint8_t func) {
+  ep_state_t* e  = &s_ep[func];
+  tu_fifo_t*  ff = tud_audio_n_get_ep_in_ff(func);
+  uint32_t    per_ms_bytes = (e->fs * e->frame_bytes + 999) / 1000;
+
+  memset(&e->st, 0, sizeof(e->st));
+  e->st.target_frames = e->target;
+  e->st.fifo_depth    = fifo_set_depth(ff, 2u * e->target * per_ms_bytes);
+  e->st.latency_us    = bytes_to_us(e, e->st.fifo_depth / 2u);
+  e->st.min_level     = UINT16_MAX;
+
+  e->sched = e->sched0;
+  for (uint16_t k = 0; k < e->target; k++) {
+    uint32_t n = rate_sched_next(&e->sched) * e->frame_bytes;
+    if (fifo_put(func, ff, n, true) == PUT_NONE) break;
+  }
+  e->debt   = 0;
+  e->req    = 0;
+  e->active = true;
+}
+
+void ep_in_init(void) {
+  memset(s_ep, 0, sizeof(s_ep));
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) ep_in_set_target(f, CFG_MIC_PREFILL_FRAMES);
+}
+
+static inline uint32_t fmt_frame_bytes(pcm_fmt_t fmt) {
+  return (uint32_t)pcm_fmt_table[fmt < PCM_FMT_COUNT ? fmt : PCM_FMT_NONE].bytes * CHANNELS;
+}
+
+void ep_in_prepare(uint8_t func, pcm_fmt_t fmt, uint32_t fs) {
+  ep_state_t* e = &s_ep[func];
+  uint32_t frame_bytes = fmt_frame_bytes(fmt);
+  if (frame_bytes == 0 || fs == 0 || (frame_bytes == e->frame_bytes && fs == e->fs)) return;
+  e->frame_bytes = frame_bytes;
+  e->fs          = fs;
+  rate_sched_init(&e->sched0, fs, 1, 1000);                   // 64 位约分，M0+ 上是软件除法
+}
+
+void ep_in_start(uint8_t func, pcm_fmt_t fmt, uint32_t fs) {
+  if (fmt_frame_bytes(fmt) == 0 || fs == 0) { ep_in_stop(func); return; }   // 保留上一段的统计供读回
+  ep_in_prepare(func, fmt, fs);
+  uint32_t irq = save_and_disable_interrupts();
+  prime(func);
+  restore_interrupts(irq);
+}
+
+void ep_in_stop(uint8_t func) {
+  uint32_t irq = save_and_disable_interrupts();
+  s_ep[func].active = false;
+  s_ep[func].req    = 0;
+  tud_audio_n_clear_ep_in_ff(func);
+  restore_interrupts(irq);
+}
+
+uint16_t ep_in_set_target(uint8_t func, uint16_t frames) {
+  if (frames < EP_IN_PREFILL_MIN)          frames = EP_IN_PREFILL_MIN;
+  if (frames > CFG_MIC_PREFILL_MAX_FRAMES) frames = CFG_MIC_PREFILL_MAX_FRAMES;
+  ep_state_t* e = &s_ep[func];
+  uint32_t irq = save_and_disable_interrupts();
+  if (e->active) e->req    = frames;                          // 流进行中：下一次 tx_done 重新预填
+  else           e->target = frames;
+  restore_interrupts(irq);
+  return frames;
+}
+
+void ep_in_get_stats(uint8_t func, ep_in_stats_t* out) {
+  const ep_state_t* e = &s_ep[func];
+  uint32_t irq = save_and_disable_interrupts();               // 统计由 USB 中断更新：整份拷出不撕裂
+  *out = e->st;
+  out->target_frames = e->req ? e->req : e->target;
+  restore_interrupts(irq);
+  if (out->min_level == UINT16_MAX) out->min_level = 0;      // 还没跑过一帧
+  out->min_level_us = bytes_to_us(e, out->min_level);
+}
+
+void ep_in_service(uint8_t func) {
+  ep_state_t* e = &s_ep[func];
+  if (!e->active) return;
+  if (e->req) {                                               // 挂起的预填帧数：刚取走下一包，这里重设深度并预填
+    e->target = e->req;
+    prime(func);
+    return;
+  }
+  tu_fifo_t* ff    = tud_audio_n_get_ep_in_ff(func);
+  uint32_t   level = tu_fifo_count(ff);                       // TinyUSB 已取走下一包后的水位
+  if (level < e->st.min_level) e->st.min_level = (uint16_t)level;
+
+  if (e->debt < e->target) e->debt++;                         // 每次 tx_done = 主机取走一帧
+  uint32_t wrote = 0;
+  while (e->debt && wrote < CFG_MIC_PREFILL_BATCH) {
+    rate_sched_t next = e->sched;                             // 写成功才推进调度器
+    uint32_t n = rate_sched_next(&next) * e->frame_bytes;
+    bool force = level < n;                                   // 余量撑不到下一包：补静音，避免短包/零包
+    put_result_t r = fifo_put(func, ff, n, force);
+    if (r == PUT_NONE) { if (!force) e->st.deferred++; break; }
+    if (r == PUT_SILENCE) e->st.silence_frames++;
+    e->sched = next;
+    level   += n;
+    e->debt--;
+    wrote++;
+  }
+  if (wrote > 1) e->st.batched++;
+}
@@ -0,0 +1,50 @@
+#ifndef __EP_IN_H__
+#define __EP_IN_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcm_pack.h"
+
+// ===== EP IN 预填充 =====
+// 在 TinyUSB 的 EP IN 软件 FIFO 里保持 N 帧提前量：
+// * 开流/改采样率时立即把 FIFO 深度设为 2 × N 帧（帧长流控的平衡点是半深度），并预填 N 帧；
+// * 每次 tx_done 记一帧欠账，从 core1 的环里按精确有理数调度逐帧补齐；
+//   落后时一次补多帧（上限 CFG_MIC_PREFILL_BATCH），环里没数据而 FIFO 还有余量时推迟，不立即插静音。
+// 代价是附加延迟 ≈ N ms；N 越小越容易在主机/ISR 抖动时欠载，统计里给出最低水位用来权衡。
+// 每个虚拟麦克风（func = TinyUSB 的 func_id，0..UAC2_FUNCS-1）各有一份状态和自己的 EP IN FIFO。
+
+// 1 = 从环直接拷进 EP IN FIFO（省掉暂存缓冲与一次 memcpy）；0 = 经暂存缓冲 + tud_audio_write
+#ifndef CFG_MIC_EP_IN_ZERO_COPY
+#define CFG_MIC_EP_IN_ZERO_COPY   1
+#endif
+#ifndef CFG_MIC_PREFILL_BATCH
+#define CFG_MIC_PREFILL_BATCH   4       // 单次 ISR 最多补的帧数
+#endif
+#define EP_IN_PREFILL_MIN       2       // 少于 2 帧时，TinyUSB 取包前水位可能低于最短包
+
+typedef struct __attribute__((packed)) {
+  uint16_t target_frames;     // 当前预填充帧数 N
+  uint16_t fifo_depth;        // 当前 EP IN FIFO 深度（字节）
+  uint32_t latency_us;        // 稳态附加延迟（半深度对应的时长）
+  uint16_t min_level;         // 上次预填充以来 ISR 入口处的最低 FIFO 水位（字节）
+  uint32_t min_level_us;      // 同上，换算成时长
+  uint32_t deferred;          // 环里数据未就绪、靠 FIFO 余量推迟的次数
+  uint32_t silence_frames;    // 没有余量只好补静音的帧数
+  uint32_t batched;           // 一次 ISR 补了不止 1 帧的次数
+} ep_in_stats_t;
+
+void ep_in_init(void);
+
+// 控制面：开流 / 改采样率（重新设定深度并立即预填）；fmt = PCM_FMT_NONE 等同 stop
+void ep_in_start(uint8_t func, pcm_fmt_t fmt, uint32_t fs);
+// 控制面：提前算好 (fmt, fs) 的每帧字节数与包长调度（SET_CUR 时），之后同参数的 ep_in_start 只做预填
+void ep_in_prepare(uint8_t func, pcm_fmt_t fmt, uint32_t fs);
+void ep_in_stop(uint8_t func);
+
+// 厂商请求：调整预填充帧数（夹到 [EP_IN_PREFILL_MIN, CFG_MIC_PREFILL_MAX_FRAMES]），流进行中挂起到下一次 tx_done 重新预填
+uint16_t ep_in_set_target(uint8_t func, uint16_t frames);
+void     ep_in_get_stats(uint8_t func, ep_in_stats_t* out);
+
+// 数据面：tud_audio_tx_done_isr 里调用（USB 中断上下文）
+void ep_in_service(uint8_t func);
+
+#endif
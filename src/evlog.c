@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "evlog.h"
+
+#define LOAD_ACQ(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_REL(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+_Static_assert((CFG_MIC_EVLOG_DEPTH & (CFG_MIC_EVLOG_DEPTH - 1)) == 0, "CFG_MIC_EVLOG_DEPTH must be a power of 2");
+_Static_assert(sizeof(evlog_rec_t) == 16, "evlog_rec_t layout");
+
+typedef struct {
+  evlog_rec_t       rec[CFG_MIC_EVLOG_DEPTH];
+  volatile uint32_t head;        // 生产者（本核）写
+  volatile uint32_t tail;        // 主循环写
+  volatile uint32_t dropped;     // 生产者写：环满被丢弃的条数
+  uint32_t          reported;    // 主循环：已报告过的 dropped
+} evlog_ring_t;
+
+static evlog_ring_t s_ring[EVLOG_CORES];
+
+void evlog_init(void) {
+  memset(s_ring, 0, sizeof(s_ring));
+}
+
+void evlog_put(uint16_t id, uint16_t a0, uint32_t a1, uint32_t a2) {
+  uint32_t      t    = time_us_32();
+  uint32_t      core = get_core_num() & 1u;
+  evlog_ring_t* r    = &s_ring[core];
+  uint32_t      irq  = save_and_disable_interrupts();
+  uint32_t      h    = r->head;
+  if (h - LOAD_ACQ(&r->tail) >= CFG_MIC_EVLOG_DEPTH) {
+    r->dropped++;
+  } else {
+    evlog_rec_t* e = &r->rec[h & (CFG_MIC_EVLOG_DEPTH - 1)];
+    e->t_us = t;
+    e->id   = id;
+    e->a0   = a0;
+    e->a1   = a1;
+    e->a2   = a2;
+    STORE_REL(&r->head, h + 1);
+  }
+  restore_interrupts(irq);
+  if (core) __sev();                         // core0 可能正在主循环里 WFE：叫醒它输出
+}
+
+static void emit(const evlog_rec_t* e, uint32_t core) {
+#if CFG_MIC_EVLOG_TEXT
+  char line[96];
+  evlog_format(e, line, sizeof(line));
+  printf("[%6lu.%03lu] %s\n", (unsigned long)(e->t_us / 1000u), (unsigned long)(e->t_us % 1000u), line);
+#else
+  printf("@EV %lu %08lx %04x %04x %08lx %08lx\n", (unsigned long)core, (unsigned long)e->t_us,
+         e->id, e->a0, (unsigned long)e->a1, (unsigned long)e->a2);
+#endif
+  (void)core;
+}
+
+uint32_t evlog_drain(uint32_t max) {
+  uint32_t n = 0;
+  for (uint32_t c = 0; c < EVLOG_CORES && n < max; c++) {
+    evlog_ring_t* r = &s_ring[c];
+    uint32_t d = r->dropped;
+    if (d != r->reported) {
+      evlog_rec_t e = { time_us_32(), EV_DROPPED, (uint16_t)c, d - r->reported, 0 };
+      r->reported = d;
+      emit(&e, c);
+      n++;
+    }
+  }
+  while (n < max) {
+    // 两核各自有序，取时间戳更早的那条（按 32-bit 回绕差比较）
+    evlog_ring_t* pick = NULL;
+    uint32_t      core = 0;
+    for (uint32_t c = 0; c < EVLOG_CORES; c++) {
+      evlog_ring_t* r = &s_ring[c];
+      if (LOAD_ACQ(&r->head) == r->tail) continue;
+      const evlog_rec_t* e = &r->rec[r->tail & (CFG_MIC_EVLOG_DEPTH - 1)];
+      if (!pick || (int32_t)(e->t_us - pick->rec[pick->tail & (CFG_MIC_EVLOG_DEPTH - 1)].t_us) < 0) {
+        pick = r;
+        core = c;
+      }
+    }
+    if (!pick) break;
+    evlog_rec_t e = pick->rec[pick->tail & (CFG_MIC_EVLOG_DEPTH - 1)];
+    STORE_REL(&pick->tail, pick->tail + 1);
+    emit(&e, core);
+    n++;
+  }
+  return n;
+}
@@ -0,0 +1,89 @@
+#ifndef __EVLOG_H__
+#define __EVLOG_H__
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== 延迟输出的二进制事件日志 =====
+// 控制请求回调 / tx_done / core1 里只写一条 16 字节记录（时间戳 + 事件 ID + 3 个参数），O(1)，
+// 不格式化、不碰 UART；main() 循环在 TinyUSB 没有待处理事件时 evlog_drain() 取出再输出。
+// 每个核一个单生产者环：core1 直接写，core0 写入时短暂屏蔽本核中断（线程与中断共用一个环），
+// 两核之间不加锁。环满时丢弃新记录并计数，下次输出时报告丢了多少条。
+
+#ifndef CFG_MIC_EVLOG_DEPTH
+#define CFG_MIC_EVLOG_DEPTH   64        // 每核记录数（2 的幂）
+#endif
+// 1 = 在设备上格式化成可读文本；0 = 输出紧凑的 "@EV" 十六进制记录，由 host/evlog_decode 解码
+#ifndef CFG_MIC_EVLOG_TEXT
+#define CFG_MIC_EVLOG_TEXT    1
+#endif
+#define EVLOG_DRAIN_MAX       8         // 每次空闲最多输出的条数，避免占住主循环
+#define EVLOG_CORES           2
+
+typedef enum {
+  EV_DROPPED = 0,     // a0 = 核号，a1 = 丢弃条数（由 evlog_drain 合成）
+  EV_DESC_DEVICE,     // a1 = 长度
+  EV_DESC_CONFIG,     // a1 = 长度
+  EV_DESC_STRING,     // a0 = index
+  EV_CTL_GET,         // a0 = wIndex（实体 ID << 8 | AC 接口号），a1 = sel<<16 | ch<<8 | bRequest，a2 = wLength
+  EV_CTL_SET,         // 同上
+  EV_RATE_SET,        // a0 = 功能，a1 = 采样率
+  EV_RATE_REJECT,     // a0 = 功能，a1 = 采样率
+  EV_MUTE,            // a0 = EVLOG_FUNC(功能, 通道)，a1 = 0/1
+  EV_VOLUME,          // a0 = EVLOG_FUNC(功能, 通道)，a1 = 1/256 dB（有符号）
+  EV_ITF_SET,         // a0 = 接口，a1 = alt
+  EV_ITF_CLOSE,       // a0 = 接口
+  EV_VEND_PREFILL,    // a0 = 功能，a1 = 预填充帧数
+  EV_BUS_MOUNT,
+  EV_BUS_UMOUNT,
+  EV_BUS_SUSPEND,     // a1 = remote wakeup
+  EV_BUS_RESUME,      // a1 = 挂起了多少 ms
+  EV_ENGINE_CFG,      // core1 应用新配置：a0 = EVLOG_FUNC(功能, pcm_fmt_t)，a1 = 采样率
+  EV_SRC_SELECT,      // core1 切换信号源：a0 = audio_src_t，a1 = 文件采样率，a2 = 文件帧数
+  EV_SRC_RATE,        // 录音采样率与流采样率不一致且没有重采样表：a1 = 文件，a2 = 流
+  EV_SRC_RESAMPLE,    // 录音经重采样播放：a0 = 每相抽头数，a1 = L<<16 | M，a2 = 流采样率
+  EV_PDM_CLOCK,       // PDM 采集（重新）启动：a0 = OSR（0 = 该采样率不支持，输出静音），a1 = PDM 时钟，a2 = 流采样率
+  EV_PDM_OVERRUN,     // core1 跟不上 PDM 位流，丢弃了旧数据：a1 = 累计次数
+  EV_AS_ARM,          // 停流期间预生成：a0 = EVLOG_FUNC(功能, pcm_fmt_t)，a1 = 采样率
+  EV_AS_OPEN,         // 开流/流中改采样率：a0 = EVLOG_FUNC(功能, pcm_fmt_t)，a1 = 0 重新配置 / 1 用预生成数据 / 2 流中改采样率，a2 = 等 core1 的 us
+  EV_CTL_STALL,       // 分发表里没有的实体请求：参数同 EV_CTL_GET
+  EV_CTL_NOTIFY,      // 中断端点状态消息已发出：a0 = 实体 ID，a1 = 控制选择子，a2 = 功能
+  EV_VEND_LATPROBE,   // 厂商请求设延迟探针：a1 = 标记间隔 ms（0 = 关闭）
+  EV_AS_SUSPEND,      // 总线挂起，停止生成：a0 = EVLOG_FUNC(功能, pcm_fmt_t)，a1 = 挂起前的 as_sw_state_t
+  EV_VEND_REQUANT,    // 厂商请求设 16-bit 重新量化模式：a1 = requant_mode_t
+  EV_COUNT
+} evlog_id_t;
+
+typedef struct {
+  uint32_t t_us;      // time_us_32()
+  uint16_t id;        // evlog_id_t
+  uint16_t a0;
+  uint32_t a1;
+  uint32_t a2;
+} evlog_rec_t;
+
+void evlog_init(void);
+
+// 任意上下文：记一条事件（O(1)，环满则丢弃并计数）
+void evlog_put(uint16_t id, uint16_t a0, uint32_t a1, uint32_t a2);
+
+#define EVLOG(id)                 evlog_put((id), 0, 0, 0)
+#define EVLOG1(id, a0)            evlog_put((id), (uint16_t)(a0), 0, 0)
+#define EVLOG2(id, a0, a1)        evlog_put((id), (uint16_t)(a0), (uint32_t)(a1), 0)
+#define EVLOG3(id, a0, a1, a2)    evlog_put((id), (uint16_t)(a0), (uint32_t)(a1), (uint32_t)(a2))
+// 多个虚拟麦克风：功能号放 a0 的高字节，低字节放原来的小参数（通道号、pcm_fmt_t）
+#define EVLOG_FUNC(f, x)          ((uint16_t)(((f) << 8) | ((x) & 0xFF)))
+
+// 仅 core0 主循环：按时间顺序合并两核的环，最多输出 max 条；返回输出条数
+uint32_t evlog_drain(uint32_t max);
+
+// 记录 → 一行可读文本（不含换行），设备与 host/evlog_decode 共用（evlog_fmt.c）
+int evlog_format(const evlog_rec_t* r, char* buf, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "usb_descriptors.h"
+#include "evlog.h"
+
+// 记录 → 文本。与原来直接 printf 的日志格式保持一致，固件（CFG_MIC_EVLOG_TEXT=1）与主机解码器共用。
+
+// 仅用于打印友好名称（便于调试）
+static const char* entity_name(uint32_t id) {
+  switch (id) {
+    case UAC2_CLK_ID: return "CLK_SRC";
+    case UAC2_IT_ID:  return "IT (Mic)";
+    case UAC2_FU_ID:  return "FU (Mute/Vol/AGC)";
+    case UAC2_OT_ID:  return "OT (USB)";
+    default: return "UNKNOWN";
+  }
+}
+
+int evlog_format(const evlog_rec_t* r, char* buf, uint32_t len) {
+  unsigned a0 = r->a0;
+  unsigned long a1 = (unsigned long)r->a1, a2 = (unsigned long)r->a2;
+  switch (r->id) {
+    case EV_DROPPED:     return snprintf(buf, len, "[LOG ] core%u dropped %lu events", a0, a1);
+    case EV_DESC_DEVICE: return snprintf(buf, len, "[DESC] device requested, %lu bytes", a1);
+    case EV_DESC_CONFIG: return snprintf(buf, len, "[DESC] config requested, total_len=%lu bytes", a1);
+    case EV_DESC_STRING: return snprintf(buf, len, "[DESC] string index=%u requested", a0);
+    case EV_CTL_GET:
+    case EV_CTL_SET:
+    case EV_CTL_STALL: {
+      static const char* const k_kind[] = { "GET ", "SET ", "STALL" };
+      unsigned ent = a0 >> 8;
+      return snprintf(buf, len, "[CTL ][%s] itf=%u ent=0x%02X(%s) sel=0x%02lX ch=%lu req=0x%02lX wLen=%lu",
+                      k_kind[r->id == EV_CTL_GET ? 0 : r->id == EV_CTL_SET ? 1 : 2], a0 & 0xFF, ent, entity_name(ent),
+                      (a1 >> 16) & 0xFF, (a1 >> 8) & 0xFF, a1 & 0xFF, a2);
+    }
+    case EV_CTL_NOTIFY:
+      return snprintf(buf, len, "[CTL ][INT ] f%lu ent=0x%02X(%s) sel=0x%02lX changed", a2, a0, entity_name(a0), a1);
+    case EV_RATE_SET:    return snprintf(buf, len, "New Sample Rate: f%u %lu Hz.", a0, a1);
+    case EV_RATE_REJECT: return snprintf(buf, len, "Reject Sample Rate: f%u %lu Hz.", a0, a1);
+    case EV_MUTE:        return snprintf(buf, len, "Set Mute: f%u ch%u %lu", a0 >> 8, a0 & 0xFF, a1);
+    case EV_VOLUME:      return snprintf(buf, len, "Set Volume: f%u ch%u %d", a0 >> 8, a0 & 0xFF, (int)(int32_t)r->a1);
+    case EV_ITF_SET:     return snprintf(buf, len, "[ITF ] set interface=%u alt=%lu", a0, a1);
+    case EV_ITF_CLOSE:   return snprintf(buf, len, "[ITF ] close EP on interface=%u (switching alt)", a0);
+    case EV_VEND_PREFILL:return snprintf(buf, len, "[VEND] f%u prefill -> %lu frames", a0, a1);
+    case EV_VEND_LATPROBE:
+      if (a1) return snprintf(buf, len, "[VEND] latency probe: marker every %lu ms on f0", a1);
+      return snprintf(buf, len, "[VEND] latency probe off");
+    case EV_VEND_REQUANT: {
+      static const char* const k_mode[] = { "truncate", "TPDF", "TPDF + 1st-order shaping", "TPDF + 2nd-order shaping" };
+      return snprintf(buf, len, "[VEND] 16-bit requantization: %s", k_mode[a1 < 4 ? a1 : 0]);
+    }
+    case EV_BUS_MOUNT:   return snprintf(buf, len, "[BUS ] mounted");
+    case EV_BUS_UMOUNT:  return snprintf(buf, len, "[BUS ] unmounted");
+    case EV_BUS_SUSPEND: return snprintf(buf, len, "[BUS ] suspend rw=%lu", a1);
+    case EV_BUS_RESUME:  return snprintf(buf, len, "[BUS ] resume after %lu ms", a1);
+    case EV_ENGINE_CFG:  return snprintf(buf, len, "[ENG ] f%u core1 applied fmt=%u fs=%lu", a0 >> 8, a0 & 0xFF, a1);
+    case EV_SRC_SELECT:
+      if (a0 == 2) return snprintf(buf, len, "[SRC ] PDM microphone");
+      return a0 ? snprintf(buf, len, "[SRC ] flash recording: %lu Hz, %lu frames", a1, a2)
+                : snprintf(buf, len, "[SRC ] tone generator");
+    case EV_SRC_RATE:    return snprintf(buf, len, "[WARN] recording is %lu Hz, stream is %lu Hz (no resampler table, pitch shifted)", a1, a2);
+    case EV_SRC_RESAMPLE:
+      return snprintf(buf, len, "[SRC ] resample %lu -> %lu Hz (%lu/%lu, %u taps x %lu phases)",
+                      a2 * (a1 & 0xFFFF) / (a1 >> 16), a2, a1 >> 16, a1 & 0xFFFF, a0, a1 >> 16);
+    case EV_PDM_CLOCK:
+      return a0 ? snprintf(buf, len, "[PDM ] clock %lu Hz (OSR %u) for %lu Hz", a1, a0, a2)
+                : snprintf(buf, len, "[WARN] PDM cannot run at %lu Hz, streaming silence", a2);
+    case EV_PDM_OVERRUN: return snprintf(buf, len, "[WARN] PDM bitstream overrun (%lu total)", a1);
+    case EV_AS_ARM:      return snprintf(buf, len, "[SW  ] f%u pre-rendering fmt=%u fs=%lu", a0 >> 8, a0 & 0xFF, a1);
+    case EV_AS_SUSPEND: {
+      static const char* const k_state[] = { "stopped", "pre-rendered", "streaming" };
+      return snprintf(buf, len, "[SW  ] f%u suspended (%s), generator stopped", a0 >> 8, k_state[a1 < 3 ? a1 : 0]);
+    }
+    case EV_AS_OPEN: {
+      static const char* const k_path[] = { "reconfigured", "pre-rendered", "rate change" };
+      return snprintf(buf, len, "[SW  ] f%u open fmt=%u (%s), waited %lu us for core1", a0 >> 8, a0 & 0xFF,
+                      k_path[a1 < 3 ? a1 : 0], a2);
+    }
+    default:
+      return snprintf(buf, len, "[????] id=%u a0=0x%04X a1=0x%08lX a2=0x%08lX", (unsigned)r->id, a0, a1, a2);
+  }
+}
@@ -0,0 +1,7 @@
+#include "hardware/regs/addressmap.h"
+#include "flash_image.h"
+
+const uint8_t* flash_image_map(uint32_t* len) {
+  *len = CFG_MIC_PCM_FLASH_SIZE;
+  return (const uint8_t*)(XIP_NOCACHE_NOALLOC_BASE + CFG_MIC_PCM_FLASH_OFFSET);
+}
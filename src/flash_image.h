@@ -0,0 +1,22 @@
+#ifndef __FLASH_IMAGE_H__
+#define __FLASH_IMAGE_H__
+#include <stdint.h>
+
+// ===== 录音镜像的映射窗口（flash_src.h 的数据来源）=====
+// 固件：镜像单独烧到 flash 的 CFG_MIC_PCM_FLASH_OFFSET 处，例如
+//   picotool load -o 0x10100000 speech.wav
+// 经 XIP 的 NOCACHE_NOALLOC 别名读取：大块顺序读不会把代码挤出 16 KB 的 XIP 缓存，
+// 否则还在 flash 里执行的 USB 回调会被换出、在 ISR 里吃 flash 等待状态。
+// 主机仿真：host/shim/flash_image_sim.c 用 mmap 映射同一个文件。
+
+#ifndef CFG_MIC_PCM_FLASH_OFFSET
+#define CFG_MIC_PCM_FLASH_OFFSET  (1024u * 1024u)    // 固件之后（2 MB flash 的后一半）
+#endif
+#ifndef CFG_MIC_PCM_FLASH_SIZE
+#define CFG_MIC_PCM_FLASH_SIZE    (1024u * 1024u)    // 映射窗口长度；WAV 的实际长度以头为准
+#endif
+
+// 返回镜像起点，*len = 可读长度；没有镜像时返回 NULL
+const uint8_t* flash_image_map(uint32_t* len);
+
+#endif
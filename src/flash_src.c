@@ -0,0 +1,127 @@
+#include <string.h>
+#include "flash_src.h"
+
+#ifndef CFG_MIC_PCM_RAW
+#define CFG_MIC_PCM_RAW   0     // 1 = 没有 WAV 头时按 CFG_MIC_PCM_RAW_* 当裸 PCM 播放整个窗口
+#endif
+#define FLASH_SRC_MAX_CH  16
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool set_format(flash_src_t* s, uint16_t tag, uint16_t bits, uint16_t channels) {
+  if (channels == 0 || channels > FLASH_SRC_MAX_CH) return false;
+  if (tag == 1 && bits == 16)      s->fmt = PCM_FMT_S16;
+  else if (tag == 1 && bits == 24) s->fmt = PCM_FMT_S24;
+  else if (tag == 1 && bits == 32) s->fmt = PCM_FMT_S32;
+  else if (tag == 3 && bits == 32) s->fmt = PCM_FMT_F32;
+  else return false;
+  s->bytes    = (uint8_t)(bits / 8);
+  s->channels = channels;
+  return true;
+}
+
+// RIFF/WAVE：找 "fmt " 与 "data" 块（data 长度按映射窗口截断）
+static bool parse_wav(flash_src_t* s, const uint8_t* p, uint32_t len) {
+  if (len < 12 || memcmp(p, "RIFF", 4) || memcmp(p + 8, "WAVE", 4)) return false;
+  bool have_fmt = false;
+  for (uint32_t i = 12; i + 8 <= len; ) {
+    uint32_t sz = rd32(p + i + 4);
+    const uint8_t* body = p + i + 8;
+    if (!memcmp(p + i, "fmt ", 4) && sz >= 16 && i + 8 + 16 <= len) {
+      uint16_t tag = rd16(body);
+      if (tag == 0xFFFE) {                                         // WAVE_FORMAT_EXTENSIBLE：子格式 GUID 前两字节
+        if (sz < 40 || sz > len - (i + 8)) return false;           // 扩展部分不全（截断的镜像）
+        tag = rd16(body + 24);
+      }
+      s->fs = rd32(body + 4);
+      have_fmt = set_format(s, tag, rd16(body + 14), rd16(body + 2));
+      if (!have_fmt) return false;
+    } else if (!memcmp(p + i, "data", 4) && have_fmt) {
+      uint32_t avail = len - (i + 8);
+      if (sz > avail) sz = avail;
+      s->data   = body;
+      s->frames = sz / ((uint32_t)s->bytes * s->channels);
+      return s->frames > 0;
+    }
+    if (sz > len) return false;
+    i += 8 + sz + (sz & 1u);                                       // 块按偶数字节对齐
+  }
+  return false;
+}
+
+bool flash_src_open(flash_src_t* s, const void* image, uint32_t len) {
+  const uint8_t* p = (const uint8_t*)image;
+  memset(s, 0, sizeof(*s));
+  if (!p) return false;
+  s->end = p + len;
+  if (parse_wav(s, p, len)) return true;
+#if CFG_MIC_PCM_RAW
+  memset(s, 0, sizeof(*s));
+  s->end = p + len;
+  s->fs  = CFG_MIC_PCM_RAW_RATE;
+  if (!set_format(s, CFG_MIC_PCM_RAW_FMT == PCM_FMT_F32 ? 3 : 1,
+                  pcm_fmt_table[CFG_MIC_PCM_RAW_FMT].bytes * 8u, CFG_MIC_PCM_RAW_CHANNELS)) return false;
+  s->data   = p;
+  s->frames = len / ((uint32_t)s->bytes * s->channels);
+  return s->frames > 0;
+#else
+  return false;
+#endif
+}
+
+// IEEE float32 位模式 → Q31（饱和），只用整数运算（M0+ 没有 FPU）
+static inline int32_t f32_bits_to_q31(uint32_t b) {
+  int32_t e = (int32_t)((b >> 23) & 0xFFu) - 127;            // |x| = 1.m × 2^e
+  if (e < -31) return 0;
+  if (e >= 0)  return (b >> 31) ? INT32_MIN : INT32_MAX;
+  uint32_t m = (b & 0x7FFFFFu) | 0x800000u;
+  int32_t  sh = 8 + e;                                         // Q31 = m × 2^(e + 31 - 23)
+  uint32_t v = sh >= 0 ? m << sh : m >> -sh;
+  return (b >> 31) ? -(int32_t)v : (int32_t)v;
+}
+
+// 暂存区 → 平面 Q31；格式分支在块外判断一次，内循环按帧步进（M0+ 不能非对齐整字读，逐字节拼）
+#define CONVERT_LOOP(expr)                                                   \
+  for (uint32_t c = 0; c < ch; c++) {                                         \
+    const uint8_t* p = b + (c % s->channels) * s->bytes;                      \
+    int32_t* d = planar[c] + done;                                            \
+    for (uint32_t i = 0; i < k; i++, p += fb) d[i] = (expr);                  \
+  }
+
+void flash_src_render_q31(flash_src_t* s, int32_t* const* planar, uint32_t ch, uint32_t n) {
+  static uint32_t burst[FLASH_SRC_BURST / 4 + 1];
+  const uint32_t fb  = (uint32_t)s->bytes * s->channels;
+  const uint32_t max = FLASH_SRC_BURST / fb;
+  uint32_t done = 0;
+  while (done < n) {
+    uint32_t k = n - done;
+    if (k > s->frames - s->pos) k = s->frames - s->pos;
+    if (k > max) k = max;
+
+    // 对齐整字拷贝：XIP 按 32-bit 读最快，也让 flash 访问集中成一段连续突发
+    const uint8_t*  src = s->data + s->pos * fb;
+    uint32_t        off = (uint32_t)((uintptr_t)src & 3u);
+    const uint32_t* w   = (const uint32_t*)(const void*)(src - off);
+    uint32_t        nw  = (off + k * fb + 3u) / 4u;
+    const uint8_t*  b   = (const uint8_t*)burst + off;
+    if ((const uint8_t*)(w + nw) <= s->end) {
+      for (uint32_t i = 0; i < nw; i++) burst[i] = w[i];
+    } else {
+      memcpy((uint8_t*)burst + off, src, k * fb);                // 镜像最后不足一个字
+    }
+
+    switch (s->fmt) {
+      case PCM_FMT_S16: CONVERT_LOOP((int32_t)((uint32_t)rd16(p) << 16)); break;
+      case PCM_FMT_S24: CONVERT_LOOP((int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24))); break;
+      case PCM_FMT_S32: CONVERT_LOOP((int32_t)rd32(p)); break;
+      default:          CONVERT_LOOP(f32_bits_to_q31(rd32(p))); break;
+    }
+
+    s->pos += k;
+    if (s->pos == s->frames) { s->pos = 0; s->loops++; }       // 无缝循环：下一轮接着填同一块
+    done += k;
+  }
+}
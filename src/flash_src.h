@@ -0,0 +1,53 @@
+#ifndef __FLASH_SRC_H__
+#define __FLASH_SRC_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcm_pack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== Flash 里的 PCM 录音作为信号源 =====
+// 镜像是 WAV（RIFF/WAVE：PCM 16/24/32-bit 或 IEEE float32），或者格式由 CFG_MIC_PCM_RAW_* 给定的裸 PCM。
+// 固件用 picotool 把镜像烧到 XIP 窗口的 CFG_MIC_PCM_FLASH_OFFSET 处（flash_image.h）；主机侧 mmap 同一个文件。
+// 只在 core1 生产者里读取：每次按 4 字节对齐整字从映射窗口拷一块（≤ FLASH_SRC_BURST 字节）到 SRAM 暂存区再转换，
+// flash 等待状态只落在 core1，tud_audio_tx_done_isr 只碰 SRAM 环。
+// 输出统一为平面 Q31（与 DDS 相同），线上位宽仍由 pcm_pack 的打包内核决定；读到结尾在同一块里接回开头（无缝循环）。
+// 输出通道 c 取文件的第 c % channels 声道。
+
+#ifndef CFG_MIC_PCM_RAW_FMT
+#define CFG_MIC_PCM_RAW_FMT       PCM_FMT_S16   // 裸 PCM：样本格式
+#endif
+#ifndef CFG_MIC_PCM_RAW_CHANNELS
+#define CFG_MIC_PCM_RAW_CHANNELS  1
+#endif
+#ifndef CFG_MIC_PCM_RAW_RATE
+#define CFG_MIC_PCM_RAW_RATE      48000
+#endif
+
+#define FLASH_SRC_BURST           512           // 每次从 XIP 窗口拷贝的最大字节数
+
+typedef struct {
+  const uint8_t* data;        // 第一帧
+  const uint8_t* end;         // 镜像结尾（整字拷贝不越过它）
+  uint32_t       frames;      // 总帧数
+  uint32_t       pos;         // 下一帧
+  uint32_t       fs;          // 文件采样率（与流采样率不同时按原样播放，音高随之变化）
+  uint16_t       channels;
+  uint8_t        bytes;       // 每样本字节
+  uint8_t        fmt;         // pcm_fmt_t
+  uint32_t       loops;       // 已循环次数
+} flash_src_t;
+
+// 解析镜像（WAV 头或裸 PCM），len 为映射窗口可用长度；不是有效镜像（例如擦除后的 0xFF）时返回 false
+bool flash_src_open(flash_src_t* s, const void* image, uint32_t len);
+
+// 生成 n 帧平面 Q31 到 planar[0..ch-1]
+void flash_src_render_q31(flash_src_t* s, int32_t* const* planar, uint32_t ch, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
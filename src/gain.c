@@ -0,0 +1,65 @@
+#include <math.h>
+#include <string.h>
+#include "gain.h"
+
+static int32_t  s_table[GAIN_TABLE_MAX];
+static uint32_t s_count;
+static int16_t  s_min, s_res;
+
+void gain_table_init(int16_t vol_min, int16_t vol_max, int16_t vol_res) {
+  s_min = vol_min;
+  s_res = vol_res > 0 ? vol_res : 256;
+  s_count = (uint32_t)((vol_max - vol_min) / s_res) + 1;
+  if (s_count > GAIN_TABLE_MAX) s_count = GAIN_TABLE_MAX;
+  for (uint32_t i = 0; i < s_count; i++) {
+    double db = (double)(vol_min + (int32_t)i * s_res) / 256.0;
+    double g  = pow(10.0, db / 20.0) * (double)GAIN_UNITY;
+    s_table[i] = (g >= (double)GAIN_UNITY) ? GAIN_UNITY : (int32_t)lrint(g);
+  }
+}
+
+int32_t gain_lookup_q30(int16_t vol) {
+  int32_t idx = ((int32_t)vol - s_min + s_res / 2) / s_res;
+  if (idx < 0) idx = 0;
+  if (idx >= (int32_t)s_count) idx = (int32_t)s_count - 1;
+  return s_table[idx];
+}
+
+void gain_init(gain_t* g, int32_t q30) {
+  g->cur = g->ramp_to = g->target = q30;
+  g->step = 0;
+}
+
+// (x · c) >> 30，不用 64 位乘法（M0+ 上是 __aeabi_lmul 调用）：样本拆成有符号高 16 位 / 无符号低 16 位，
+// 增益（≤ GAIN_UNITY）拆成高 16 位 / 低 15 位，三次 32-bit 乘法；丢掉的 lo·lo 项与各项截断合计至多 3 LSB（Q31）
+static inline int32_t mul_q30(int32_t x, int32_t c) {
+  int32_t xh = x >> 16, xl = (int32_t)((uint32_t)x & 0xFFFFu);
+  int32_t ch = c >> 15, cl = c & 0x7FFF;
+  return xh * ch * 2 + ((xh * cl) >> 14) + ((xl * ch) >> 15);
+}
+
+void gain_apply_q31(gain_t* g, int32_t* buf, uint32_t n) {
+  int32_t t = g->target;
+  int32_t c = g->cur;
+  uint32_t i = 0;
+
+  if (c != t) {
+    // 新目标：重新计算斜坡步进（仅在目标变化时做一次除法）
+    if (g->ramp_to != t) {
+      g->ramp_to = t;
+      g->step = (t - c) / GAIN_RAMP_LEN;
+      if (g->step == 0) g->step = (t > c) ? 1 : -1;
+    }
+    int32_t s = g->step;
+    for (; i < n && c != t; i++) {
+      c += s;
+      if ((s > 0 && c > t) || (s < 0 && c < t)) c = t;
+      buf[i] = mul_q30(buf[i], c);
+    }
+    g->cur = c;
+  }
+  // 稳态：0 dB 原样、静音清零，其余每样本一次拆分乘法
+  if (c == GAIN_UNITY) return;
+  if (c == 0) { memset(buf + i, 0, (n - i) * sizeof(int32_t)); return; }
+  for (; i < n; i++) buf[i] = mul_q30(buf[i], c);
+}
@@ -0,0 +1,33 @@
+#ifndef __GAIN_H__
+#define __GAIN_H__
+#include <stdint.h>
+
+// ===== 增益/静音（整数域）=====
+// 控制面收到 FU 的 VOLUME/MUTE SET_CUR 时查表得到 Q30 线性增益并设为目标；
+// 数据面每样本一次拆分的 32-bit 整数乘法（稳态 0 dB / 静音直接跳过），目标变化时用短线性斜坡过渡，避免拉链噪声。
+
+#define GAIN_Q            30
+#define GAIN_UNITY        (1 << GAIN_Q)
+#define GAIN_TABLE_MAX    256
+#define GAIN_RAMP_LEN     64     // 斜坡长度（样本），96k 下约 0.7 ms
+
+typedef struct {
+  int32_t          cur;          // 当前增益 Q30（仅数据面读写）
+  int32_t          step;         // 斜坡步进
+  int32_t          ramp_to;      // 斜坡正在逼近的目标
+  volatile int32_t target;       // 目标增益 Q30（控制面写）
+} gain_t;
+
+// 上电时按 FU 的 RANGE（dB/256 单位）生成 dB→线性 表
+void    gain_table_init(int16_t vol_min, int16_t vol_max, int16_t vol_res);
+
+// dB/256 → Q30 线性增益（夹到表范围，按步进四舍五入）
+int32_t gain_lookup_q30(int16_t vol);
+
+void    gain_init(gain_t* g, int32_t q30);
+static inline void gain_set_target(gain_t* g, int32_t q30) { g->target = q30; }
+
+// 原地对 Q31 样本块施加增益
+void    gain_apply_q31(gain_t* g, int32_t* buf, uint32_t n);
+
+#endif
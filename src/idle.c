@@ -0,0 +1,89 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "telemetry.h"
+#include "idle.h"
+
+// 注：idle_sleep / idle_get / 挂起恢复在 core0 主循环（tud_task）里，idle_on_service 在 USB 中断里
+// （tud_audio_tx_done_isr），而且中断处理在 __wfe() 返回之前就跑完了。所以延迟从进入 WFE 时锁存的 SysTick 算起，
+// 中断也会改的计数在主循环侧屏蔽中断再读写。
+
+#define SYSTICK_MASK   0x00FFFFFFu
+
+_Static_assert(sizeof(idle_stats_t) == 48, "idle_stats_t layout (host tools read it raw)");
+
+static idle_stats_t s_st;
+static uint32_t     s_t_window;          // 窗口起点（time_us_32）
+static uint32_t     s_wfe_cvr;           // 最近一次进入 WFE 时的 SysTick
+static volatile bool s_armed;            // 在 WFE 里（或正要进入），还没有服务过数据面
+static uint32_t     s_t_suspend;
+
+static void reset_window(void) {
+  uint32_t suspends = s_st.suspends, suspended_ms = s_st.suspended_ms;
+  uint8_t  suspended = s_st.suspended;
+  memset(&s_st, 0, sizeof(s_st));
+  s_st.version      = IDLE_VERSION;
+  s_st.suspended    = suspended;
+  s_st.cpu_hz       = SYS_CLK_KHZ * 1000u;
+  s_st.lat_min      = UINT32_MAX;
+  s_st.suspends     = suspends;
+  s_st.suspended_ms = suspended_ms;
+  s_t_window        = time_us_32();
+}
+
+void idle_init(void) {
+  memset(&s_st, 0, sizeof(s_st));
+  reset_window();
+  s_armed = false;
+}
+
+void idle_sleep(void) {
+#if CFG_MIC_IDLE_WFE
+  uint32_t t0 = time_us_32();
+  s_wfe_cvr = systick_hw->cvr;
+  s_armed   = true;                      // 这之后来的中断也会让 WFE 立即返回：照样从这里算
+  __wfe();
+  s_armed   = false;                     // 被控制请求、SEV 等叫醒而没有数据面回调的，不计延迟
+  uint32_t dt  = time_us_32() - t0;
+  uint32_t irq = save_and_disable_interrupts();
+  s_st.sleep_us += dt;
+  s_st.sleeps++;
+  restore_interrupts(irq);
+#endif
+}
+
+void idle_on_service(void) {
+  if (!s_armed) return;
+  s_armed = false;
+  uint32_t c = (s_wfe_cvr - systick_hw->cvr) & SYSTICK_MASK;    // 向下计数；流进行中间隔 ≤ 1 帧，不会回绕
+  s_st.serviced++;
+  if (c < s_st.lat_min) s_st.lat_min = c;
+  if (c > s_st.lat_max) s_st.lat_max = c;
+  uint32_t lo = s_st.lat_sum_lo + c;
+  s_st.lat_sum_hi += lo < c;
+  s_st.lat_sum_lo  = lo;
+}
+
+void idle_on_suspend(void) {
+  if (s_st.suspended) return;
+  s_st.suspended = 1;
+  s_st.suspends++;
+  s_t_suspend = time_us_32();
+}
+
+uint32_t idle_on_resume(void) {
+  if (!s_st.suspended) return 0;
+  s_st.suspended = 0;
+  uint32_t ms = (time_us_32() - s_t_suspend) / 1000u;
+  s_st.suspended_ms += ms;
+  return ms;
+}
+
+void idle_get(idle_stats_t* out) {
+  uint32_t irq = save_and_disable_interrupts();
+  s_st.window_us = time_us_32() - s_t_window;
+  *out = s_st;
+  reset_window();
+  restore_interrupts(irq);
+}
@@ -0,0 +1,50 @@
+#ifndef __IDLE_H__
+#define __IDLE_H__
+#include <stdbool.h>
+#include <stdint.h>
+
+// ===== core0 主循环的休眠与空闲统计 =====
+// 主循环在 TinyUSB 没有待处理事件、空闲工作（状态消息、日志、遥测）也做完时调用 idle_sleep()：WFE 睡到下一个
+// USB 中断或 core1 的 SEV。判断“没事可做”和 WFE 之间来的中断会置位事件寄存器，WFE 立即返回，不会睡过头；
+// 本核自己执行的 SEV（tx_done 里唤醒 core1）同样会置位它，所以流进行中每帧多一次立即返回的 WFE。
+// 统计：WFE 里的时间（time_us_32）、WFE 次数、进入 WFE → 数据面服务入口（tud_audio_tx_done_isr）的 SysTick 周期数
+// （含睡眠本身：USB 中断在 WFE 返回之前就已处理完），
+// 以及总线挂起的次数与时长。周期数用 telemetry.c 配好的 core0 SysTick，所以要在 telem_init() 之后使用。
+// 读出：厂商请求 VENDOR_REQ_IDLE_GET（读出后清零窗口计数，挂起累计值除外）。
+
+#ifndef CFG_MIC_IDLE_WFE
+#define CFG_MIC_IDLE_WFE   1       // 0 = 照旧忙等 tud_task()（功耗对照），统计里的睡眠时间恒为 0
+#endif
+
+typedef struct __attribute__((packed)) {
+  uint8_t  version;                // IDLE_VERSION
+  uint8_t  suspended;              // 读出时总线是否挂起
+  uint16_t reserved;
+  uint32_t cpu_hz;                 // 周期计数的时钟
+  uint32_t window_us;              // 统计窗口：自上次读出（或上电）以来
+  uint32_t sleep_us;               // 其中 core0 在 WFE 里的时间
+  uint32_t sleeps;                 // WFE 次数（含立即返回的）
+  uint32_t serviced;               // 醒来后处理到数据面回调的次数（计入下面的延迟）
+  uint32_t lat_min, lat_max;       // 进入 WFE → tx_done 入口（周期）
+  uint32_t lat_sum_lo, lat_sum_hi; // 64-bit 周期总和
+  uint32_t suspends;               // 上电以来：总线挂起次数
+  uint32_t suspended_ms;           // 上电以来：挂起总时长（不含正在进行的这次）
+} idle_stats_t;
+
+#define IDLE_VERSION       1
+
+void idle_init(void);
+
+// 主循环：没有事可做时调用（CFG_MIC_IDLE_WFE = 0 时直接返回）
+void idle_sleep(void);
+// tud_audio_tx_done_isr 入口（USB 中断）：本次 WFE 里的第一次数据面服务，记下进入 WFE 到这里的周期数
+void idle_on_service(void);
+
+// 总线挂起 / 恢复（tud_suspend_cb / tud_resume_cb）；恢复时返回这次挂起了多少 ms
+void     idle_on_suspend(void);
+uint32_t idle_on_resume(void);
+
+// 读出并清零窗口计数
+void idle_get(idle_stats_t* out);
+
+#endif
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/structs/usb.h"
+#include "latprobe.h"
+
+#define LOAD_ACQ(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_REL(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define LATPROBE_PERIOD_MAX_MS  10000   // fs × 间隔不溢出 32 位
+#define LATPROBE_DRAIN_MAX      4       // 每次空闲最多输出的行数
+#define SOF_DROPPED             0xFFFFu // 标记在环里被丢弃（SOF 帧号只有 11 位）
+
+_Static_assert((CFG_MIC_LATPROBE_DEPTH & (CFG_MIC_LATPROBE_DEPTH - 1)) == 0, "CFG_MIC_LATPROBE_DEPTH must be a power of two");
+
+typedef struct {
+  uint16_t id;
+  uint16_t sof;         // 写进 EP FIFO 时的 SOF 帧号
+  uint32_t pos;         // 同步样本在环里的字节位置
+  uint32_t t_gen;       // core1 生成时的 time_us_32
+  uint32_t t_fifo;      // ISR 写进 EP FIFO 时的 time_us_32
+} mark_t;
+
+// 一张表、三个自由递增的下标：core1 推进 s_w（已生成），ISR 推进 s_c（已进 FIFO 或已丢弃），主循环推进 s_p（已输出）
+static mark_t            s_mk[CFG_MIC_LATPROBE_DEPTH];
+static volatile uint32_t s_w, s_c, s_p;
+static volatile uint16_t s_period_req;   // core0 写，core1 读（半字，原子）
+
+// 生产者私有
+static uint16_t s_period;
+static uint32_t s_left;                  // 距下一个同步样本的帧数
+static uint16_t s_id;
+static int32_t  s_id_due;                // 同步样本在上一块最后一帧：本块第 0 帧补上序号（非 0 时为 Q31 值 | 1）
+
+void latprobe_init(void) {
+  s_w = s_c = s_p = 0;
+  s_period = 0;
+  s_id = 0;
+  s_id_due = 0;
+  s_period_req = CFG_MIC_LATPROBE_MS;
+}
+
+void latprobe_set_period(uint16_t period_ms) {
+  s_period_req = period_ms < LATPROBE_PERIOD_MAX_MS ? period_ms : LATPROBE_PERIOD_MAX_MS;
+}
+
+static void put_frame(int32_t* const* planar, uint32_t nch, uint32_t i, int32_t v) {
+  for (uint32_t c = 0; c < nch; c++) planar[c][i] = v;
+}
+
+int latprobe_render(int32_t* const* planar, uint32_t nch, uint32_t n, uint32_t fs,
+                    uint32_t ring_pos, uint32_t frame_bytes) {
+  uint16_t per = s_period_req;
+  if (per != s_period) {                 // 间隔变了：下一块第 0 帧起重新计
+    s_period = per;
+    s_left = 0;
+    s_id_due = 0;
+  }
+  if (!s_period) return 0;
+
+  for (uint32_t c = 0; c < nch; c++) memset(planar[c], 0, n * sizeof(int32_t));
+  if (s_id_due) {
+    put_frame(planar, nch, 0, s_id_due & ~1);
+    s_id_due = 0;
+  }
+  uint32_t every = fs * s_period / 1000u, i = s_left;
+  for (; i < n; i += every) {
+    int32_t id = (int32_t)((uint32_t)s_id << 16);
+    put_frame(planar, nch, i, (int32_t)((uint32_t)LATPROBE_SYNC << 16));
+    if (i + 1 < n) put_frame(planar, nch, i + 1, id);
+    else           s_id_due = id | 1;
+    uint32_t w = s_w;
+    if (w - LOAD_ACQ(&s_p) < CFG_MIC_LATPROBE_DEPTH) {   // 表满：标记照样发出，只是没有记录
+      mark_t* m = &s_mk[w & (CFG_MIC_LATPROBE_DEPTH - 1)];
+      m->id    = s_id;
+      m->pos   = ring_pos + i * frame_bytes;
+      m->t_gen = time_us_32();
+      STORE_REL(&s_w, w + 1);
+    }
+    s_id = s_id + 1 < LATPROBE_SYNC ? s_id + 1 : 0;     // 序号不能撞上同步样本
+  }
+  s_left = i - n;
+  return 1;
+}
+
+void latprobe_on_pop(uint32_t tail0, uint32_t tail1) {
+  uint32_t w = LOAD_ACQ(&s_w), c = s_c;
+  for (; c != w; c++) {
+    mark_t* m = &s_mk[c & (CFG_MIC_LATPROBE_DEPTH - 1)];
+    if ((int32_t)(m->pos - tail1) >= 0) break;            // 还在环里
+    if ((int32_t)(m->pos - tail0) < 0) {                  // 取数前已被 flush / 切格式丢弃
+      m->sof = SOF_DROPPED;
+    } else {
+      m->sof    = (uint16_t)(usb_hw->sof_rd & USB_SOF_RD_BITS);
+      m->t_fifo = time_us_32();
+    }
+  }
+  s_c = c;
+}
+
+void latprobe_poll(void) {
+  uint32_t c = s_c, p = s_p;
+  for (uint32_t k = 0; p != c && k < LATPROBE_DRAIN_MAX; k++, p++) {
+    const mark_t* m = &s_mk[p & (CFG_MIC_LATPROBE_DEPTH - 1)];
+    // @LP id t_gen_us sof t_fifo_us
+    if (m->sof != SOF_DROPPED)
+      printf("@LP %u %lu %u %lu\n", m->id, (unsigned long)m->t_gen, m->sof, (unsigned long)m->t_fifo);
+  }
+  STORE_REL(&s_p, p);
+}
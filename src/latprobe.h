@@ -0,0 +1,38 @@
+#ifndef __LATPROBE_H__
+#define __LATPROBE_H__
+#include <stdint.h>
+
+// ===== 端到端延迟探针（功能 0） =====
+// 打开后（厂商请求 VENDOR_REQ_LATPROBE_SET，wValue = 标记间隔 ms；0 = 关闭）功能 0 的输出换成稀疏的脉冲串：
+// 每个标记是相邻两个采样帧——同步样本 LATPROBE_SYNC、标记序号（0..LATPROBE_SYNC − 1 循环）——其余全为 0。两者都只占样本的最高 16 位，
+// 在增益之后写入，所以任何 Alt（16/24/32-bit、float32）、任何音量下主机录到的都是原值，所有通道相同。
+// * core1 生成标记时记下（序号, 环内字节位置, time_us_32）；
+// * USB ISR 把含同步样本的字节从环写进 EP FIFO 时补上 SOF 帧号与 time_us_32（被 flush / 切格式丢弃的标记不输出）；
+// * 主循环空闲时每个标记输出一行 "@LP id t_gen_us sof t_fifo_us"。
+// host/latprobe.py 读主机录下的 WAV + 这些行，给出 生成→FIFO、FIFO→主机、端到端延迟的分布与抖动。
+
+#ifndef CFG_MIC_LATPROBE_MS
+#define CFG_MIC_LATPROBE_MS     0       // 上电时的标记间隔（ms），0 = 关闭
+#endif
+#ifndef CFG_MIC_LATPROBE_DEPTH
+#define CFG_MIC_LATPROBE_DEPTH  32      // 在途 + 待输出的标记数（2 的幂）
+#endif
+#define LATPROBE_SYNC           0x7FFF  // 同步样本（按 16-bit 看）；序号紧跟在下一个采样帧
+
+void latprobe_init(void);
+
+// 控制面（core0）：每 period_ms 一个标记，0 = 关闭（恢复信号源）
+void latprobe_set_period(uint16_t period_ms);
+
+// 生产者（core1，流 0，增益之后、打包之前）：探针打开时把这一块 n 帧换成静音 + 标记，返回是否替换了。
+// ring_pos = 这一块将写入环的起始字节位置，frame_bytes = 每采样帧字节数
+int  latprobe_render(int32_t* const* planar, uint32_t nch, uint32_t n, uint32_t fs,
+                     uint32_t ring_pos, uint32_t frame_bytes);
+
+// 消费者（USB ISR，流 0）：环的 [tail0, tail1) 刚写进 EP FIFO
+void latprobe_on_pop(uint32_t tail0, uint32_t tail1);
+
+// 主循环空闲时调用：输出已进 FIFO 的标记
+void latprobe_poll(void);
+
+#endif
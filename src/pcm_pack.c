@@ -0,0 +1,102 @@
+#include "pcm_pack.h"
+
+// 16-bit：取 Q31 高半字；低样本在低半字（小端）
+#define PACK2_S16(a, b)   (((uint32_t)(a) >> 16) | ((uint32_t)(b) & 0xFFFF0000u))
+
+// 24-bit：取 Q31 高 3 字节，4 个样本 A B C D 拼成 3 个小端字
+//   w0 = A0 A1 A2 B0 | w1 = B1 B2 C0 C1 | w2 = C2 D0 D1 D2
+#define PACK4_S24(o, a, b, c, d) do {                    \
+    uint32_t A_ = (uint32_t)(a) >> 8, B_ = (uint32_t)(b) >> 8; \
+    uint32_t C_ = (uint32_t)(c) >> 8, D_ = (uint32_t)(d) >> 8; \
+    (o)[0] = A_ | (B_ << 24);                            \
+    (o)[1] = (B_ >> 8) | (C_ << 16);                     \
+    (o)[2] = (C_ >> 16) | (D_ << 8);                     \
+  } while (0)
+
+// Q31 → IEEE float 位模式，纯整数：clz 归一化后截取 23-bit 尾数（M0+ 无 FPU，避免软浮点乘除）
+//   |x| = m * 2^-31，m 的最高位移到 bit31 需左移 e 位 → 值 = 1.f * 2^-e，指数域 = 127 - e
+static inline uint32_t q31_to_f32_bits(int32_t x) {
+  if (x == 0) return 0;
+  uint32_t sign = (uint32_t)x & 0x80000000u;
+  uint32_t m    = sign ? 0u - (uint32_t)x : (uint32_t)x;     // INT32_MIN → 2^31，正好 -1.0
+  uint32_t e    = (uint32_t)__builtin_clz(m);
+  return sign | ((127u - e) << 23) | (((m << e) >> 8) & 0x007FFFFFu);
+}
+
+// 通用路径：按交织顺序逐个取样本（帧/通道游标）
+typedef struct { const int32_t* const* pl; uint32_t ch, f, c; } cursor_t;
+
+static inline int32_t cursor_next(cursor_t* k) {
+  int32_t v = k->pl[k->c][k->f];
+  if (++k->c == k->ch) { k->c = 0; k->f++; }
+  return v;
+}
+
+uint32_t pcm_pack_s16(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst) {
+  uint32_t* o = dst;
+  if (ch == 1) {
+    const int32_t* p = planar[0];
+    for (uint32_t i = 0; i < n_frames; i += 2) *o++ = PACK2_S16(p[i], p[i + 1]);
+  } else if ((ch & 1u) == 0) {
+    // 偶数通道：每帧按通道对写字
+    for (uint32_t i = 0; i < n_frames; i++)
+      for (uint32_t c = 0; c < ch; c += 2) *o++ = PACK2_S16(planar[c][i], planar[c + 1][i]);
+  } else {
+    cursor_t k = { planar, ch, 0, 0 };
+    for (uint32_t w = (n_frames * ch) / 2; w; w--) {
+      int32_t a = cursor_next(&k), b = cursor_next(&k);
+      *o++ = PACK2_S16(a, b);
+    }
+  }
+  return (uint32_t)(o - dst) * 4u;
+}
+
+uint32_t pcm_pack_s24(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst) {
+  uint32_t* o = dst;
+  if (ch == 1) {
+    const int32_t* p = planar[0];
+    for (uint32_t i = 0; i < n_frames; i += 4, o += 3) PACK4_S24(o, p[i], p[i + 1], p[i + 2], p[i + 3]);
+  } else if (ch == 2) {
+    const int32_t* l = planar[0];
+    const int32_t* r = planar[1];
+    for (uint32_t i = 0; i < n_frames; i += 2, o += 3) PACK4_S24(o, l[i], r[i], l[i + 1], r[i + 1]);
+  } else if ((ch & 3u) == 0) {
+    for (uint32_t i = 0; i < n_frames; i++)
+      for (uint32_t c = 0; c < ch; c += 4, o += 3)
+        PACK4_S24(o, planar[c][i], planar[c + 1][i], planar[c + 2][i], planar[c + 3][i]);
+  } else {
+    cursor_t k = { planar, ch, 0, 0 };
+    for (uint32_t g = (n_frames * ch) / 4; g; g--, o += 3) {
+      int32_t a = cursor_next(&k), b = cursor_next(&k), c = cursor_next(&k), d = cursor_next(&k);
+      PACK4_S24(o, a, b, c, d);
+    }
+  }
+  return (uint32_t)(o - dst) * 4u;
+}
+
+// 32-bit 整数 / float：每样本一个字，只需交织（+ 位模式转换）
+#define PACK_WORD_KERNEL(_name, _conv)                                                         \
+  uint32_t _name(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst) { \
+    uint32_t* o = dst;                                                                        \
+    if (ch == 1) {                                                                            \
+      const int32_t* p = planar[0];                                                           \
+      for (uint32_t i = 0; i < n_frames; i++) *o++ = _conv(p[i]);                             \
+    } else {                                                                                  \
+      for (uint32_t i = 0; i < n_frames; i++)                                                 \
+        for (uint32_t c = 0; c < ch; c++) *o++ = _conv(planar[c][i]);                         \
+    }                                                                                         \
+    return (uint32_t)(o - dst) * 4u;                                                          \
+  }
+
+#define Q31_AS_S32(x)  ((uint32_t)(x))
+
+PACK_WORD_KERNEL(pcm_pack_s32, Q31_AS_S32)
+PACK_WORD_KERNEL(pcm_pack_f32, q31_to_f32_bits)
+
+const pcm_fmt_info_t pcm_fmt_table[PCM_FMT_COUNT] = {
+  [PCM_FMT_NONE] = { 0, 0 },
+  [PCM_FMT_S16]  = { 2, pcm_pack_s16 },
+  [PCM_FMT_S24]  = { 3, pcm_pack_s24 },
+  [PCM_FMT_S32]  = { 4, pcm_pack_s32 },
+  [PCM_FMT_F32]  = { 4, pcm_pack_f32 },
+};
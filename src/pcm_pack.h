@@ -0,0 +1,36 @@
+#ifndef __PCM_PACK_H__
+#define __PCM_PACK_H__
+#include <stdint.h>
+
+// ===== 交织 + 打包（平面 Q31 → USB 小端 PCM / float）=====
+// 信号链按通道平面生成唯一的内部格式（每通道一条连续 Q31 缓冲），这里一次性交织并转换成线上格式，
+// 整字（uint32）写出：16-bit 两个样本一个字，24-bit 四个样本三个字，不做逐字节拼装。
+// 要求：dst 4 字节对齐；总样本数（n_frames * ch）16-bit 为 2 的倍数、24-bit 为 4 的倍数。
+// 每个内核内部按通道数选专用路径（1 / 2 / 4 的倍数），其余走通用游标路径。
+
+typedef enum {
+  PCM_FMT_NONE = 0,     // 停流
+  PCM_FMT_S16,
+  PCM_FMT_S24,
+  PCM_FMT_S32,
+  PCM_FMT_F32,          // IEEE 754 单精度，±1.0 满幅
+  PCM_FMT_COUNT
+} pcm_fmt_t;
+
+// 打包内核：返回写出的字节数
+typedef uint32_t (*pcm_pack_fn)(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst);
+
+typedef struct {
+  uint8_t     bytes;    // 每样本字节数（线上）
+  pcm_pack_fn pack;
+} pcm_fmt_info_t;
+
+// 格式 → 内核表：切换格式时查一次，数据面只经函数指针调用，不按样本分支
+extern const pcm_fmt_info_t pcm_fmt_table[PCM_FMT_COUNT];
+
+uint32_t pcm_pack_s16(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst);
+uint32_t pcm_pack_s24(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst);
+uint32_t pcm_pack_s32(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst);
+uint32_t pcm_pack_f32(const int32_t* const* planar, uint32_t ch, uint32_t n_frames, uint32_t* dst);
+
+#endif
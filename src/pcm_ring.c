@@ -0,0 +1,68 @@
+#include <string.h>
+#include "pcm_ring.h"
+
+// M0+ 上 32-bit 对齐读写天然原子；acquire/release 只会生成 DMB，不需要 libatomic
+#define LOAD_ACQ(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_REL(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+void pcm_ring_init(pcm_ring_t* r, uint8_t* buf, uint32_t size) {
+  r->buf  = buf;
+  r->size = size;
+  r->mask = size - 1;
+  r->head = r->tail = 0;
+  r->overruns = r->underruns = 0;
+}
+
+uint32_t pcm_ring_level(const pcm_ring_t* r) {
+  return LOAD_ACQ(&r->head) - LOAD_ACQ(&r->tail);
+}
+
+uint32_t pcm_ring_space(const pcm_ring_t* r) {
+  return r->size - pcm_ring_level(r);
+}
+
+uint32_t pcm_ring_write(pcm_ring_t* r, const void* src, uint32_t n) {
+  uint32_t head = r->head;                        // 自己的索引，普通读即可
+  uint32_t tail = LOAD_ACQ(&r->tail);
+  if (r->size - (head - tail) < n) { r->overruns++; return 0; }
+
+  uint32_t off   = head & r->mask;
+  uint32_t first = r->size - off;
+  if (first > n) first = n;
+  memcpy(r->buf + off, src, first);
+  memcpy(r->buf, (const uint8_t*)src + first, n - first);
+  STORE_REL(&r->head, head + n);                  // 数据先落地，再发布 head
+  return n;
+}
+
+// 从环的逻辑位置 pos 拷出 n 字节（处理环自身的回绕）
+static void ring_copy_out(const pcm_ring_t* r, uint32_t pos, uint8_t* dst, uint32_t n) {
+  uint32_t off   = pos & r->mask;
+  uint32_t first = r->size - off;
+  if (first > n) first = n;
+  memcpy(dst, r->buf + off, first);
+  memcpy(dst + first, r->buf, n - first);
+}
+
+uint32_t pcm_ring_read2(pcm_ring_t* r, void* d0, uint32_t n0, void* d1, uint32_t n1) {
+  uint32_t tail = r->tail;
+  uint32_t head = LOAD_ACQ(&r->head);
+  uint32_t n    = n0 + n1;
+  if (head - tail < n) { r->underruns++; return 0; }
+
+  ring_copy_out(r, tail, (uint8_t*)d0, n0);
+  if (n1) ring_copy_out(r, tail + n0, (uint8_t*)d1, n1);
+  STORE_REL(&r->tail, tail + n);                  // 读完再释放空间
+  return n;
+}
+
+uint32_t pcm_ring_read(pcm_ring_t* r, void* dst, uint32_t n) {
+  return pcm_ring_read2(r, dst, n, NULL, 0);
+}
+
+void pcm_ring_discard_to(pcm_ring_t* r, uint32_t pos) {
+  uint32_t tail = r->tail;
+  uint32_t head = LOAD_ACQ(&r->head);
+  // 只允许向前丢弃到 [tail, head] 之间
+  if (pos - tail <= head - tail) STORE_REL(&r->tail, pos);
+}
@@ -0,0 +1,49 @@
+#ifndef __PCM_RING_H__
+#define __PCM_RING_H__
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== 单生产者/单消费者（SPSC）无锁字节环 =====
+// 生产者（core1 信号链）只写 head，消费者（core0 USB ISR）只写 tail，
+// 两边都只做一次 acquire 读对方索引 + 一次 release 写自己的索引，不加锁、不关中断。
+// head/tail 自由递增（uint32 回绕），size 必须是 2 的幂。
+
+typedef struct {
+  uint8_t*          buf;
+  uint32_t          size;
+  uint32_t          mask;
+  volatile uint32_t head;        // 生产者写
+  volatile uint32_t tail;        // 消费者写
+  volatile uint32_t overruns;    // 生产者写：空间不足被丢弃的写入次数
+  volatile uint32_t underruns;   // 消费者写：数据不足的读取次数
+} pcm_ring_t;
+
+void     pcm_ring_init(pcm_ring_t* r, uint8_t* buf, uint32_t size);
+
+// 两边都可调用（结果是瞬时快照）
+uint32_t pcm_ring_level(const pcm_ring_t* r);
+uint32_t pcm_ring_space(const pcm_ring_t* r);
+
+// 生产者：全部写入或不写（返回写入字节数；不足时计一次 overrun）
+uint32_t pcm_ring_write(pcm_ring_t* r, const void* src, uint32_t n);
+
+// 消费者：全部读出或不读（返回读出字节数；不足时计一次 underrun）
+uint32_t pcm_ring_read(pcm_ring_t* r, void* dst, uint32_t n);
+
+// 消费者：同上，但目标是两段（例如 EP FIFO 回绕前/后的线性区），按 n0 + n1 整体判断
+uint32_t pcm_ring_read2(pcm_ring_t* r, void* d0, uint32_t n0, void* d1, uint32_t n1);
+
+// 消费者：丢弃 pos 之前的数据（pos 是生产者某时刻的 head）
+void     pcm_ring_discard_to(pcm_ring_t* r, uint32_t pos);
+
+static inline uint32_t pcm_ring_head(const pcm_ring_t* r) { return r->head; }
+static inline uint32_t pcm_ring_tail(const pcm_ring_t* r) { return r->tail; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+#include <stddef.h>
+#include <string.h>
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "pdm_capture.h"
+#include "pdm_capture.pio.h"
+
+#define PDM_BUF        (2 * PDM_CAPTURE_HALF)
+#define PDM_HALF_BITS  10                       // log2(PDM_CAPTURE_HALF)：DMA 写地址回绕位数
+_Static_assert((1u << PDM_HALF_BITS) == PDM_CAPTURE_HALF, "PDM_HALF_BITS mismatch");
+
+static uint8_t  s_buf[PDM_BUF] __attribute__((aligned(PDM_BUF)));
+static PIO      s_pio = pio0;
+static uint     s_offset;
+static int      s_sm = -1;
+static int      s_dma[2] = { -1, -1 };
+static bool     s_running;
+static uint32_t s_wr, s_rd;                     // 已写入 / 已消费字节数（单调递增）
+static uint32_t s_last;                         // 上次看到的缓冲内写位置
+static bool     s_filled;                       // 开始采集后水位已攒到 PDM_CAPTURE_FILL
+static uint32_t s_avg;                          // 平滑后的水位（Q4）
+static uint8_t  s_wrap[PDM_CAPTURE_PEEK_MAX];   // 跨缓冲末尾的一块
+static pdm_capture_stats_t s_st;
+
+bool pdm_capture_init(void) {
+  if (!pio_can_add_program(s_pio, &pdm_in_program)) return false;
+  s_sm = pio_claim_unused_sm(s_pio, false);
+  s_dma[0] = dma_claim_unused_channel(false);
+  s_dma[1] = dma_claim_unused_channel(false);
+  if (s_sm < 0 || s_dma[0] < 0 || s_dma[1] < 0) return false;
+  s_offset = pio_add_program(s_pio, &pdm_in_program);
+  return true;
+}
+
+static void stop(void) {
+  if (!s_running) return;
+  pio_sm_set_enabled(s_pio, (uint)s_sm, false);
+  for (int i = 0; i < 2; i++) {                 // 先解开互链，否则中止一个会触发另一个
+    hw_write_masked(&dma_hw->ch[s_dma[i]].al1_ctrl, (uint32_t)s_dma[i] << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB,
+                    DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS);
+  }
+  dma_channel_abort((uint)s_dma[0]);
+  dma_channel_abort((uint)s_dma[1]);
+  pio_sm_clear_fifos(s_pio, (uint)s_sm);
+  s_running = false;
+}
+
+void pdm_capture_start(uint32_t clk_hz) {
+  stop();
+  if (s_sm < 0 || clk_hz == 0) return;
+  pdm_in_program_init(s_pio, (uint)s_sm, s_offset, CFG_MIC_PDM_CLK_PIN, CFG_MIC_PDM_DATA_PIN,
+                      (float)clock_get_hz(clk_sys) / (2.0f * (float)clk_hz));
+  for (int i = 0; i < 2; i++) {
+    dma_channel_config c = dma_channel_get_default_config((uint)s_dma[i]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, PDM_HALF_BITS);          // 写满半区后地址回到半区起点
+    channel_config_set_bswap(&c, true);                        // 先到的位在字的最高字节 → 内存里按时间顺序
+    channel_config_set_dreq(&c, pio_get_dreq(s_pio, (uint)s_sm, false));
+    channel_config_set_chain_to(&c, (uint)s_dma[i ^ 1]);
+    dma_channel_configure((uint)s_dma[i], &c, s_buf + i * PDM_CAPTURE_HALF, &s_pio->rxf[s_sm],
+                          PDM_CAPTURE_HALF / 4, i == 0);
+  }
+  s_wr = s_rd = s_last = 0;
+  s_filled  = false;
+  s_running = true;
+  pio_sm_set_enabled(s_pio, (uint)s_sm, true);
+}
+
+// 写位置 = 正在传输的通道所在半区 + 该通道已传字节（由剩余计数算，不读会回绕的写地址）。
+// 交接瞬间读到的是刚完成的一侧（计数 0 = 半区末尾），偏保守，不会越过真实位置。
+static void update_wr(void) {
+  uint32_t pos;
+  if (dma_channel_is_busy((uint)s_dma[0])) {
+    pos = PDM_CAPTURE_HALF - 4u * dma_hw->ch[s_dma[0]].transfer_count;
+  } else {
+    pos = 2u * PDM_CAPTURE_HALF - 4u * dma_hw->ch[s_dma[1]].transfer_count;
+  }
+  s_wr  += (pos - s_last) & (PDM_BUF - 1);
+  s_last = pos & (PDM_BUF - 1);
+}
+
+// 读位置退到写位置之前 FILL 字节（按校正步长对齐，保持抽取的相位）
+static void refill(void) {
+  s_rd  = (s_wr - PDM_CAPTURE_FILL) & ~(uint32_t)(PDM_CAPTURE_SLIP - 1);
+  s_avg = PDM_CAPTURE_FILL << 4;
+}
+
+const uint8_t* pdm_capture_peek(uint32_t n) {
+  if (!s_running) return NULL;
+  update_wr();
+  if (!s_filled) {                                             // 开始采集：先攒到半满
+    if (s_wr - s_rd < PDM_CAPTURE_FILL) return NULL;
+    s_filled = true;
+    refill();
+  } else if (s_wr - s_rd > PDM_BUF - PDM_CAPTURE_HALF / 2) {   // DMA 即将追上读位置：校正没跟上，整段重新对齐
+    refill();
+    s_st.overruns++;
+  }
+  uint32_t level = s_wr - s_rd;
+  if (level < n) return NULL;
+  s_avg += level - (s_avg >> 4);                               // 一阶平滑（Q4），滤掉按帧取数的锯齿
+  uint32_t avg = s_avg >> 4;
+  if (avg > PDM_CAPTURE_FILL + PDM_CAPTURE_WINDOW && level >= n + PDM_CAPTURE_SLIP) {
+    s_rd  += PDM_CAPTURE_SLIP;                                 // PDM 偏快：丢一块
+    s_avg -= PDM_CAPTURE_SLIP << 4;
+    s_st.dropped++;
+  } else if (avg + PDM_CAPTURE_WINDOW < PDM_CAPTURE_FILL) {
+    s_rd  -= PDM_CAPTURE_SLIP;                                 // PDM 偏慢：重复一块（水位不到半满，旧数据还在）
+    s_avg += PDM_CAPTURE_SLIP << 4;
+    s_st.repeated++;
+  }
+  uint32_t off = s_rd & (PDM_BUF - 1);
+  if (off + n <= PDM_BUF) return s_buf + off;
+  memcpy(s_wrap, s_buf + off, PDM_BUF - off);                  // 跨缓冲末尾：拼成连续的一块
+  memcpy(s_wrap + (PDM_BUF - off), s_buf, n - (PDM_BUF - off));
+  return s_wrap;
+}
+
+void pdm_capture_release(uint32_t n) {
+  s_rd += n;
+}
+
+void pdm_capture_get_stats(pdm_capture_stats_t* out) {
+  *out = s_st;
+}
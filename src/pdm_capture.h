@@ -0,0 +1,54 @@
+#ifndef __PDM_CAPTURE_H__
+#define __PDM_CAPTURE_H__
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== PDM 位流采集 =====
+// 固件（pdm_capture.c）：PIO 在 CLK 引脚输出 PDM 时钟、在下降沿移入 DATA（SEL 接地的左声道麦克风），
+// 满 32 位自动推入 RX FIFO；两个 DMA 通道乒乓写同一缓冲的两半（写地址按半区回绕，互相链式触发），不占 CPU、不进中断。
+// 主机（host/shim/pdm_capture_sim.c）：循环读一个位流文件，按仿真时间与 PDM 时钟放出字节，代替 DMA。
+// 只有 core1 生产者调用 start/peek/release。
+
+#ifndef CFG_MIC_PDM_CLK_PIN
+#define CFG_MIC_PDM_CLK_PIN   2
+#endif
+#ifndef CFG_MIC_PDM_DATA_PIN
+#define CFG_MIC_PDM_DATA_PIN  3
+#endif
+
+#define PDM_CAPTURE_HALF      1024        // 字节；48k/OSR64 下一个半区约 2.7 ms
+#define PDM_CAPTURE_PEEK_MAX  256         // 一次 peek 的上限（= 一块 32 样本 × OSR 64 / 8）
+
+// 漂移校正：PDM 时钟（clk_sys 分频）与 USB SOF 不同源。采集缓冲的水位保持在半满附近：
+// 每次取数时对水位做一阶平滑，离开 FILL ± WINDOW 就丢掉或重复一块 256 位（OSR 64 时 4 个输出样本），
+// 而不是等缓冲溢出再整段跳过。开始采集后先攒到 FILL 才放出数据。
+#define PDM_CAPTURE_FILL      PDM_CAPTURE_HALF
+#define PDM_CAPTURE_WINDOW    128         // 字节
+#define PDM_CAPTURE_SLIP      32          // 字节：一次校正的步长，是每个输出样本字节数（OSR/8）的整数倍
+
+typedef struct {
+  uint32_t overruns;                      // 缓冲即将被覆盖、重新对齐到 FILL 的次数（校正跟不上时的兜底）
+  uint32_t dropped;                       // 水位偏高、丢掉的块数（PDM 时钟偏快）
+  uint32_t repeated;                      // 水位偏低、重复的块数（PDM 时钟偏慢）
+} pdm_capture_stats_t;
+
+// core0 启动时：占用 PIO 状态机与 DMA 通道（主机：位流文件是否已加载）
+bool     pdm_capture_init(void);
+// 按 PDM 时钟（Hz）开始采集，之前的数据丢弃；0 = 停止
+void     pdm_capture_start(uint32_t clk_hz);
+// 已采集且未消费的字节不少于 n（≤ PDM_CAPTURE_PEEK_MAX）时返回连续 n 字节的起始地址，否则返回 NULL；
+// 跨缓冲末尾的一块先拼进暂存区。每次成功取数时顺带做上面的漂移校正。
+const uint8_t* pdm_capture_peek(uint32_t n);
+void     pdm_capture_release(uint32_t n);
+// 累计计数（core1 写，其他核读到的是某一时刻的单个字）
+void     pdm_capture_get_stats(pdm_capture_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+#include <math.h>
+#include <string.h>
+#include "pdm_decim.h"
+
+#define HB_KAISER_BETA  8.0     // 半带阻带约 −85 dB（量化后）
+#define CMP_PASS        0.42    // 补偿拟合到 0.42 fs
+#define CMP_GRID        128
+#define DC_SHIFT        10      // 直流阻断极点 1 − 2^-10（48k 下约 7.5 Hz）
+
+static int32_t s_cic[PDM_WIN_MAX][256];          // 当前 OSR 的 CIC 字节表（R = 32 时用满 16 张，16 KB）
+static int16_t s_hb[2][PDM_HB_K];                // [0] = OSR_LOW，[1] = OSR_HIGH
+static int16_t s_cmp[2][PDM_CMP_HALF + 1];
+
+static inline uint32_t osr_idx(uint32_t osr) { return osr == PDM_OSR_HIGH; }
+
+uint32_t pdm_osr_for(uint32_t fs) {
+  uint32_t osr = fs <= 48000 ? PDM_OSR_LOW : fs <= 96000 ? PDM_OSR_HIGH : 0;
+  return osr * fs >= PDM_CLK_MIN_HZ ? osr : 0;
+}
+
+const int16_t* pdm_decim_hb_coef(uint32_t osr)  { return s_hb[osr_idx(osr)]; }
+const int16_t* pdm_decim_cmp_coef(uint32_t osr) { return s_cmp[osr_idx(osr)]; }
+
+// ---------- 上电设计：半带 + 补偿（浮点，只跑一次）----------
+
+static double bessel_i0(double x) {
+  double sum = 1.0, term = 1.0, q = x * x / 4.0;
+  for (int k = 1; k < 32 && term > 1e-12 * sum; k++) {
+    term *= q / ((double)k * k);
+    sum  += term;
+  }
+  return sum;
+}
+
+// 半带：h[c ± (2i+1)] = 0.5·sinc((2i+1)/2)·w，偶数偏移为 0，中心 0.5（运算时用移位）。
+// 一侧系数和量化后精确为 0.25（Q15 = 8192），直流增益恰好为 1。
+static void design_hb(int16_t* hb) {
+  const double c = 2 * PDM_HB_K - 1, i0b = bessel_i0(HB_KAISER_BETA);
+  int32_t sum = 0;
+  uint32_t big = 0;
+  for (uint32_t i = 0; i < PDM_HB_K; i++) {
+    double t = 2.0 * i + 1.0;
+    double x = t / c;
+    double w = bessel_i0(HB_KAISER_BETA * sqrt(1.0 - x * x)) / i0b;
+    double s = sin(M_PI * t / 2.0) / (M_PI * t / 2.0);
+    hb[i] = (int16_t)lrint(0.5 * s * w * 32768.0);
+    sum  += hb[i];
+    if (hb[i] > hb[big]) big = i;
+  }
+  hb[big] = (int16_t)(hb[big] + (8192 - sum));
+}
+
+static double cic_resp(double nu, uint32_t R) {            // nu = f / fs，CIC 输入率 = 2R·fs
+  if (nu == 0) return 1.0;
+  double a = M_PI * nu / 2.0;
+  double r = sin(a) / ((double)R * sin(a / (double)R));
+  return r * r * r * r;
+}
+
+static double hb_resp(const int16_t* hb, double nu) {      // 半带运行在 2fs
+  double v = 0.5;
+  for (uint32_t i = 0; i < PDM_HB_K; i++) v += 2.0 * hb[i] / 32768.0 * cos(M_PI * nu * (2.0 * i + 1.0));
+  return v;
+}
+
+// 补偿：对称 9 抽头，最小二乘拟合 1 / (CIC × 半带) 在 [0, CMP_PASS·fs] 上
+static void design_cmp(int16_t* cmp, const int16_t* hb, uint32_t R) {
+  enum { U = PDM_CMP_HALF + 1 };
+  double m[U][U + 1];
+  memset(m, 0, sizeof(m));
+  for (uint32_t g = 0; g <= CMP_GRID; g++) {
+    double nu = CMP_PASS * g / CMP_GRID, b[U];
+    double tgt = 1.0 / (cic_resp(nu, R) * hb_resp(hb, nu));
+    b[0] = 1.0;
+    for (uint32_t k = 1; k < U; k++) b[k] = 2.0 * cos(2.0 * M_PI * k * nu);
+    for (uint32_t r = 0; r < U; r++) {
+      for (uint32_t c = 0; c < U; c++) m[r][c] += b[r] * b[c];
+      m[r][U] += b[r] * tgt;
+    }
+  }
+  for (uint32_t c = 0; c < U; c++)                          // 正规方程（对称正定，不选主元）
+    for (uint32_t r = c + 1; r < U; r++) {
+      double f = m[r][c] / m[c][c];
+      for (uint32_t j = c; j <= U; j++) m[r][j] -= f * m[c][j];
+    }
+  double a[U];
+  for (int r = U - 1; r >= 0; r--) {
+    double s = m[r][U];
+    for (uint32_t j = (uint32_t)r + 1; j < U; j++) s -= m[r][j] * a[j];
+    a[r] = s / m[r][r];
+  }
+  int32_t sum = 0;
+  for (uint32_t k = 0; k < U; k++) {
+    cmp[k] = (int16_t)lrint(a[k] * 16384.0);
+    sum   += k ? 2 * cmp[k] : cmp[k];
+  }
+  cmp[0] = (int16_t)(cmp[0] + (16384 - sum));               // 直流增益恰好为 1
+}
+
+void pdm_decim_table_init(void) {
+  design_hb(s_hb[0]);
+  design_hb(s_hb[1]);
+  design_cmp(s_cmp[0], s_hb[0], PDM_OSR_LOW / 2);
+  design_cmp(s_cmp[1], s_hb[1], PDM_OSR_HIGH / 2);
+}
+
+// ---------- core1：CIC 字节表（纯整数）----------
+
+// sinc^4 系数 = R 点滑动和卷 4 次（长 4R-3，末尾补 0 到 4R），缩放到增益 R^4 → 2^29。
+// 每个字节位置：全 0 字节 = 8 个 −1；置位第 j 位（字节内从低往高）相当于把该位的 −h 换成 +h。
+static void build_cic(uint32_t R) {
+  static int32_t h[PDM_CIC_ORDER * PDM_OSR_LOW / 2];
+  const uint32_t n = PDM_CIC_ORDER * R;
+  uint32_t shift = 29, len = 1;
+  memset(h, 0, sizeof(h));
+  h[0] = 1;
+  for (uint32_t st = 0; st < PDM_CIC_ORDER; st++) {
+    len += R - 1;
+    for (uint32_t i = len; i-- > 0; ) {                    // 原地：h[i] = Σ h[i-R+1 .. i]
+      int32_t run = 0;
+      for (uint32_t j = 0; j < R && j <= i; j++) run += h[i - j];
+      h[i] = run;
+    }
+  }
+  for (uint32_t r = R; r > 1; r >>= 1) shift -= PDM_CIC_ORDER;
+  for (uint32_t k = 0; k < n / 8; k++) {
+    int32_t* t = s_cic[k];
+    int32_t  base = 0;
+    for (uint32_t i = 0; i < 8; i++) base -= h[8 * k + i] << shift;
+    t[0] = base;
+    for (uint32_t j = 0; j < 8; j++)
+      for (uint32_t b = 1u << j; b < (2u << j); b++)
+        t[b] = t[b - (1u << j)] + ((2 * h[8 * k + 7 - j]) << shift);
+  }
+}
+
+bool pdm_decim_init(pdm_decim_t* d, uint32_t osr) {
+  memset(d, 0, sizeof(*d));
+  if (osr != PDM_OSR_LOW && osr != PDM_OSR_HIGH) return false;
+  d->osr = osr;
+  d->R   = osr / 2;
+  d->hb  = s_hb[osr_idx(osr)];
+  d->cmp = s_cmp[osr_idx(osr)];
+  build_cic(d->R);
+  return true;
+}
+
+// ---------- 运行 ----------
+
+// p·k 的 Q15/Q14 乘加：p 拆成有符号高 16 位与无符号低 16 位各乘一次（M0+ 只有 32x32→32）
+#define MAC_SPLIT(hi, lo, p, k) do { (hi) += ((p) >> 16) * (k); (lo) += ((int32_t)((p) & 0xFFFF) * (k)) >> 16; } while (0)
+
+void pdm_decim_run(pdm_decim_t* d, const uint8_t* in, int32_t* out, uint32_t n) {
+  const uint32_t hop = d->R / 8, span = PDM_CIC_ORDER * d->R / 8, keep = span - hop;
+
+  // 1) CIC：每 hop 字节出一个 2fs 样本，= span 次查表之和
+  memcpy(d->win + keep, in, 2 * n * hop);
+  int32_t* hx = d->hbx + PDM_HB_LEN - 1;
+  for (uint32_t j = 0; j < 2 * n; j++) {
+    const uint8_t* p = d->win + j * hop;
+    int32_t acc = 0;
+    for (uint32_t k = 0; k < span; k++) acc += s_cic[k][p[k]];
+    hx[j] = acc;
+  }
+  memmove(d->win, d->win + 2 * n * hop, keep);
+
+  // 2) 半带 2fs → fs：只算奇数偏移的对称对，中心 0.5 用移位
+  int32_t* cx = d->cx + PDM_CMP_LEN - 1;
+  for (uint32_t m = 0; m < n; m++) {
+    const int32_t* x = d->hbx + 2 * m + 1 + (2 * PDM_HB_K - 1);
+    int32_t hi = 0, lo = 0;
+    for (uint32_t i = 0; i < PDM_HB_K; i++) {
+      int32_t p = x[-(int32_t)(2 * i + 1)] + x[2 * i + 1];
+      MAC_SPLIT(hi, lo, p, d->hb[i]);
+    }
+    cx[m] = 2 * (hi + lo) + (x[0] >> 1);
+  }
+  memmove(d->hbx, d->hbx + 2 * n, (PDM_HB_LEN - 1) * sizeof(int32_t));
+
+  // 3) CIC 下垂补偿（Q14）+ 直流阻断 → Q31
+  for (uint32_t m = 0; m < n; m++) {
+    const int32_t* x = d->cx + m + PDM_CMP_HALF;
+    int32_t hi = 0, lo = 0;
+    MAC_SPLIT(hi, lo, x[0], d->cmp[0]);
+    for (uint32_t i = 1; i <= PDM_CMP_HALF; i++) {
+      int32_t p = x[-(int32_t)i] + x[i];
+      MAC_SPLIT(hi, lo, p, d->cmp[i]);
+    }
+    int32_t v = 4 * (hi + lo);                                // Q29
+    int32_t y = v - d->dc_x1 + d->dc_y1 - (d->dc_y1 >> DC_SHIFT);
+    d->dc_x1 = v;
+    d->dc_y1 = y;
+    out[m] = y > (INT32_MAX >> 2) ? INT32_MAX : y < -(INT32_MAX >> 2) ? INT32_MIN : y * 4;
+  }
+  memmove(d->cx, d->cx + n, (PDM_CMP_LEN - 1) * sizeof(int32_t));
+}
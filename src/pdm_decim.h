@@ -0,0 +1,56 @@
+#ifndef __PDM_DECIM_H__
+#define __PDM_DECIM_H__
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== PDM → PCM 抽取（纯整数，固件与主机共用）=====
+// 1-bit 位流（字节内高位是先到的位）按 OSR 倍抽取到 fs：
+//   CIC（4 阶 sinc，抽取 R = OSR/2，查字节表）→ 半带 FIR（2fs → fs）→ 9 抽头 CIC 下垂补偿 FIR → 直流阻断。
+// CIC 按字节查表：窗口 4R 位拆成 R/2 个字节，每个字节位置一张 256 项表（该字节 8 个 ±1 位乘对应系数之和），
+// 一个 CIC 输出 = R/2 次查表相加，没有逐位运算。表在切换 OSR 时由 core1 用整数重建（< 1 ms）；
+// 两种 OSR 的半带与补偿系数上电时算好。内部 Q29（调制深度 ±1 = ±2^29），输出 Q31。
+
+#define PDM_OSR_LOW       64          // fs ≤ 48 kHz：PDM 时钟 = 64 fs（48k → 3.072 MHz）
+#define PDM_OSR_HIGH      32          // fs ≤ 96 kHz：PDM 时钟 = 32 fs（96k → 3.072 MHz）
+#define PDM_CLK_MIN_HZ    1000000     // 常见 PDM 麦克风的最低时钟；低于它的采样率（8 kHz）不支持
+#define PDM_CIC_ORDER     4
+#define PDM_BLOCK         32          // 每次最多输出的样本数（与生产块一致）
+#define PDM_HB_K          18          // 半带：每侧非零抽头数，长度 4K-1（71 抽头，阻带约 −85 dB）
+#define PDM_HB_LEN        (4 * PDM_HB_K - 1)
+#define PDM_CMP_HALF      4           // 补偿 FIR：长度 2*HALF+1
+#define PDM_CMP_LEN       (2 * PDM_CMP_HALF + 1)
+#define PDM_WIN_MAX       (PDM_CIC_ORDER * PDM_OSR_LOW / 2 / 8)   // CIC 窗口字节数（R = 32 时 16）
+
+typedef struct {
+  uint32_t osr;                                      // 0 = 未配置
+  uint32_t R;                                        // CIC 抽取比
+  const int16_t* hb;                                 // 半带系数（Q15，只存奇数偏移的一侧）
+  const int16_t* cmp;                                // 补偿系数（Q14，center..edge）
+  uint8_t  win[PDM_WIN_MAX + PDM_BLOCK * PDM_OSR_LOW / 8];   // [CIC 历史字节][本块新字节]
+  int32_t  hbx[PDM_HB_LEN + 2 * PDM_BLOCK];          // 半带输入（2fs）
+  int32_t  cx[PDM_CMP_LEN + PDM_BLOCK];              // 补偿输入（fs）
+  int32_t  dc_x1, dc_y1;                             // 直流阻断
+} pdm_decim_t;
+
+// 上电时调用一次：两种 OSR 的半带与补偿系数（浮点设计，量化成定点）
+void     pdm_decim_table_init(void);
+// fs → OSR；超出 PDM 能支持的采样率（PDM 时钟不在麦克风范围内 / OSR 太低）时返回 0
+uint32_t pdm_osr_for(uint32_t fs);
+// core1：按 OSR 复位状态并重建 CIC 字节表
+bool     pdm_decim_init(pdm_decim_t* d, uint32_t osr);
+// 消耗 n × osr / 8 字节位流，输出 n（≤ PDM_BLOCK）个 Q31 样本
+void     pdm_decim_run(pdm_decim_t* d, const uint8_t* in, int32_t* out, uint32_t n);
+
+// 主机侧基准用：当前 CIC 与某 OSR 的半带/补偿系数
+const int16_t* pdm_decim_hb_coef(uint32_t osr);
+const int16_t* pdm_decim_cmp_coef(uint32_t osr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#include "rate_sched.h"
+#include "uac2_rates.h"
+
+// —— 采样率表的静态校验 ——
+#define RATE_LE_MAX_(mn, mx, res)  && ((mx) <= UAC2_RATE_MAX)
+#define RATE_IS_MAX_(mn, mx, res)  || ((mx) == UAC2_RATE_MAX)
+#define RATE_WELL_FORMED_(mn, mx, res) \
+  && ((res) == 0 ? (mn) == (mx) : ((mn) < (mx) && ((mx) - (mn)) % (res) == 0))
+_Static_assert(1 UAC2_RATE_TABLE(RATE_LE_MAX_), "rate table entry above UAC2_RATE_MAX");
+_Static_assert(0 UAC2_RATE_TABLE(RATE_IS_MAX_), "UAC2_RATE_MAX is not in the rate table");
+_Static_assert(1 UAC2_RATE_TABLE(RATE_WELL_FORMED_), "malformed rate table entry");
+#define RATE_HAS_DEFAULT_(mn, mx, res) \
+  || (UAC2_RATE_DEFAULT >= (mn) && UAC2_RATE_DEFAULT <= (mx) && (UAC2_RATE_DEFAULT - (mn)) % ((res) ? (res) : 1) == 0)
+_Static_assert(0 UAC2_RATE_TABLE(RATE_HAS_DEFAULT_), "UAC2_RATE_DEFAULT is not in the rate table");
+
+static uint64_t gcd64(uint64_t a, uint64_t b) {
+  while (b) { uint64_t t = a % b; a = b; b = t; }
+  return a;
+}
+
+void rate_sched_init(rate_sched_t* s, uint32_t fs_num, uint32_t fs_den, uint32_t interval_us) {
+  // 每间隔样本数 = fs_num × interval_us / (fs_den × 10^6)，约分后分母放得进 32 位
+  uint64_t num = (uint64_t)fs_num * interval_us;
+  uint64_t den = (uint64_t)(fs_den ? fs_den : 1) * 1000000u;
+  uint64_t g   = gcd64(num, den);
+  if (g) { num /= g; den /= g; }
+  s->base = (uint32_t)(num / den);
+  s->rem  = (uint32_t)(num % den);
+  s->den  = (uint32_t)den;
+  s->acc  = 0;
+}
+
+bool rate_is_supported(uint32_t fs) {
+#define RATE_MATCH_(mn, mx, res) \
+  if (fs >= (mn) && fs <= (mx) && ((res) == 0 || (fs - (mn)) % ((res) ? (res) : 1) == 0)) return true;
+  UAC2_RATE_TABLE(RATE_MATCH_)
+#undef RATE_MATCH_
+  return false;
+}
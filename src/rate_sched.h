@@ -0,0 +1,29 @@
+#ifndef __RATE_SCHED_H__
+#define __RATE_SCHED_H__
+#include <stdbool.h>
+#include <stdint.h>
+
+// ===== 每个服务间隔的样本数调度器 =====
+// 精确有理数（Bresenham）分配：N 个间隔内累计样本数恒为 floor(N × fs × T)，没有长期漂移。
+// 采样率可以是任意有理数 fs_num / fs_den Hz（如 48000×1000/1001），间隔 T 以 µs 计（FS 下 1000）。
+
+typedef struct {
+  uint32_t base;    // 每间隔整数部分
+  uint32_t rem;     // 小数部分分子
+  uint32_t den;     // 小数部分分母
+  uint32_t acc;     // 累加器 0..den-1
+} rate_sched_t;
+
+void rate_sched_init(rate_sched_t* s, uint32_t fs_num, uint32_t fs_den, uint32_t interval_us);
+
+static inline uint32_t rate_sched_next(rate_sched_t* s) {
+  uint32_t n = s->base;
+  s->acc += s->rem;
+  if (s->acc >= s->den) { s->acc -= s->den; n++; }
+  return n;
+}
+
+// 是否在描述符声明的采样率表内（离散值或步进区间上的点）
+bool rate_is_supported(uint32_t fs);
+
+#endif
@@ -0,0 +1,73 @@
+#include "requant.h"
+
+// Q23 域：16-bit 的 1 LSB = 256
+#define RQ_SHIFT     8
+#define RQ_LSB       (1 << RQ_SHIFT)
+#define RQ_MAX       (INT16_MAX * RQ_LSB)
+#define RQ_MIN       (INT16_MIN * RQ_LSB)
+#define RQ_ERR_MAX   (4 * RQ_LSB)       // 削波时误差反馈限幅，防止整形器失稳
+
+static inline uint32_t xorshift32(uint32_t* s) {
+  uint32_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *s = x;
+}
+
+// 两个独立 8-bit 均匀数之差：[-255, 255] 的三角分布 = ±1 LSB TPDF
+static inline int32_t tpdf(uint32_t* rng) {
+  uint32_t r = xorshift32(rng);
+  return (int32_t)(r & 0xFFu) - (int32_t)((r >> 8) & 0xFFu);
+}
+
+// 舍入到 LSB 网格并饱和（v 已含抖动）
+static inline int32_t quantize(int32_t v) {
+  int32_t q = (v + RQ_LSB / 2) & ~(RQ_LSB - 1);
+  return q > RQ_MAX ? RQ_MAX : (q < RQ_MIN ? RQ_MIN : q);
+}
+
+static inline int32_t err_clamp(int32_t e) {
+  return e > RQ_ERR_MAX ? RQ_ERR_MAX : (e < -RQ_ERR_MAX ? -RQ_ERR_MAX : e);
+}
+
+// Q23 → Q31（低 16 位为 0）；先转无符号再移位，避免负数左移
+#define RQ_OUT(q)   ((int32_t)((uint32_t)(q) << RQ_SHIFT))
+
+void requant_tpdf(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng) {
+  (void)ch;
+  for (uint32_t i = 0; i < n; i++) buf[i] = RQ_OUT(quantize((buf[i] >> RQ_SHIFT) + tpdf(rng)));
+}
+
+// NTF = 1 - z^-1：v = x - e[n-1]，e = y - v
+void requant_tpdf_ns1(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng) {
+  int32_t e1 = ch->e1;
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t v = (buf[i] >> RQ_SHIFT) - e1;
+    int32_t q = quantize(v + tpdf(rng));
+    e1 = err_clamp(q - v);
+    buf[i] = RQ_OUT(q);
+  }
+  ch->e1 = e1;
+}
+
+// NTF = (1 - z^-1)^2：v = x - 2 e[n-1] + e[n-2]
+void requant_tpdf_ns2(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng) {
+  int32_t e1 = ch->e1, e2 = ch->e2;
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t v = (buf[i] >> RQ_SHIFT) - 2 * e1 + e2;
+    int32_t q = quantize(v + tpdf(rng));
+    e2 = e1;
+    e1 = err_clamp(q - v);
+    buf[i] = RQ_OUT(q);
+  }
+  ch->e1 = e1;
+  ch->e2 = e2;
+}
+
+const requant_fn requant_table[REQUANT_COUNT] = {
+  [REQUANT_TRUNC]    = 0,
+  [REQUANT_TPDF]     = requant_tpdf,
+  [REQUANT_TPDF_NS1] = requant_tpdf_ns1,
+  [REQUANT_TPDF_NS2] = requant_tpdf_ns2,
+};
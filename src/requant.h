@@ -0,0 +1,42 @@
+#ifndef __REQUANT_H__
+#define __REQUANT_H__
+#include <stdint.h>
+
+// ===== 16-bit 线上格式的重新量化：TPDF 抖动 + 误差反馈噪声整形 =====
+// 信号链内部是 Q31，pcm_pack_s16 只取高半字（向下截断）：低电平时量化误差与信号相关，表现为谐波和 -0.5 LSB 直流。
+// 这里在打包之前把每个通道平面原地量化到 16-bit 网格（低 16 位清零，打包时截断就是精确结果）：
+// * TPDF 抖动：xorshift32 一次给出两个 8-bit 均匀数，相减得到 ±1 LSB 的三角分布，误差与信号无关（噪底约 -96 dBFS）；
+// * 一阶 / 二阶误差反馈：噪声传递函数 (1 - z^-1) / (1 - z^-1)^2，把抖动后的量化噪声推向高频
+//   （总噪声功率更大，低频段更低；96 kHz 时大部分挪到 20 kHz 以上）。
+// 全部 32 位整数运算：先右移到 Q23（8 位余量，误差反馈不会溢出），亚 LSB 精度保留 8 位。
+// 每条流一个随机数状态、每个通道一份误差状态；只给 16-bit Alt 用（24/32-bit、float 的量化误差在 -140 dBFS 以下）。
+
+typedef enum {
+  REQUANT_TRUNC = 0,    // 不处理：保持原来的截断（对照）
+  REQUANT_TPDF,         // TPDF 抖动 + 舍入
+  REQUANT_TPDF_NS1,     // TPDF + 一阶误差反馈
+  REQUANT_TPDF_NS2,     // TPDF + 二阶误差反馈
+  REQUANT_COUNT
+} requant_mode_t;
+
+#ifndef CFG_MIC_REQUANT
+#define CFG_MIC_REQUANT   REQUANT_TPDF    // 上电模式；运行时可经厂商请求 VENDOR_REQ_REQUANT_SET 切换
+#endif
+
+typedef struct {
+  int32_t e1, e2;       // 最近两个样本的总误差（Q23，含抖动）
+} requant_ch_t;
+
+// 原地量化一个通道平面；rng 为该流的 xorshift32 状态（非 0）
+typedef void (*requant_fn)(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng);
+
+// 模式 → 内核：REQUANT_TRUNC 为 0（调用方跳过）；切换模式时查一次，数据面不按样本分支
+extern const requant_fn requant_table[REQUANT_COUNT];
+
+void requant_tpdf(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng);
+void requant_tpdf_ns1(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng);
+void requant_tpdf_ns2(int32_t* buf, uint32_t n, requant_ch_t* ch, uint32_t* rng);
+
+static inline void requant_reset(requant_ch_t* ch) { ch->e1 = ch->e2 = 0; }
+
+#endif
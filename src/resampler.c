@@ -0,0 +1,156 @@
+#include <math.h>
+#include <string.h>
+#include "resampler.h"
+
+#define RS_KAISER_BETA  9.0     // 阻带约 −90 dB（Q15 系数量化噪底在同一量级）
+#define RS_CUTOFF       0.92    // −6 dB 点 = 0.92 × 较低一侧的 Nyquist，混叠只落在过渡带
+
+static int16_t    s_pool[CFG_MIC_RESAMPLE_POOL];
+static uint32_t   s_pool_used;
+static rs_ratio_t s_ratio[RS_RATIOS_MAX];
+static uint32_t   s_nratio;
+
+static uint32_t gcd32(uint32_t a, uint32_t b) {
+  while (b) { uint32_t t = a % b; a = b; b = t; }
+  return a;
+}
+
+// 0 阶修正贝塞尔函数（级数），只在上电建表时用
+static double bessel_i0(double x) {
+  double sum = 1.0, term = 1.0, q = x * x / 4.0;
+  for (int k = 1; k < 32 && term > 1e-12 * sum; k++) {
+    term *= q / ((double)k * k);
+    sum  += term;
+  }
+  return sum;
+}
+
+// 原型滤波器长 N = L × taps，按相拆开：coef[r][i] = L·h[r + (taps-1-i)·L]（最旧的输入乘第 0 个系数）。
+// 每相单独归一化到和 = 32768，量化误差补到该相最大的系数上，保证每个相位的直流增益完全相同。
+static bool build_table(int16_t* dst, uint32_t L, uint32_t D, uint32_t taps) {
+  const uint32_t N   = L * taps;
+  const double   mid = (N - 1) / 2.0;
+  const double   fc  = RS_CUTOFF / (double)D;              // sinc 的零点间隔 = D / RS_CUTOFF 个原型样本
+  const double   i0b = bessel_i0(RS_KAISER_BETA);
+  static double ph[RS_TAPS_MAX];                            // 不放栈上（core0 栈只有 2 KB）
+  for (uint32_t r = 0; r < L; r++) {
+    double sum = 0;
+    for (uint32_t i = 0; i < taps; i++) {
+      double t = (double)(r + (taps - 1 - i) * L) - mid;
+      double x = 2.0 * t / (double)(N - 1);
+      double w = bessel_i0(RS_KAISER_BETA * sqrt(x * x < 1.0 ? 1.0 - x * x : 0.0)) / i0b;
+      double s = t == 0 ? 1.0 : sin(M_PI * fc * t) / (M_PI * fc * t);
+      ph[i] = fc * s * w;
+      sum  += ph[i];
+    }
+    int16_t* c = dst + r * taps;
+    int32_t  q = 0, mag = 0;
+    uint32_t big = 0;
+    for (uint32_t i = 0; i < taps; i++) {
+      double v = ph[i] / sum * 32768.0;
+      if (v > 32767.0 || v < -32768.0) return false;
+      c[i] = (int16_t)lrint(v);
+      q   += c[i];
+      mag += c[i] < 0 ? -c[i] : c[i];
+      if (c[i] > c[big]) big = i;
+    }
+    if (mag >= 120000) return false;                          // rs_dot 的 hi 路要求 Σ|c| < 4（sinc 实际约 1.9）
+    int32_t fix = c[big] + (32768 - q);
+    if (fix > 32767) return false;
+    c[big] = (int16_t)fix;
+  }
+  return true;
+}
+
+static void add_ratio(uint32_t src_fs, uint32_t dst_fs) {
+  if (dst_fs == src_fs || s_nratio >= RS_RATIOS_MAX) return;
+  for (uint32_t i = 0; i < s_nratio; i++) if (s_ratio[i].out_fs == dst_fs) return;   // 步进区间与离散值重复
+  uint32_t g = gcd32(src_fs, dst_fs);
+  uint32_t L = dst_fs / g, M = src_fs / g;
+  if (M > L * RS_DECIM_MAX || L > 0xFFFF) return;
+  uint32_t D    = L > M ? L : M;                              // 截止频率按较低一侧的采样率
+  uint32_t taps = (CFG_MIC_RESAMPLE_TAPS * D + L - 1) / L;
+
+  // 截止频率只取决于 (L, D)：147/80 与 147/40 这类升采样共用一张表
+  const int16_t* coef = 0;
+  for (uint32_t i = 0; i < s_nratio && !coef; i++) {
+    const rs_ratio_t* o = &s_ratio[i];
+    if (o->L == L && o->taps == taps && (o->L > o->M ? o->L : o->M) == D) coef = o->coef;
+  }
+  if (!coef) {
+    if (s_pool_used + L * taps > CFG_MIC_RESAMPLE_POOL) return;
+    if (!build_table(&s_pool[s_pool_used], L, D, taps)) return;
+    coef = &s_pool[s_pool_used];
+    s_pool_used += L * taps;
+  }
+  s_ratio[s_nratio++] = (rs_ratio_t){ src_fs, dst_fs, (uint16_t)L, (uint16_t)M, (uint16_t)taps, coef };
+}
+
+uint32_t resampler_table_init(uint32_t src_fs) {
+  s_pool_used = 0;
+  s_nratio    = 0;
+  if (src_fs == 0) return 0;
+#define RS_ADD_RANGE_(mn, mx, res) \
+  for (uint32_t fs = (mn); fs <= (mx); fs += (res) ? (res) : ((mx) - (mn) + 1)) add_ratio(src_fs, fs);
+  UAC2_RATE_TABLE(RS_ADD_RANGE_)
+#undef RS_ADD_RANGE_
+  return s_nratio;
+}
+
+const rs_ratio_t* resampler_find(uint32_t src_fs, uint32_t dst_fs) {
+  for (uint32_t i = 0; i < s_nratio; i++)
+    if (s_ratio[i].in_fs == src_fs && s_ratio[i].out_fs == dst_fs) return &s_ratio[i];
+  return 0;
+}
+
+const rs_ratio_t* resampler_ratio(uint32_t i) {
+  return i < s_nratio ? &s_ratio[i] : 0;
+}
+
+uint32_t resampler_pool_used(void) {
+  return s_pool_used;
+}
+
+void resampler_reset(resampler_t* s, const rs_ratio_t* r) {
+  s->r   = r;
+  s->acc = r ? r->L : 0;                                      // 第一个输出先取一个输入，与 x[0] 对齐
+  memset(s->hist, 0, sizeof(s->hist));
+}
+
+// 一个输出点：x[0..taps-1] · c[0..taps-1]。样本（丢掉最低 1 位）拆成 hi（有符号高 15 位）与 lo（无符号中间 16 位），
+// 两路 32-bit 乘加；建表保证每相 Σ|c| < 4（Q15），hi 路不溢出
+static inline int32_t rs_dot(const int32_t* x, const int16_t* c, uint32_t taps) {
+  int32_t hi = 0, lo = 0;
+  for (uint32_t i = 0; i < taps; i++) {
+    int32_t k = c[i];
+    hi += (x[i] >> 17) * k;
+    lo += ((int32_t)((x[i] >> 1) & 0xFFFF) * k) >> 16;
+  }
+  int32_t v = hi + lo;                                        // Q29
+  if (v >  (INT32_MAX >> 2)) return INT32_MAX;
+  if (v < -(INT32_MAX >> 2)) return INT32_MIN;
+  return v * 4;
+}
+
+void resampler_run_q31(resampler_t* s, int32_t* const* out, uint32_t ch, uint32_t n) {
+  const rs_ratio_t* r = s->r;
+  const uint32_t taps = r->taps, L = r->L, M = r->M;
+
+  // 先把这一块每个输出点的相位与窗口起点算出来，各通道共用
+  uint16_t ph[RS_BLOCK], at[RS_BLOCK];
+  uint32_t acc = s->acc, q = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    while (acc >= L) { acc -= L; q++; }
+    ph[i] = (uint16_t)acc;
+    at[i] = (uint16_t)q;
+    acc  += M;
+  }
+  s->acc = acc;
+
+  for (uint32_t c = 0; c < ch; c++) {
+    int32_t* h = s->hist[c];
+    int32_t* d = out[c];
+    for (uint32_t i = 0; i < n; i++) d[i] = rs_dot(h + at[i], r->coef + ph[i] * taps, taps);
+    memmove(h, h + q, taps * sizeof(h[0]));                   // 保留最近 taps 个输入作下一块的历史
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef __RESAMPLER_H__
+#define __RESAMPLER_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "uac2_rates.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== 定点多相 FIR 重采样（有理数比例 L/M）=====
+// 录音只有一个原生采样率，主机却可以在 Clock Source 上选表里任意一个。信号源与打包内核之间插一级重采样：
+// 输出率 : 输入率 = L : M（约分后，如 48k→44.1k = 147/160，48k→96k = 2/1）。
+// 上电时（core1 启动前）按录音采样率为每个声明的采样率生成一张系数表（Kaiser 窗 sinc，Q15，每相和精确为 1），
+// SET_CUR(SAM_FREQ) 时只查表选定；生产者按块运行：先算出这一块要消耗几个输入帧，让信号源直接写进历史缓冲尾部，
+// 再逐输出点做一次 taps 长的点积（M0+ 只有 32x32→32 乘法：样本拆成高/低两段各乘一次，精度约 29 bit）。
+// 表与比例只在上电时写入，之后两核只读。
+
+#ifndef CFG_MIC_RESAMPLE_TAPS
+#define CFG_MIC_RESAMPLE_TAPS   32      // 以较低采样率计的每输出点抽头数（过渡带宽 ∝ 1/TAPS，开销 ∝ TAPS）
+#endif
+#ifndef CFG_MIC_RESAMPLE_POOL
+#define CFG_MIC_RESAMPLE_POOL   12288   // 系数池（int16 个数）；放不下的比例退回按原样播放
+#endif
+
+#define RS_BLOCK        32              // 每次最多输出的帧数（与生产块一致）
+#define RS_DECIM_MAX    6               // 最大抽取比（48k→8k）；更大的比例不生成表
+#define RS_TAPS_MAX     (CFG_MIC_RESAMPLE_TAPS * RS_DECIM_MAX)
+#define RS_IN_MAX       (RS_BLOCK * RS_DECIM_MAX + 1)
+#define RS_RATIOS_MAX   16
+
+typedef struct {
+  uint32_t       in_fs, out_fs;
+  uint16_t       L, M;          // 输出 : 输入
+  uint16_t       taps;          // 每相抽头数
+  const int16_t* coef;          // [L][taps]，Q15，按时间顺序（最旧的输入在前）
+} rs_ratio_t;
+
+typedef struct {
+  const rs_ratio_t* r;          // NULL = 直通
+  uint32_t acc;                 // 相位累加器：≥ L 时先取一个新输入
+  int32_t  hist[CFG_MIC_CHANNELS][RS_TAPS_MAX + RS_IN_MAX];
+} resampler_t;
+
+// 上电时调用一次：为 src_fs → 每个声明的采样率生成系数表，返回生成的比例数
+uint32_t resampler_table_init(uint32_t src_fs);
+// 控制面（SET_CUR 时）：查 src_fs → dst_fs 的比例；同率或没有表时返回 NULL
+const rs_ratio_t* resampler_find(uint32_t src_fs, uint32_t dst_fs);
+// 已生成的比例（主机侧基准遍历用）
+const rs_ratio_t* resampler_ratio(uint32_t i);
+uint32_t resampler_pool_used(void);
+
+// ---- 生产者 ----
+void     resampler_reset(resampler_t* s, const rs_ratio_t* r);
+// 产生 n（≤ RS_BLOCK）个输出帧需要的输入帧数
+static inline uint32_t resampler_need(const resampler_t* s, uint32_t n) {
+  return (s->acc + (n - 1) * s->r->M) / s->r->L;
+}
+// 信号源写入新输入帧的位置（第 c 通道，连续 resampler_need() 个样本）
+static inline int32_t* resampler_in(resampler_t* s, uint32_t c) {
+  return &s->hist[c][s->r->taps];
+}
+// 消耗已写入的输入，生成 n 帧平面 Q31 到 out[0..ch-1]
+void     resampler_run_q31(resampler_t* s, int32_t* const* out, uint32_t ch, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "tusb_config.h"
+#include "tusb.h"
+#include "usb_descriptors.h"
+#include "audio_engine.h"
+#include "telemetry.h"
+
+// 注：telem_isr_begin/end 在 USB 中断里（tud_audio_tx_done_isr），其余在 tud_task() / 主循环里。
+// 主循环侧改写或拷出 s_st 时屏蔽中断，保证读回的是同一时刻的一整份。
+
+#define SYSTICK_MASK   0x00FFFFFFu
+
+_Static_assert(sizeof(telem_stats_t) == 118, "telem_stats_t layout (host/telemetry_plot.py)");
+
+static telem_stats_t s_st;
+static uint32_t      s_min_pkt;          // 名义最短包（字节）
+static uint32_t      s_frame_bytes;
+static uint32_t      s_underrun_base;    // 清零时的环欠载计数
+static uint32_t      s_next_ms;
+
+static void reset_stream(void) {
+  uint32_t alt_sw = s_st.alt_switches, rate_sw = s_st.rate_switches;
+  uint8_t  alt = s_st.alt;
+  uint32_t fs  = s_st.fs;
+  memset(&s_st, 0, sizeof(s_st));
+  s_st.version       = TELEM_VERSION;
+  s_st.alt           = alt;
+  s_st.fs            = fs;
+  s_st.cpu_hz        = SYS_CLK_KHZ * 1000u;
+  s_st.fifo_min      = UINT16_MAX;
+  s_st.cyc_min       = UINT32_MAX;
+  s_st.alt_switches  = alt_sw;
+  s_st.rate_switches = rate_sw;
+  s_underrun_base    = audio_engine_ring(0)->underruns;
+}
+
+void telem_init(void) {
+  // core0 的 SysTick：处理器时钟、自由运行、不开中断
+  systick_hw->csr = 0;
+  systick_hw->rvr = SYSTICK_MASK;
+  systick_hw->cvr = 0;
+  systick_hw->csr = 0x5;   // CLKSOURCE = 处理器时钟 | ENABLE
+  memset(&s_st, 0, sizeof(s_st));
+  reset_stream();
+  s_next_ms = CFG_MIC_TELEM_PERIOD_MS;
+}
+
+void telem_on_set_itf(uint8_t alt, pcm_fmt_t fmt, uint32_t fs) {
+  uint32_t irq = save_and_disable_interrupts();
+  s_st.alt_switches++;
+  s_st.alt = alt;
+  s_st.fs  = fs;
+  s_frame_bytes = (uint32_t)pcm_fmt_table[fmt < PCM_FMT_COUNT ? fmt : PCM_FMT_NONE].bytes * CHANNELS;
+  s_min_pkt     = fs / 1000u * s_frame_bytes;
+  reset_stream();
+  restore_interrupts(irq);
+}
+
+void telem_on_rate(uint32_t fs) {
+  uint32_t irq = save_and_disable_interrupts();
+  s_st.rate_switches++;
+  s_st.fs   = fs;
+  s_min_pkt = fs / 1000u * s_frame_bytes;
+  restore_interrupts(irq);
+}
+
+uint32_t telem_isr_begin(void) {
+  uint32_t t0    = systick_hw->cvr;
+  uint32_t level = tu_fifo_count(tud_audio_get_ep_in_ff());
+  if (level < s_st.fifo_min) s_st.fifo_min = (uint16_t)level;
+  if (level > s_st.fifo_max) s_st.fifo_max = (uint16_t)level;
+  return t0;
+}
+
+void telem_isr_end(uint32_t t0, uint16_t n_bytes_sent) {
+  uint32_t c = (t0 - systick_hw->cvr) & SYSTICK_MASK;      // 向下计数
+  uint32_t b = c < (1u << TELEM_HIST_SHIFT) ? 0 : 31u - (uint32_t)__builtin_clz(c) - (TELEM_HIST_SHIFT - 1);
+  s_st.hist[b < TELEM_HIST_BINS ? b : TELEM_HIST_BINS - 1]++;
+  s_st.isr_count++;
+  if (c < s_st.cyc_min) s_st.cyc_min = c;
+  if (c > s_st.cyc_max) s_st.cyc_max = c;
+  uint32_t lo = s_st.cyc_sum_lo + c;
+  s_st.cyc_sum_hi += lo < c;
+  s_st.cyc_sum_lo  = lo;
+  if (n_bytes_sent == 0)             s_st.pkt_zero++;
+  else if (n_bytes_sent < s_min_pkt) s_st.pkt_short++;
+}
+
+void telem_get(telem_stats_t* out) {
+  uint32_t irq = save_and_disable_interrupts();
+  *out = s_st;
+  restore_interrupts(irq);
+  out->underruns = audio_engine_ring(0)->underruns - s_underrun_base;
+  if (out->isr_count == 0) { out->fifo_min = 0; out->cyc_min = 0; }
+}
+
+void telem_poll(void) {
+#if CFG_MIC_TELEM_PERIOD_MS
+  uint32_t now = time_us_32() / 1000u;
+  if ((int32_t)(now - s_next_ms) < 0) return;
+  s_next_ms = now + CFG_MIC_TELEM_PERIOD_MS;
+  telem_stats_t t;
+  telem_get(&t);
+  // @TM t_ms alt fs n cyc_min cyc_avg cyc_max fifo_min fifo_max short zero underruns alt_sw rate_sw cpu_hz h0..h15
+  uint64_t sum = ((uint64_t)t.cyc_sum_hi << 32) | t.cyc_sum_lo;
+  printf("@TM %lu %u %lu %lu %lu %lu %lu %u %u %lu %lu %lu %lu %lu %lu", (unsigned long)now, t.alt,
+         (unsigned long)t.fs, (unsigned long)t.isr_count, (unsigned long)t.cyc_min,
+         (unsigned long)(t.isr_count ? sum / t.isr_count : 0), (unsigned long)t.cyc_max, t.fifo_min, t.fifo_max,
+         (unsigned long)t.pkt_short, (unsigned long)t.pkt_zero, (unsigned long)t.underruns,
+         (unsigned long)t.alt_switches, (unsigned long)t.rate_switches, (unsigned long)t.cpu_hz);
+  for (uint32_t k = 0; k < TELEM_HIST_BINS; k++) printf(" %lu", (unsigned long)t.hist[k]);
+  printf("\n");
+#endif
+}
@@ -0,0 +1,58 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+#include <stdint.h>
+#include "pcm_pack.h"
+
+// ===== 数据面遥测（常开） =====
+// tud_audio_tx_done_isr 每次进出各读一次 SysTick（24-bit 向下计数，处理器时钟），周期数按 log2 分桶；
+// 同时记 EP IN FIFO 水位的最小/最大值、短包/零长包个数和 core1 环的欠载次数。
+// 这些计数在每次 tud_audio_set_itf_cb 时清零；Alt/采样率切换次数是上电以来的累计值。
+// 多个虚拟麦克风时只跟踪功能 0（其余功能的回调不计入，ISR 周期里也不含它们）。
+// 读出：厂商请求 VENDOR_REQ_TELEMETRY_GET（不打断流），或 CFG_MIC_TELEM_PERIOD_MS 周期性在 UART 输出一行 "@TM"。
+// host/telemetry_plot.py 可以轮询前者或解析后者并作图。
+
+#ifndef CFG_MIC_TELEM_PERIOD_MS
+#define CFG_MIC_TELEM_PERIOD_MS   0       // 0 = 不输出周期摘要
+#endif
+#ifndef SYS_CLK_KHZ
+#define SYS_CLK_KHZ               125000  // 与 pico SDK 默认系统时钟一致
+#endif
+
+#define TELEM_HIST_BINS           16
+#define TELEM_HIST_SHIFT          8       // 桶 0 = [0, 256)，桶 k = [2^(k+7), 2^(k+8))，最后一桶不封顶
+
+typedef struct __attribute__((packed)) {
+  uint8_t  version;                 // TELEM_VERSION
+  uint8_t  alt;                     // 当前 Alt
+  uint16_t fifo_min, fifo_max;      // ISR 入口处 EP IN FIFO 水位（字节）
+  uint32_t cpu_hz;                  // 周期计数的时钟
+  uint32_t fs;                      // 当前采样率
+  uint32_t isr_count;               // 自上次 set_itf 以来的回调次数
+  uint32_t cyc_min, cyc_max;
+  uint32_t cyc_sum_lo, cyc_sum_hi;  // 64-bit 周期总和（按小端拆成两半）
+  uint32_t hist[TELEM_HIST_BINS];   // 每次回调耗时（周期）的 log2 直方图
+  uint32_t pkt_short;               // 实际发出字节数 < 名义最短包（floor(fs/1000) 帧）的非零包
+  uint32_t pkt_zero;                // 零长包
+  uint32_t underruns;               // core1 环欠载次数
+  uint32_t alt_switches;            // 上电以来：SET_INTERFACE 次数
+  uint32_t rate_switches;           // 上电以来：SET_CUR 采样率次数
+} telem_stats_t;
+
+#define TELEM_VERSION             1
+
+void telem_init(void);
+
+// 控制面
+void telem_on_set_itf(uint8_t alt, pcm_fmt_t fmt, uint32_t fs);   // 清零流计数
+void telem_on_rate(uint32_t fs);                                  // 只更新名义包长
+
+// 数据面：tud_audio_tx_done_isr 入口/出口
+uint32_t telem_isr_begin(void);
+void     telem_isr_end(uint32_t t0, uint16_t n_bytes_sent);
+
+void telem_get(telem_stats_t* out);
+
+// 主循环空闲时调用：到期则输出一行 "@TM" 摘要（CFG_MIC_TELEM_PERIOD_MS = 0 时什么都不做）
+void telem_poll(void);
+
+#endif
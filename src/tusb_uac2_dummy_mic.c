@@ -1,212 +1,74 @@
-#include <math.h>
-#include <string.h>
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
 #include "bsp/board.h"
 
 #include "tusb_config.h"
 #include "tusb.h"
 #include "usb_descriptors.h"
+#include "dds.h"
+#include "audio_engine.h"
+#include "uac2_ctrl.h"
+#include "ep_in.h"
+#include "as_switch.h"
+#include "vendor_req.h"
+#include "evlog.h"
+#include "telemetry.h"
+#include "latprobe.h"
+#include "idle.h"
+#include "flash_image.h"
 
 // ===== 本文件职责 =====
-// 1) 处理 UAC2 控制面（GET/SET Entity：采样率、音量/静音、IT Connector）
+// 1) 把 UAC2 控制面（GET/SET Entity）交给 uac2_ctrl.c 的分发表，空闲时发中断端点状态消息
 // 2) 音频数据面：在 tud_audio_tx_done_isr() 中按“每毫秒样本数”写入 EP FIFO
+//    每个虚拟麦克风（CFG_MIC_FUNCS 个 UAC2 功能）的回调按 func_id / 接口号分到各自的状态
 // 3) ★重要：请手动将 TinyUSB 更新到最新版（master 或最新 release）。
 //    本工程依赖其 Audio 类在 SET_INTERFACE/流控上的修复；并确保 lib/tusb/tusb_config.h 中
 //    CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL=1 以支持 44.1kHz 抖包。
 
-// 正弦波发生器状态
-static float phase = 0.0f;
-
-// USB States and Variables
-static uint8_t g_cur_alt = AS_ALT0_STOP;              // 0/1/2  Alt1=16, Alt2=24
-static volatile uint32_t g_sample_rate = 44100;              // 当前采样率（Hz）
-static volatile uint8_t  g_mute_cur = 0;                     // 0/1
-static volatile int16_t  g_vol_min  = (-60) * 256;           // -60 dB
-static volatile int16_t  g_vol_max  = (  0) * 256;           //  0 dB
-static volatile int16_t  g_vol_res  = (  1) * 256;           //  1 dB 步进
-static volatile int16_t  g_vol_cur  = ( -6) * 256;           // -6 dB
-
-// 将线性音量（dB/256）应用到样本上
-static inline float volume_scale(void) {
-  float db = ((float)g_vol_cur) / 256.0f;
-  return powf(10.0f, db / 20.0f);
-}
+// 信号链跑在 core1（audio_engine.c），这里只保留 USB 侧状态
+#ifndef CFG_MIC_DDS_QUALITY
+#define CFG_MIC_DDS_QUALITY   DDS_QUALITY_INTERP
+#endif
 
-// 仅用于打印友好名称（便于调试）
-static const char* entity_name(uint8_t id) {
-  switch (id) {
-    case UAC2_CLK_ID: return "CLK_SRC";
-    case UAC2_IT_ID:  return "IT (Mic)";
-    case UAC2_FU_ID:  return "FU (Mute/Vol)";
-    case UAC2_OT_ID:  return "OT (USB)";
-    default: return "UNKNOWN";
-  }
-}
+// USB States and Variables：每个虚拟麦克风（功能）一份，按 TinyUSB 的 func_id 索引
+static uint8_t g_cur_alt[UAC2_FUNCS];                 // 0..4  Alt1=16, Alt2=24, Alt3=32, Alt4=float32
+// 采样率、音量/静音等控制状态在 uac2_ctrl.c
 
-// UAC Entity Getter and Setter Callback
-bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const * p_request) {
-  uint8_t  entityID = TU_U16_HIGH(p_request->wIndex);
-  uint8_t  ctrlSel  = TU_U16_HIGH(p_request->wValue);
-  uint8_t  channel  = TU_U16_LOW (p_request->wValue);
-  uint8_t  req      = p_request->bRequest;
-
-  printf("[CTL ][GET ] ent=0x%02X(%s) sel=0x%02X ch=%u req=0x%02X wLen=%u\n",
-         entityID, entity_name(entityID), ctrlSel, channel, req, p_request->wLength);
- 
-  // Clock Source（采样率范围 / 当前值 / 有效位）
-  if (entityID == UAC2_CLK_ID) {
-    if (ctrlSel == AUDIO_CS_CTRL_SAM_FREQ) {
-      if (req == AUDIO_CS_REQ_RANGE) {
-        // 构造 RANGE 返回：2 个子区间，分别固定 44100 和 96000
-        struct TU_ATTR_PACKED {
-          uint16_t wNumSubRanges;
-          struct { uint32_t bMin, bMax, bRes; } sub[2];
-        } range;
-
-        range.wNumSubRanges = 2;
-        range.sub[0].bMin = range.sub[0].bMax = 44100; range.sub[0].bRes = 0;
-        range.sub[1].bMin = range.sub[1].bMax = 96000; range.sub[1].bRes = 0;
-
-        return tud_audio_buffer_and_schedule_control_xfer(
-          rhport, p_request, &range, sizeof(uint16_t) + 2 * sizeof(range.sub[0]));
-      }
-      else if (req == AUDIO_CS_REQ_CUR) {
-        uint32_t cur = g_sample_rate;
-        return tud_audio_buffer_and_schedule_control_xfer(
-          rhport, p_request, &cur, sizeof(cur));
-      }
-    }
-    else if (ctrlSel == AUDIO_CS_CTRL_CLK_VALID && req == AUDIO_CS_REQ_CUR) {
-      uint8_t valid = 1; // 我们内部总能生成对应采样率
-      return tud_audio_buffer_and_schedule_control_xfer(
-        rhport, p_request, &valid, sizeof(valid));
-    }
-  }
+// Alt → 线上样本格式：与描述符同由 UAC2_ALT_TABLE 展开
+#define ALT_FMT_(_name, _type, _bytes, _bits, _fmt)  [_name] = _fmt,
+static const uint8_t k_alt_fmt[AS_ALT_COUNT] = {
+  [AS_ALT0_STOP]    = PCM_FMT_NONE,
+  UAC2_ALT_TABLE(ALT_FMT_)
+};
 
-  // Feature Unit（静音 & 音量）
-  if (entityID == UAC2_FU_ID) {
-    if (ctrlSel == AUDIO_FU_CTRL_MUTE && req == AUDIO_CS_REQ_CUR) {
-      return tud_audio_buffer_and_schedule_control_xfer(
-        rhport, p_request, (void*)&g_mute_cur, sizeof(g_mute_cur));
-    }
-    if (ctrlSel == AUDIO_FU_CTRL_VOLUME) {
-      if (req == AUDIO_CS_REQ_RANGE) {
-        // 按 UAC2 通用 RANGE 返回：wNumSubRanges(2) + 1 个 {int16_t min,max,res}(6) = 8 字节
-        struct TU_ATTR_PACKED {
-          uint16_t wNumSubRanges;
-          struct { int16_t bMin, bMax, bRes; } sub[1];
-        } vr;
-        vr.wNumSubRanges   = 1;
-        vr.sub[0].bMin     = g_vol_min;
-        vr.sub[0].bMax     = g_vol_max;
-        vr.sub[0].bRes     = g_vol_res;
-        return tud_audio_buffer_and_schedule_control_xfer(
-          rhport, p_request, &vr, sizeof(vr));
-      } else if (req == AUDIO_CS_REQ_CUR) {
-        return tud_audio_buffer_and_schedule_control_xfer(
-          rhport, p_request, (void*)&g_vol_cur, sizeof(g_vol_cur));
-      }
-    }
-  }
+static inline pcm_fmt_t alt_format(uint8_t alt) {
+  return alt < AS_ALT_COUNT ? (pcm_fmt_t)k_alt_fmt[alt] : PCM_FMT_NONE;
+}
 
-  if (entityID == UAC2_IT_ID && ctrlSel == AUDIO_TE_CTRL_CONNECTOR && req == AUDIO_CS_REQ_CUR) {
-    audio_desc_channel_cluster_t ret;
-    ret.bNrChannels    = 1;
-    ret.bmChannelConfig= (audio_channel_config_t)0;
-    ret.iChannelNames  = 0;
-    return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &ret, sizeof(ret));
-  }
-  
-  // 其他未实现 -> 让驱动 stall
-  return false;
+// UAC Entity Getter and Setter Callback：表驱动分发（uac2_ctrl.c）
+bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const * p_request) {
+  return uac2_ctrl_get(rhport, p_request);
 }
 
-// ========== SET Entity 回调：主机写配置 ==========
 bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const * p_request, uint8_t *pBuff) {
-  (void) rhport;
-  uint8_t entityID = TU_U16_HIGH(p_request->wIndex);
-  uint8_t ctrlSel  = TU_U16_HIGH(p_request->wValue);
-  uint8_t req      = p_request->bRequest;
-
-  printf("[CTL ][SET ] ent=0x%02X(%s) sel=0x%02X req=0x%02X wLen=%u\n",
-         entityID, entity_name(entityID), ctrlSel, req, p_request->wLength);
- 
-  if (entityID == UAC2_CLK_ID && ctrlSel == AUDIO_CS_CTRL_SAM_FREQ && req == AUDIO_CS_REQ_CUR) {
-    // 主机下发新的采样率（4 字节）
-    uint32_t new_fs;
-    memcpy(&new_fs, pBuff, sizeof(new_fs));
-    g_sample_rate = new_fs; // 记录到应用侧
-    printf("New Sample Rate: %d Hz.\n", g_sample_rate);
-    // TinyUSB 已在 DATA 阶段把 sample_rate_tx 写回内部，然后会重新计算包长
-    // （需要 CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL=1）
-    // 这里不需要再改驱动内部状态。
-    return true;
-  }
-
-  if (entityID == UAC2_FU_ID) {
-    if (ctrlSel == AUDIO_FU_CTRL_MUTE && req == AUDIO_CS_REQ_CUR) {
-      g_mute_cur = pBuff[0] ? 1 : 0;
-      printf("Set Mute: %d\n", g_mute_cur);
-      return true;
-    }
-    if (ctrlSel == AUDIO_FU_CTRL_VOLUME && req == AUDIO_CS_REQ_CUR) {
-      int16_t v; memcpy(&v, pBuff, sizeof(v));
-      // 夹到范围
-      if (v < g_vol_min) v = g_vol_min;
-      if (v > g_vol_max) v = g_vol_max;
-      g_vol_cur = v;
-      printf("Set Volume: %d\n", g_vol_cur);
-      return true;
-    }
-  }
-
-  return false; // 其他未实现，stall
+  return uac2_ctrl_set(rhport, p_request, pBuff);
 }
 
 bool tud_audio_tx_done_isr(uint8_t rhport, uint16_t n_bytes_sent,
                            uint8_t func_id, uint8_t ep_in, uint8_t g_cur_alt_setting)
 {
-  (void)rhport; (void)n_bytes_sent; (void)func_id; (void)ep_in;
+  (void)rhport; (void)ep_in;
 
   // Alt0 = 停流
-  if (g_cur_alt_setting == 0) return true;
-
-  g_cur_alt  = g_cur_alt_setting;
-
-  // 每 1ms 需要的样本数：
-  //  44.1kHz → 44 与 45 交替（小数累加满 1000 补 1）
-  static uint16_t frac = 0;   // 0..999
-  static uint32_t last_fs = 0;
-  if (last_fs != g_sample_rate) { frac = 0; last_fs = g_sample_rate; }
-  uint32_t per_ms = g_sample_rate / 1000;
-  frac += (uint16_t)(g_sample_rate % 1000);
-  if (frac >= 1000) { per_ms++; frac -= 1000; }
-
-  float amp = 0.5f * volume_scale();
-  float step = 2.0f * (float)M_PI * 440.0f / (float)g_sample_rate;
-
-  if (g_cur_alt == AS_ALT1_16BIT) {  
-    static int16_t buf16[192]; // 96k/1ms 上限
-    for (uint32_t i=0; i<per_ms; i++) {
-      float s = sinf(phase) * amp;
-      phase += step; if (phase > 2.0f*(float)M_PI) phase -= 2.0f*(float)M_PI;
-      int32_t v = (int32_t)lrintf(s * 32767.0f);
-      buf16[i] = (int16_t)v;
-    }
-    tud_audio_write((uint8_t const*)buf16, per_ms * 2);
-  } else if (g_cur_alt == AS_ALT2_24BIT) {
-    static uint8_t buf24[288]; // 96k*3/1000 = 288
-    for (uint32_t i=0; i<per_ms; i++) {
-      float s = sinf(phase) * amp;
-      phase += step; if (phase > 2.0f*(float)M_PI) phase -= 2.0f*(float)M_PI;
-      int32_t v = (int32_t)lrintf(s * 8388607.0f);
-      // 24-bit little-endian
-      buf24[3*i+0] = (uint8_t)(v & 0xFF);
-      buf24[3*i+1] = (uint8_t)((v >> 8) & 0xFF);
-      buf24[3*i+2] = (uint8_t)((v >> 16) & 0xFF);
-    }
-    tud_audio_write(buf24, per_ms * 3);
-  }
+  if (g_cur_alt_setting == 0 || func_id >= UAC2_FUNCS) return true;
+
+  idle_on_service();                                    // 主循环 WFE 醒来到这里的周期数
+  uint32_t t0 = func_id == 0 ? telem_isr_begin() : 0;   // 遥测只跟踪功能 0（telemetry.h）
+  // EP IN 预填充：按精确有理数调度（44.1kHz → 44/45 交替）补上主机取走的帧，落后时成批补
+  ep_in_service(func_id);
+  __sev();   // 唤醒 core1 补数据（一轮补齐所有欠数据的流）
+  if (func_id == 0) telem_isr_end(t0, n_bytes_sent);
   return true;
 }
 
@@ -217,37 +79,124 @@ bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *p_reques
   // p_request->wIndexL = 接口号，wValueH = 备用设置值
   uint8_t itf = TU_U16_LOW(p_request->wIndex);
   uint8_t alt = TU_U16_LOW(p_request->wValue);
-  if (itf == 1) { // 我们的 AS 接口号
-    g_cur_alt = alt;
+  uint8_t f   = (uint8_t)UAC2_ITF_FUNC(itf);
+  if (f < UAC2_FUNCS && itf == ITF_NUM_AUDIO_STREAMING_N(f)) { // 某个功能的 AS 接口
+    g_cur_alt[f] = alt;
+    as_switch_open(f, alt_format(alt), uac2_ctrl_rate(f));   // 预生成命中时直接用环里的数据预填，否则等 core1 切换
+    if (f == 0) telem_on_set_itf(alt, alt_format(alt), uac2_ctrl_rate(f));   // 遥测计数从这里重新开始
   }
-  printf("[ITF ] set interface=%u alt=%u\n", itf, alt);
-  tud_audio_clear_ep_in_ff();
+  EVLOG2(EV_ITF_SET, itf, alt);
   return true;
 }
 
 bool tud_audio_set_itf_close_ep_cb(uint8_t rhport, tusb_control_request_t const *p_request) {
   (void)rhport;
   uint8_t itf = TU_U16_LOW(p_request->wIndex);
-  printf("[ITF ] close EP on interface=%u (switching alt)\n", itf);
-  // 关键：清空 EP IN 的软件 FIFO，丢弃残留，避免 alt 快速切换导致“EP 已激活”
-  // 需要包含 usb_decsriptors.h 里定义的 EPNUM_AUDIO_IN（0x81）
-  tud_audio_clear_ep_in_ff();
-  // 也可以顺带复位你自己的波形状态（可选）：
-  // phase = 0.0f;
-  // （如果 pre_load 里有静态累加器，也建议提供一个复位函数来清它）
+  uint8_t f   = (uint8_t)UAC2_ITF_FUNC(itf);
+  EVLOG1(EV_ITF_CLOSE, itf);
+  // 关键：停止预填充并清空该功能 EP IN 的软件 FIFO，丢弃残留，避免 alt 快速切换导致“EP 已激活”
+  // 之后 core1 按刚才的格式/采样率预生成，主机重开同一个 Alt 时第一包就有声
+  if (f < UAC2_FUNCS) as_switch_close(f);
   return true;
 }
 
-void tud_mount_cb(void)     { printf("[BUS ] mounted\n"); }
-void tud_umount_cb(void)    { printf("[BUS ] unmounted\n"); }
-void tud_suspend_cb(bool remote_wakeup_en) { printf("[BUS ] suspend rw=%d\n", remote_wakeup_en); }
-void tud_resume_cb(void)    { printf("[BUS ] resume\n"); }
+// 厂商（调试）请求：运行时调整/读取 EP IN 预填充（见 vendor_req.h）
+bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const* request) {
+  if (stage != CONTROL_STAGE_SETUP) return true;
+  uint8_t f = (uint8_t)request->wIndex;         // 预填充请求：wIndex = 功能号
+  switch (request->bRequest) {
+    case VENDOR_REQ_PREFILL_GET: {
+      static ep_in_stats_t st;                  // 数据阶段结束前必须保持有效
+      if (request->bmRequestType_bit.direction != TUSB_DIR_IN || f >= UAC2_FUNCS) return false;
+      ep_in_get_stats(f, &st);
+      return tud_control_xfer(rhport, request, &st, sizeof(st));
+    }
+    case VENDOR_REQ_TELEMETRY_GET: {
+      static telem_stats_t ts;
+      if (request->bmRequestType_bit.direction != TUSB_DIR_IN) return false;
+      telem_get(&ts);
+      return tud_control_xfer(rhport, request, &ts, sizeof(ts));
+    }
+    case VENDOR_REQ_IDLE_GET: {
+      static idle_stats_t is;
+      if (request->bmRequestType_bit.direction != TUSB_DIR_IN) return false;
+      idle_get(&is);
+      return tud_control_xfer(rhport, request, &is, sizeof(is));
+    }
+    case VENDOR_REQ_SOURCE_SET:
+      if (!audio_engine_set_source((audio_src_t)request->wValue)) return false;   // 没有录音镜像 / PDM -> stall
+      uac2_ctrl_refresh();                      // 换到 PDM 后当前采样率可能跑不起来：通知时钟失效
+      return tud_control_status(rhport, request);
+    case VENDOR_REQ_REQUANT_SET:
+      if (!audio_engine_set_requant(request->wValue)) return false;
+      EVLOG2(EV_VEND_REQUANT, 0, request->wValue);
+      return tud_control_status(rhport, request);
+    case VENDOR_REQ_LATPROBE_SET:
+      latprobe_set_period(request->wValue);
+      EVLOG2(EV_VEND_LATPROBE, 0, request->wValue);
+      return tud_control_status(rhport, request);
+    case VENDOR_REQ_PREFILL_SET:
+      if (f >= UAC2_FUNCS) return false;
+      EVLOG2(EV_VEND_PREFILL, f, ep_in_set_target(f, request->wValue));
+      uac2_ctrl_refresh();                      // OT 延迟跟着预填深度变
+      return tud_control_status(rhport, request);
+    default:
+      return false;
+  }
+}
+
+void tud_mount_cb(void)     { EVLOG(EV_BUS_MOUNT); }
+void tud_umount_cb(void)    { EVLOG(EV_BUS_UMOUNT); }
+
+// 总线挂起：所有功能停发、停止生成并丢弃环里的数据，两个核都只剩 WFE（没有 SOF，主循环一直睡到恢复）
+void tud_suspend_cb(bool remote_wakeup_en) {
+  EVLOG2(EV_BUS_SUSPEND, 0, remote_wakeup_en);
+  idle_on_suspend();
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) as_switch_suspend(f);
+}
+
+// 恢复：按挂起前的状态重新预生成；在流的功能立即预填，主机恢复后收到的第一包就有数据
+void tud_resume_cb(void) {
+  EVLOG2(EV_BUS_RESUME, 0, idle_on_resume());
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) as_switch_resume(f);
+}
+
+// core1：信号链生产者。环满或停流时 WFE 休眠，USB ISR 取数后 SEV 唤醒
+static void core1_entry(void) {
+  while (true) {
+    if (!audio_engine_produce()) __wfe();
+  }
+}
 
 int main(void) {
   board_init();
+  evlog_init();
+  dds_table_init();
+  uac2_ctrl_init();
+  audio_engine_init(CFG_MIC_DDS_QUALITY, uac2_ctrl_gain(0, 1));  // 增益从 0 斜坡升到默认音量，上电无爆音
+  uint32_t img_len;
+  const uint8_t* img = flash_image_map(&img_len);
+  audio_engine_attach_image(img, img_len);   // 录音镜像：core1 启动前解析 WAV 头
+  audio_engine_attach_pdm();                 // PDM 麦克风：占用 PIO/DMA，设计抽取滤波器
+  ep_in_init();
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++)   // 猜主机先开 Alt1：core1 一启动就按它预生成
+    as_switch_init(f, alt_format(AS_ALT1_16BIT), uac2_ctrl_rate(f));
+  uac2_ctrl_refresh();
+  telem_init();
+  latprobe_init();
+  idle_init();
+  multicore_launch_core1(core1_entry);
   tusb_init();
   printf("USB Init Complete.\n");
   while (true) {
-    tud_task(); // TinyUSB 轮询
+    tud_task(); // TinyUSB 处理中断排进来的事件
+    if (tud_task_event_ready()) continue;
+    // 空闲时才发状态消息、格式化/输出日志和遥测摘要；日志也出完了才 WFE 睡到下一个 USB 中断或 core1 的 SEV
+    // （中断端点忙着的状态消息等它的完成中断；core1 记日志时会 SEV 叫醒这里）
+    uac2_ctrl_poll();
+    bool more = evlog_drain(EVLOG_DRAIN_MAX) == EVLOG_DRAIN_MAX;
+    telem_poll();
+    latprobe_poll();
+    if (!more) idle_sleep();
   }
 }
@@ -0,0 +1,292 @@
+#include <stddef.h>
+#include <string.h>
+#include "tusb.h"
+#include "usb_descriptors.h"
+#include "gain.h"
+#include "rate_sched.h"
+#include "audio_engine.h"
+#include "ep_in.h"
+#include "as_switch.h"
+#include "telemetry.h"
+#include "evlog.h"
+#include "uac2_ctrl.h"
+
+// FU Volume 的范围（1/256 dB）：上电时据此生成 dB→线性 表，RANGE 响应也在编译期按它编好
+#define VOL_MIN          ((-60) * 256)   // -60 dB
+#define VOL_MAX          ((  0) * 256)   //  0 dB
+#define VOL_RES          ((  1) * 256)   //  1 dB 步进
+#define VOL_MASTER_INIT  (( -6) * 256)   // Master -6 dB，各通道 0 dB
+
+//--------------------------------------------------------------------+
+// 控制状态（只在 core0 读写），每个功能一份。FU 控制按逻辑通道号索引：[0] = Master，[1..CHANNELS] = 各通道
+//--------------------------------------------------------------------+
+typedef struct {
+  uint32_t rate;
+  uint8_t  clk_valid;
+  uint8_t  mute[CHANNELS + 1];
+  int16_t  vol[CHANNELS + 1];
+  uint8_t  agc[CHANNELS + 1];          // 只记住主机的设置：测试音/录音/PDM 都没有 AGC 可开关
+  uint32_t lat_ot;                     // Terminal 延迟（ns）：OT = EP IN 预填深度
+  uint8_t  note_pending;               // 待发的状态消息（每个 note_t 一位）
+} func_ctrl_t;
+
+static func_ctrl_t s_fn[UAC2_FUNCS];
+static const uint32_t k_lat_it = CFG_MIC_RING_TARGET_MS * 1000000u;   // IT = core1 环的预生成深度
+static const uint32_t k_lat_fu = 0;          // 增益斜坡不引入延迟
+
+//--------------------------------------------------------------------+
+// 预编好的响应：RANGE 与通道簇都是常量，GET 时直接返回
+//--------------------------------------------------------------------+
+typedef struct TU_ATTR_PACKED { uint32_t bMin, bMax, bRes; } rate_subrange_t;
+static const struct TU_ATTR_PACKED {
+  uint16_t        wNumSubRanges;
+  rate_subrange_t sub[UAC2_RATE_COUNT];
+} k_rate_range = {
+  UAC2_RATE_COUNT,
+#define RATE_SUBRANGE_(mn, mx, res) { mn, mx, res },
+  { UAC2_RATE_TABLE(RATE_SUBRANGE_) }
+#undef RATE_SUBRANGE_
+};
+_Static_assert(sizeof(k_rate_range) == UAC2_RATE_RANGE_LEN, "RANGE layout");
+
+static const struct TU_ATTR_PACKED {
+  uint16_t wNumSubRanges;
+  int16_t  bMin, bMax, bRes;
+} k_vol_range = { 1, VOL_MIN, VOL_MAX, VOL_RES };
+
+static const audio_desc_channel_cluster_t k_cluster = {
+  .bNrChannels     = CHANNELS,
+  .bmChannelConfig = (audio_channel_config_t)CHANNEL_CONFIG,
+  .iChannelNames   = 0,
+};
+
+//--------------------------------------------------------------------+
+// 增益：dB→线性 只在控制请求到达时查表一次，数据面只做整数乘法
+//--------------------------------------------------------------------+
+int32_t uac2_ctrl_gain(uint8_t func, uint8_t ch) {
+  const func_ctrl_t* c = &s_fn[func];
+  if (c->mute[0] || c->mute[ch]) return 0;
+  int64_t g = (int64_t)gain_lookup_q30(c->vol[0]) * gain_lookup_q30(c->vol[ch]);
+  return (int32_t)(g >> GAIN_Q);
+}
+
+// ch = 0（Master）时刷新全部通道
+static void update_gain(uint8_t func, uint8_t ch) {
+  for (uint8_t c = 1; c <= CHANNELS; c++) {
+    if (ch == 0 || ch == c) audio_engine_set_gain(func, (uint8_t)(c - 1), uac2_ctrl_gain(func, c));
+  }
+}
+
+//--------------------------------------------------------------------+
+// 中断端点状态消息：每个可通知的控制占一位，主循环空闲时逐条发出（各功能有自己的中断端点）
+//--------------------------------------------------------------------+
+typedef enum { NOTE_CLK_VALID = 0, NOTE_OT_LATENCY, NOTE_COUNT } note_t;
+
+static const struct { uint8_t entity, sel; } k_note[NOTE_COUNT] = {
+  [NOTE_CLK_VALID]  = { UAC2_CLK_ID, AUDIO_CS_CTRL_CLK_VALID },
+  [NOTE_OT_LATENCY] = { UAC2_OT_ID,  AUDIO_TE_CTRL_LATENCY },
+};
+
+void uac2_ctrl_refresh(void) {
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) {
+    func_ctrl_t* c = &s_fn[f];
+    uint8_t valid = rate_is_supported(c->rate) && audio_engine_source_runs_at(f, c->rate);
+    if (valid != c->clk_valid) {
+      c->clk_valid = valid;
+      c->note_pending |= 1u << NOTE_CLK_VALID;
+    }
+    ep_in_stats_t st;
+    ep_in_get_stats(f, &st);
+    uint32_t lat = st.target_frames * 1000000u;         // 稳态下 FIFO 里压着 N 帧（N ms）
+    if (lat != c->lat_ot) {
+      c->lat_ot = lat;
+      c->note_pending |= 1u << NOTE_OT_LATENCY;
+    }
+    if (!tud_mounted()) c->note_pending = 0;            // 主机枚举时会重新 GET 全部控制
+  }
+}
+
+void uac2_ctrl_poll(void) {
+  if (!tud_mounted()) return;
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) {
+    func_ctrl_t* c = &s_fn[f];
+    if (!c->note_pending) continue;
+    uint8_t n = (uint8_t)__builtin_ctz(c->note_pending);
+    audio_interrupt_data_t msg = {
+      .bInfo      = 0,                                  // 类特定、发给接口
+      .bAttribute = AUDIO_CS_REQ_CUR,
+      .wValue     = (uint16_t)(k_note[n].sel << 8),     // CN = 0
+      .wIndex     = (uint16_t)((k_note[n].entity << 8) | ITF_NUM_AUDIO_CONTROL_N(f)),
+    };
+    if (!tud_audio_int_n_write(f, &msg)) continue;      // 上一条还没被主机取走
+    c->note_pending &= (uint8_t)~(1u << n);
+    EVLOG3(EV_CTL_NOTIFY, k_note[n].entity, k_note[n].sel, f);
+  }
+}
+
+//--------------------------------------------------------------------+
+// SET CUR 处理：功能、长度与通道号已由分发器按表校验
+//--------------------------------------------------------------------+
+static bool set_rate(uint8_t f, uint8_t ch, const uint8_t* buf) {
+  (void)ch;
+  uint32_t fs;
+  memcpy(&fs, buf, sizeof(fs));
+  if (!rate_is_supported(fs)) {
+    EVLOG2(EV_RATE_REJECT, f, fs);
+    return false;
+  }
+  s_fn[f].rate = fs;
+  as_switch_rate(f, fs);       // 停流时按新采样率预生成（含录音的重采样表、包长调度），流进行中则重新预填
+  if (f == 0) telem_on_rate(fs);
+  EVLOG2(EV_RATE_SET, f, fs);
+  uac2_ctrl_refresh();         // PDM 在部分采样率下跑不起来：时钟有效位跟着变
+  // TinyUSB 已在 DATA 阶段把 sample_rate_tx 写回内部，然后会重新计算包长
+  // （需要 CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL=1），这里不需要再改驱动内部状态
+  return true;
+}
+
+static bool set_mute(uint8_t f, uint8_t ch, const uint8_t* buf) {
+  s_fn[f].mute[ch] = buf[0] ? 1 : 0;
+  update_gain(f, ch);
+  EVLOG2(EV_MUTE, EVLOG_FUNC(f, ch), s_fn[f].mute[ch]);
+  return true;
+}
+
+static bool set_volume(uint8_t f, uint8_t ch, const uint8_t* buf) {
+  int16_t v;
+  memcpy(&v, buf, sizeof(v));
+  if (v < VOL_MIN) v = VOL_MIN;          // 夹到范围
+  if (v > VOL_MAX) v = VOL_MAX;
+  s_fn[f].vol[ch] = v;
+  update_gain(f, ch);
+  EVLOG2(EV_VOLUME, EVLOG_FUNC(f, ch), (int32_t)v);
+  return true;
+}
+
+static bool set_agc(uint8_t f, uint8_t ch, const uint8_t* buf) {
+  s_fn[f].agc[ch] = buf[0] ? 1 : 0;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// 分发表：行 = 实体（ID 高半字节 − 1），列 = 控制选择子；cur == NULL 的格子即“没有这个控制”
+//--------------------------------------------------------------------+
+typedef bool (*ctrl_set_fn)(uint8_t func, uint8_t ch, const uint8_t* buf);
+
+typedef struct {
+  const void*  cur;        // 所有功能共用的常量 CUR；NULL 时 CUR 在该功能 func_ctrl_t 的 off 处
+  const void*  range;      // RANGE 响应（NULL = 不支持 RANGE）
+  ctrl_set_fn  set;        // SET CUR（NULL = 只读）
+  uint8_t      off;        // func_ctrl_t 内偏移；通道 ch 的值再加 ch × stride
+  uint8_t      len;        // CUR 字节数，SET 的 wLength 必须相等；0 = 没有这个控制
+  uint8_t      range_len;
+  uint8_t      stride;     // 0 = 所有通道共用一份
+  uint8_t      ch_max;     // 允许的最大通道号
+} ctrl_entry_t;
+
+#define ENT_SLOT(_id)  (((_id) >> 4) - 1)
+#define ENT_COUNT      4
+#define SEL_COUNT      (AUDIO_FU_CTRL_LATENCY + 1)
+_Static_assert(ENT_SLOT(UAC2_CLK_ID) == 0 && ENT_SLOT(UAC2_FU_ID) == 1 && ENT_SLOT(UAC2_IT_ID) == 2 &&
+               ENT_SLOT(UAC2_OT_ID) == 3 && ((UAC2_CLK_ID | UAC2_FU_ID | UAC2_IT_ID | UAC2_OT_ID) & 0x0F) == 0,
+               "entity IDs must be CLK 0x10, FU 0x20, IT 0x30, OT 0x40 (dispatch rows)");
+_Static_assert(sizeof(func_ctrl_t) <= 0xFF, "per-function control state must be addressable by a uint8_t offset");
+
+#define FN_SIZE(_m)                  sizeof(((func_ctrl_t*)0)->_m)
+// 只读常量、不分功能不分通道
+#define CTRL_R(_cur)                 { .cur = &(_cur), .len = sizeof(_cur) }
+// 只读、每个功能一份
+#define CTRL_FN_R(_m)                { .off = offsetof(func_ctrl_t, _m), .len = FN_SIZE(_m) }
+// 可读写、每个功能一份
+#define CTRL_FN(_m, _set, _range)    { .off = offsetof(func_ctrl_t, _m), .set = (_set), .len = FN_SIZE(_m), \
+                                       .range = &(_range), .range_len = sizeof(_range) }
+// 可读写、每个功能 Master + 每通道各一份
+#define CTRL_CH(_m, _set)            { .off = offsetof(func_ctrl_t, _m), .set = (_set), .len = FN_SIZE(_m[0]), \
+                                       .stride = FN_SIZE(_m[0]), .ch_max = CHANNELS }
+#define CTRL_CH_RANGE(_m, _set, _range) \
+                                     { .off = offsetof(func_ctrl_t, _m), .set = (_set), .len = FN_SIZE(_m[0]), \
+                                       .stride = FN_SIZE(_m[0]), .ch_max = CHANNELS, \
+                                       .range = &(_range), .range_len = sizeof(_range) }
+
+static const ctrl_entry_t k_ctrl[ENT_COUNT][SEL_COUNT] = {
+  [ENT_SLOT(UAC2_CLK_ID)] = {
+    [AUDIO_CS_CTRL_SAM_FREQ]  = CTRL_FN(rate, set_rate, k_rate_range),
+    [AUDIO_CS_CTRL_CLK_VALID] = CTRL_FN_R(clk_valid),
+  },
+  [ENT_SLOT(UAC2_FU_ID)] = {
+    [AUDIO_FU_CTRL_MUTE]      = CTRL_CH(mute, set_mute),
+    [AUDIO_FU_CTRL_VOLUME]    = CTRL_CH_RANGE(vol, set_volume, k_vol_range),
+    [AUDIO_FU_CTRL_AGC]       = CTRL_CH(agc, set_agc),
+    [AUDIO_FU_CTRL_LATENCY]   = CTRL_R(k_lat_fu),
+  },
+  [ENT_SLOT(UAC2_IT_ID)] = {
+    [AUDIO_TE_CTRL_CONNECTOR] = CTRL_R(k_cluster),
+    [AUDIO_TE_CTRL_LATENCY]   = CTRL_R(k_lat_it),
+  },
+  [ENT_SLOT(UAC2_OT_ID)] = {
+    [AUDIO_TE_CTRL_LATENCY]   = CTRL_FN_R(lat_ot),
+  },
+};
+
+// (接口, 实体, 选择子, 通道) → 表项与 CUR 地址；接口不是某个功能的 AC 接口、控制不存在或通道号越界时返回 NULL
+static const ctrl_entry_t* lookup(tusb_control_request_t const* req, uint8_t* func, uint8_t* ch, const uint8_t** cur) {
+  uint8_t itf  = TU_U16_LOW(req->wIndex);
+  uint8_t ent  = TU_U16_HIGH(req->wIndex);
+  uint8_t sel  = TU_U16_HIGH(req->wValue);
+  uint8_t slot = (uint8_t)ENT_SLOT(ent);
+  *func = (uint8_t)UAC2_ITF_FUNC(itf);
+  *ch   = TU_U16_LOW(req->wValue);
+  if (*func >= UAC2_FUNCS || itf != ITF_NUM_AUDIO_CONTROL_N(*func)) return NULL;
+  if ((ent & 0x0F) || slot >= ENT_COUNT || sel >= SEL_COUNT) return NULL;
+  const ctrl_entry_t* e = &k_ctrl[slot][sel];
+  if (!e->len || *ch > e->ch_max) return NULL;
+  *cur = (e->cur ? (const uint8_t*)e->cur : (const uint8_t*)&s_fn[*func] + e->off) + *ch * e->stride;
+  return e;
+}
+
+static inline uint32_t req_tag(tusb_control_request_t const* req) {
+  return ((uint32_t)TU_U16_HIGH(req->wValue) << 16) | ((uint32_t)TU_U16_LOW(req->wValue) << 8) | req->bRequest;
+}
+
+// 未实现 -> 让驱动 stall
+static bool stall(tusb_control_request_t const* req) {
+  EVLOG3(EV_CTL_STALL, req->wIndex, req_tag(req), req->wLength);
+  return false;
+}
+
+bool uac2_ctrl_get(uint8_t rhport, tusb_control_request_t const* req) {
+  // 日志只记事件，格式化和 UART 输出推迟到主循环（evlog.h）
+  EVLOG3(EV_CTL_GET, req->wIndex, req_tag(req), req->wLength);
+  uint8_t f, ch;
+  const uint8_t* cur;
+  const ctrl_entry_t* e = lookup(req, &f, &ch, &cur);
+  if (!e) return stall(req);
+  if (req->bRequest == AUDIO_CS_REQ_CUR) {
+    return tud_audio_buffer_and_schedule_control_xfer(rhport, req, (void*)cur, e->len);
+  }
+  if (req->bRequest == AUDIO_CS_REQ_RANGE && e->range) {
+    return tud_audio_buffer_and_schedule_control_xfer(rhport, req, (void*)e->range, e->range_len);
+  }
+  return stall(req);
+}
+
+bool uac2_ctrl_set(uint8_t rhport, tusb_control_request_t const* req, const uint8_t* buf) {
+  (void)rhport;
+  EVLOG3(EV_CTL_SET, req->wIndex, req_tag(req), req->wLength);
+  uint8_t f, ch;
+  const uint8_t* cur;
+  const ctrl_entry_t* e = lookup(req, &f, &ch, &cur);
+  if (!e || !e->set || req->bRequest != AUDIO_CS_REQ_CUR || req->wLength != e->len) return stall(req);
+  return e->set(f, ch, buf) || stall(req);
+}
+
+uint32_t uac2_ctrl_rate(uint8_t func) {
+  return s_fn[func].rate;
+}
+
+void uac2_ctrl_init(void) {
+  gain_table_init(VOL_MIN, VOL_MAX, VOL_RES);
+  for (uint8_t f = 0; f < UAC2_FUNCS; f++) {
+    s_fn[f] = (func_ctrl_t){ .rate = UAC2_RATE_DEFAULT, .clk_valid = 1, .vol = { VOL_MASTER_INIT } };
+  }
+}
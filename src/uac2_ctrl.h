@@ -0,0 +1,38 @@
+#ifndef __UAC2_CTRL_H__
+#define __UAC2_CTRL_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "tusb.h"
+
+// ===== UAC2 控制面：表驱动的实体请求分发 =====
+// GET/SET Entity 按 (实体, 控制选择子) 直接索引一张常量表（实体 ID 的高半字节即行号），
+// 表项给出 CUR 的存放位置/长度/按通道步进、预先编好的 RANGE 响应和 SET 处理函数：
+// * GET CUR/RANGE 只做一次查表 + 指针运算，不再逐层 if 判断、不在回调里拼 RANGE 结构；
+// * SET 先按表校验通道号和长度，再调处理函数（NULL = 只读，stall）；
+// * 表里没有的请求一律 stall 并记 EV_CTL_STALL。
+// 覆盖 Windows/macOS/Linux 枚举时会探测的控制：
+//   CLK  SAM_FREQ (CUR/RANGE/SET)、CLK_VALID (CUR)
+//   FU   MUTE / VOLUME (CUR/RANGE/SET) / AGC，Master + 每通道；LATENCY
+//   IT   CONNECTOR（通道簇）、LATENCY；OT LATENCY
+// 不是主机引起的状态变化（换信号源导致时钟失效、预填深度改变延迟）经 AC 中断端点发状态消息，
+// 主机收到后自己重新 GET。
+// 每个虚拟麦克风（功能）有自己的一份控制状态，实体 ID 各功能相同：请求按 wIndex 低字节的 AC 接口号
+// 找到功能，状态消息从该功能自己的中断端点发出。全部在 core0 的 tud_task 上下文里调用。
+
+void     uac2_ctrl_init(void);
+
+// 功能 func 的当前采样率（Hz）
+uint32_t uac2_ctrl_rate(uint8_t func);
+// 功能 func 通道 ch（1..CHANNELS）的有效增益 Q30 = Master × 通道，任一静音即 0
+int32_t  uac2_ctrl_gain(uint8_t func, uint8_t ch);
+
+// tud_audio_get_req_entity_cb / tud_audio_set_req_entity_cb 的全部实现
+bool     uac2_ctrl_get(uint8_t rhport, tusb_control_request_t const* req);
+bool     uac2_ctrl_set(uint8_t rhport, tusb_control_request_t const* req, const uint8_t* buf);
+
+// 信号源或 EP IN 预填深度变了：重新计算各功能的 Clock Validity / Terminal 延迟，有变化则排队状态消息
+void     uac2_ctrl_refresh(void);
+// 主循环空闲时调用：把排队的状态消息写进中断端点（端点忙则下次再试）
+void     uac2_ctrl_poll(void);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __VENDOR_REQ_H__
+#define __VENDOR_REQ_H__
+
+// ===== 厂商（调试）控制请求 =====
+// bmRequestType = Vendor | Device，TinyUSB 转给 tud_vendor_control_xfer_cb()，不占用 UAC2 实体。
+// 主机侧可用 libusb_control_transfer(0xC0/0x40, bRequest, wValue, wIndex, ...) 访问；uac2_sim 也走同一路径。
+// 预填充请求的 wIndex = 功能号（虚拟麦克风 0..CFG_MIC_FUNCS-1）；遥测、信号源和延迟探针只作用于功能 0，空闲统计与重新量化模式是整个设备的。
+
+enum {
+  VENDOR_REQ_PREFILL_GET = 0x01,   // IN：ep_in_stats_t（预填充帧数、附加延迟、最低 FIFO 水位…）
+  VENDOR_REQ_PREFILL_SET = 0x02,   // OUT，无数据：wValue = 预填充帧数
+  VENDOR_REQ_TELEMETRY_GET = 0x03, // IN：telem_stats_t（ISR 周期直方图、FIFO 水位、短包/零包、切换次数）
+  VENDOR_REQ_SOURCE_SET  = 0x04,   // OUT，无数据：wValue = audio_src_t（0 = 测试音，1 = flash 录音，2 = PDM 麦克风）
+  VENDOR_REQ_LATPROBE_SET = 0x05,  // OUT，无数据：wValue = 延迟探针标记间隔 ms（0 = 关闭，见 latprobe.h）
+  VENDOR_REQ_IDLE_GET    = 0x06,   // IN：idle_stats_t（core0 WFE 时间占比、进入 WFE→服务的周期数、挂起次数；读出后清零窗口）
+  VENDOR_REQ_REQUANT_SET = 0x07,   // OUT，无数据：wValue = requant_mode_t（16-bit Alt 的截断 / TPDF / TPDF + 一阶、二阶整形）
+};
+
+#endif